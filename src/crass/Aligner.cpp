@@ -33,6 +33,8 @@
  */
 #include <cstdlib>
 #include <iostream>
+#include <algorithm>
+#include <emmintrin.h>
 #include "Exception.h"
 #include "Aligner.h"
 #include "LoggerSimp.h"
@@ -126,10 +128,13 @@ void Aligner::alignSlave(StringToken& slaveDRToken) {
     if (flags[reversed] ) {
         // we need to reverse all the reads and the DR for these reads
         try {
+            ReadHolder read;
             ReadListIterator read_iter = mReads->at(slaveDRToken)->begin();
             while (read_iter != mReads->at(slaveDRToken)->end()) 
             {
-                (*read_iter)->reverseComplementSeq();
+                mReadStore->get(*read_iter, read);
+                read.reverseComplementSeq();
+                mReadStore->update(*read_iter, read);
                 read_iter++;
             }
         } catch(crispr::exception& e) {
@@ -159,36 +164,43 @@ void Aligner::generateConsensus() {
     logInfo("DR zone: " << AL_ZoneStart << " -> " << AL_ZoneEnd, 1);
 #endif
 
-	// chars we luv!
-    char alphabet[4] = {'A', 'C', 'G', 'T'};
-
-	
-	// populate the conservation array
+    //-----
+    // one pass over the window, four positions at a time. The bases are
+    // looked at in ACGT order and only a bigger count takes over, so a 
+    // tie goes to the first base and nothing covered stays an N
+    //
+    static const char bases[5] = {'A', 'C', 'G', 'T', 'N'};
+    AL_consensus.assign(AL_windowLength, 'N');
+    AL_conservation.assign(AL_windowLength, 0.0f);
+    AL_depth.assign(AL_windowLength, 0);
     int num_GT_zero = 0;
-    for(int j = 0; j < AL_length; j++)
+    const __m128i min_depth = _mm_set1_epi32(CRASS_DEF_MIN_READ_DEPTH);
+    for(int j = 0; j < AL_windowLength; j += 4)
 	{
-		int max_count = 0;
-		float total_count = 0.0;
+        __m128i max_count = _mm_setzero_si128();
+        __m128i max_base = _mm_set1_epi32(4);
+        __m128i total_count = _mm_setzero_si128();
 		for(int i = 0; i < 4; i++)
 		{
-			
-			total_count += static_cast<float>(AL_coverage[coverageIndex(j,alphabet[i])]);
-			if(AL_coverage[coverageIndex(j,alphabet[i])] > max_count)
-			{
-				max_count = AL_coverage[coverageIndex(j,alphabet[i])];
-				AL_consensus[j] = alphabet[i];
-			}
+            // counts are never more than AL_MAX_COVERAGE so a signed compare will do
+            __m128i count = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&AL_coverage[i * AL_windowLength + j]));
+            total_count = _mm_add_epi32(total_count, count);
+            __m128i bigger = _mm_cmpgt_epi32(count, max_count);
+            max_count = _mm_or_si128(_mm_and_si128(bigger, count), _mm_andnot_si128(bigger, max_count));
+            max_base = _mm_or_si128(_mm_and_si128(bigger, _mm_set1_epi32(i)), _mm_andnot_si128(bigger, max_base));
 		}
 		// we need at least CRASS_DEF_MIN_READ_DEPTH reads to call a DR
-		if(total_count > CRASS_DEF_MIN_READ_DEPTH)
-		{
-			AL_conservation[j] = static_cast<float>(max_count)/total_count;
-			num_GT_zero++;
-		}
-		else
-		{
-			AL_conservation[j] = 0;
-		}
+        __m128 deep_enough = _mm_castsi128_ps(_mm_cmpgt_epi32(total_count, min_depth));
+        __m128 conservation = _mm_div_ps(_mm_cvtepi32_ps(max_count), _mm_cvtepi32_ps(total_count));
+        _mm_storeu_ps(&AL_conservation[j], _mm_and_ps(deep_enough, conservation));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(&AL_depth[j]), total_count);
+        num_GT_zero += __builtin_popcount(_mm_movemask_ps(deep_enough));
+        int max_bases[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(max_bases), max_base);
+        for(int k = 0; k < 4; k++)
+        {
+            AL_consensus[j + k] = bases[max_bases[k]];
+        }
 	}
     
     // trim these back a bit (if we trim too much we'll get it back right now anywho)
@@ -198,18 +210,18 @@ void Aligner::generateConsensus() {
         logWarn("**WARNING: low confidence DR", 1);
     } else {
         // first work from the left and trim back
-	    while(AL_ZoneStart > 0)
+	    while(AL_ZoneStart > 0 && AL_ZoneStart < AL_length)
 	    {
-		    if(AL_conservation[AL_ZoneStart - 1] < CRASS_DEF_ZONE_EXT_CONS_CUT_OFF) 
+		    if(conservationAt(AL_ZoneStart - 1) < CRASS_DEF_ZONE_EXT_CONS_CUT_OFF) 
                 AL_ZoneStart++;
             else 
 			    break;
 	    }
         
 	    // next work from the right
-	    while(AL_ZoneEnd < AL_length - 1)
+	    while(AL_ZoneEnd < AL_length - 1 && AL_ZoneEnd >= 0)
 	    {
-		    if(AL_conservation[AL_ZoneEnd + 1] < CRASS_DEF_ZONE_EXT_CONS_CUT_OFF)
+		    if(conservationAt(AL_ZoneEnd + 1) < CRASS_DEF_ZONE_EXT_CONS_CUT_OFF)
 			    AL_ZoneEnd--;
 		    else
 			    break;
@@ -218,7 +230,7 @@ void Aligner::generateConsensus() {
 	//same as the loops above but this time extend outward
 	while(AL_ZoneStart > 0)
 	{
-		if(AL_conservation[AL_ZoneStart - 1] >= CRASS_DEF_ZONE_EXT_CONS_CUT_OFF) 
+		if(conservationAt(AL_ZoneStart - 1) >= CRASS_DEF_ZONE_EXT_CONS_CUT_OFF) 
             AL_ZoneStart--;
         else 
 			break;    
@@ -227,7 +239,7 @@ void Aligner::generateConsensus() {
 	// next work to the right
 	while(AL_ZoneEnd < AL_length - 1)
 	{
-		if(AL_conservation[AL_ZoneEnd + 1] >= CRASS_DEF_ZONE_EXT_CONS_CUT_OFF)
+		if(conservationAt(AL_ZoneEnd + 1) >= CRASS_DEF_ZONE_EXT_CONS_CUT_OFF)
 			AL_ZoneEnd++;
 		else
 			break;
@@ -265,47 +277,15 @@ int Aligner::getOffsetAgainstMaster(std::string& slaveDR, AlignerFlag_t& flags)
     logInfo("getting offset of this slave against master DR", 6)
 #endif
     int slave_dr_length = static_cast<int>(slaveDR.length());
-    uint8_t* slave_dr_forward = new uint8_t[slave_dr_length+1];
-    uint8_t* slave_dr_reverse = new uint8_t[slave_dr_length+1];
+    AL_slaveForward.resize(slave_dr_length+1);
+    AL_slaveReverse.resize(slave_dr_length+1);
     
-    prepareSlaveForAlignment(slaveDR, slave_dr_forward, slave_dr_reverse);
+    prepareSlaveForAlignment(slaveDR, &AL_slaveForward[0], &AL_slaveReverse[0]);
 
-    // query profile 
-    kswq_t *slave_forward_query_profile = 0;
-    kswq_t *slave_reverse_query_profile = 0;
-    
-    
-    
     // alignment of slave against master
-    kswr_t forward_return = ksw_align(slave_dr_length, 
-                                      slave_dr_forward, 
-                                      AL_masterDRLength, 
-                                      AL_masterDR, 
-                                      5, 
-                                      AL_scoringMatrix, 
-                                      AL_gapOpening, 
-                                      AL_gapExtension, 
-                                      AL_xtra, 
-                                      &slave_forward_query_profile);
-    
+    kswr_t forward_return = alignAgainstMaster(slave_dr_length, &AL_slaveForward[0]);
+    kswr_t reverse_return = alignAgainstMaster(slave_dr_length, &AL_slaveReverse[0]);
     
-    kswr_t reverse_return = ksw_align(slave_dr_length, 
-                                      slave_dr_reverse, 
-                                      AL_masterDRLength, 
-                                      AL_masterDR, 
-                                      5, 
-                                      AL_scoringMatrix, 
-                                      AL_gapOpening, 
-                                      AL_gapExtension, 
-                                      AL_xtra, 
-                                      &slave_reverse_query_profile);
-    
-    
-    // free the query profile
-    free(slave_forward_query_profile); 
-    free(slave_reverse_query_profile);
-    delete [] slave_dr_reverse;
-    delete [] slave_dr_forward;
     // figure out which alignment was better
     if (reverse_return.score == forward_return.score) {
         flags[score_equal] = true;
@@ -361,89 +341,164 @@ int Aligner::getOffsetAgainstMaster(std::string& slaveDR, AlignerFlag_t& flags)
 
 }
 
+kswr_t Aligner::alignAgainstMaster(int slaveLength, uint8_t * slave) {
+    //-----
+    // the same steps as ksw_align. The local alignment score is the same
+    // either way round, only the master's profiles are kept
+    //
+    kswr_t (*func)(kswq_t*, int, const uint8_t*, int, int, int) = (AL_xtra & KSW_XBYTE) ? ksw_u8 : ksw_i16;
+    kswr_t r = func(AL_masterProfile, slaveLength, slave, AL_gapOpening, AL_gapExtension, AL_xtra);
+    if ((AL_xtra & KSW_XSTART) && ! ((AL_xtra & KSW_XSUBO) && r.score < (AL_xtra & 0xffff))) {
+        // align the reversed ends to find the start
+        std::reverse(slave, slave + r.te + 1);
+        kswr_t rr = func(reversedMasterProfile(r.qe + 1), slaveLength, slave, AL_gapOpening, AL_gapExtension, KSW_XSTOP | r.score);
+        std::reverse(slave, slave + r.te + 1);
+        if (r.score == rr.score) {
+            r.tb = r.te - rr.te;
+            r.qb = r.qe - rr.qe;
+        }
+    }
+    std::swap(r.qb, r.tb);
+    std::swap(r.qe, r.te);
+    return r;
+}
+
+kswq_t * Aligner::reversedMasterProfile(int length) {
+    std::map<int, kswq_t *>::iterator profile_iter = AL_reversedMasterProfiles.find(length);
+    if (profile_iter != AL_reversedMasterProfiles.end()) {
+        return profile_iter->second;
+    }
+    std::vector<uint8_t> reversed_master(AL_masterDR, AL_masterDR + length);
+    std::reverse(reversed_master.begin(), reversed_master.end());
+    kswq_t * profile = ksw_qinit((AL_xtra & KSW_XBYTE) ? 1 : 2, length, &reversed_master[0], 5, AL_scoringMatrix);
+    AL_reversedMasterProfiles[length] = profile;
+    return profile;
+}
+
+void Aligner::clearMasterProfiles(void) {
+    free(AL_masterProfile);
+    AL_masterProfile = NULL;
+    std::map<int, kswq_t *>::iterator profile_iter;
+    for (profile_iter = AL_reversedMasterProfiles.begin(); profile_iter != AL_reversedMasterProfiles.end(); ++profile_iter) {
+        free(profile_iter->second);
+    }
+    AL_reversedMasterProfiles.clear();
+}
+
 void Aligner::placeReadsInCoverageArray(StringToken& currentDrToken) {
 
-    ReadListIterator read_iter = mReads->at(currentDrToken)->begin();
+    ReadHolder read;
+    ReadList * reads = mReads->at(currentDrToken);
     int current_dr_length = static_cast<int>(mStringCheck->getString(currentDrToken).length());
     
-    while (read_iter != mReads->at(currentDrToken)->end()) 
+    for (ReadListIterator read_iter = reads->begin(); read_iter != reads->end(); ++read_iter) 
     {
+        mReadStore->get(*read_iter, read);
+        // every copy of the read counts
+        unsigned int copies = mReadStore->multiplicity(*read_iter);
+        const StartStopList& start_stops = read.getStartStopList();
+        const std::string& seq = read.getSeq();
+        int seq_length = static_cast<int>(seq.length());
+
         // don't care about partials
-        int dr_start_index = 0;
-        int dr_end_index = 1;
-        while(((*read_iter)->startStopsAt(dr_end_index) - (*read_iter)->startStopsAt(dr_start_index)) != (current_dr_length - 1))
+        size_t dr_start_index = 0;
+        while(dr_start_index + 1 < start_stops.size() && 
+              static_cast<int>(start_stops[dr_start_index + 1] - start_stops[dr_start_index]) != (current_dr_length - 1))
         {
             dr_start_index += 2;
-            dr_end_index += 2;
         } 
         // go through every full length DR in the read and place in the array
-        do
+        for (; dr_start_index + 1 < start_stops.size() && 
+               static_cast<int>(start_stops[dr_start_index + 1] - start_stops[dr_start_index]) == (current_dr_length - 1); 
+             dr_start_index += 2)
         {
-            if(((*read_iter)->startStopsAt(dr_end_index) - (*read_iter)->startStopsAt(dr_start_index)) == (current_dr_length - 1))
+            // we need to find the first kmer which matches the mode.
+            int this_read_start_pos = AL_Offsets[currentDrToken] - static_cast<int>(start_stops[dr_start_index]);
+            if(this_read_start_pos + seq_length > AL_length)
             {
-                // we need to find the first kmer which matches the mode.
-                int this_read_start_pos = AL_Offsets[currentDrToken] - (*read_iter)->startStopsAt(dr_start_index);
-                for(int i = 0; i < (int)(*read_iter)->getSeqLength(); i++)
-                {
-                    char current_nt = (*read_iter)->getSeqCharAt(i);
-                    int index_b = i+this_read_start_pos; 
-
-                    if((index_b) >= AL_length)
-                    {
-                        logError("***FATAL*** MEMORY CORRUPTION: The consensus/coverage arrays are too short");
-                    }
-                    if((index_b) < 0)
-                    {
-                        logError("***FATAL*** MEMORY CORRUPTION: index = "<< index_b<<" less than array begining");
-                    }
-                    if(coverageIndex(index_b,current_nt) >= (int)AL_coverage.size()) {
-                        logError("***FATAL*** MEMORY CORRUPTION: index = "<<coverageIndex(index_b,current_nt)<<"("<<CHAR_TO_INDEX[(int)current_nt]<<" : "<<AL_length<<" : "<<index_b<<") >= "<<AL_coverage.size());
-                    }
-                    AL_coverage[coverageIndex(index_b,current_nt)]++;
-                }
+                logError("***FATAL*** MEMORY CORRUPTION: The consensus/coverage arrays are too short");
             }
-            // go onto the next DR
-            dr_start_index += 2;
-            dr_end_index += 2;
-            
-            // check that this makes sense
-            if(dr_start_index >= (int)((*read_iter)->numRepeats()*2)) {
-                break;
+            if(this_read_start_pos < 0)
+            {
+                logError("***FATAL*** MEMORY CORRUPTION: index = "<< this_read_start_pos<<" less than array begining");
             }
-            
-        } while(((*read_iter)->startStopsAt(dr_end_index) - (*read_iter)->startStopsAt(dr_start_index)) == (current_dr_length - 1));
-        read_iter++;
+            if (seq_length == 0) 
+            {
+                continue;
+            }
+            growWindow(this_read_start_pos, this_read_start_pos + seq_length - 1);
+            uint32_t * planes = &AL_coverage[this_read_start_pos - AL_windowStart];
+            for(int i = 0; i < seq_length; i++)
+            {
+                uint32_t& count = planes[(CHAR_TO_INDEX[(int)seq[i]] - 1) * AL_windowLength + i];
+                count = (count > AL_MAX_COVERAGE - copies) ? AL_MAX_COVERAGE : count + copies;
+            }
+        }
     }
 }
 
+void Aligner::growWindow(int first, int last) {
+    int window_end = AL_windowStart + AL_windowLength;
+    if (AL_windowLength > 0 && first >= AL_windowStart && last < window_end) {
+        return;
+    }
+    int new_start = first;
+    int new_end = last + 1;
+    if (AL_windowLength > 0) {
+        new_start = std::min(first, AL_windowStart);
+        new_end = std::max(last + 1, window_end);
+    }
+    // reads are placed all around the master so leave room for more
+    int spare = std::max(new_end - new_start, 64) / 2;
+    if (AL_windowLength == 0 || first < AL_windowStart) {
+        new_start = std::max(new_start - spare, 0);
+    }
+    if (AL_windowLength == 0 || last >= window_end) {
+        new_end = std::min(new_end + spare, AL_length);
+    }
+    // the end can go past AL_length, nothing is ever placed there
+    int new_length = (new_end - new_start + 3) & ~3;
+    std::vector<uint32_t> coverage(4 * static_cast<size_t>(new_length), 0);
+    for (int plane = 0; plane < 4 && AL_windowLength > 0; plane++) {
+        std::copy(AL_coverage.begin() + plane * AL_windowLength, 
+                  AL_coverage.begin() + (plane + 1) * AL_windowLength, 
+                  coverage.begin() + plane * new_length + (AL_windowStart - new_start));
+    }
+    AL_coverage.swap(coverage);
+    AL_windowStart = new_start;
+    AL_windowLength = new_length;
+}
+
 
 void Aligner::extendSlaveDR(StringToken& token, size_t slaveDRLength, std::string &extendedSlaveDR){
  
     //StringToken token = mStringCheck->getToken(slaveDR);
     
     // go into the reads and get the sequence of the DR plus a few bases on either side
+    ReadHolder read;
     ReadListIterator read_iter = mReads->at(token)->begin();
     while (read_iter != mReads->at(token)->end()) 
     {
+        mReadStore->get(*read_iter, read);
         // don't care about partials
         int dr_start_index = 0;
         int dr_end_index = 1;
         
         // Find the DR which is the right DR length.
         // compensates for partial repeats
-        while(((*read_iter)->startStopsAt(dr_end_index) - (*read_iter)->startStopsAt(dr_start_index)) != ((int)(slaveDRLength) - 1))
+        while((read.startStopsAt(dr_end_index) - read.startStopsAt(dr_start_index)) != ((int)(slaveDRLength) - 1))
         {
             dr_start_index += 2;
             dr_end_index += 2;
         }
         // check that the DR does not lie too close to the end of the read so that we can extend
-        if((*read_iter)->startStopsAt(dr_start_index) - 2 < 0 || (*read_iter)->startStopsAt(dr_end_index) + 2 > (*read_iter)->getSeqLength()) {
+        if(read.startStopsAt(dr_start_index) - 2 < 0 || read.startStopsAt(dr_end_index) + 2 > read.getSeqLength()) {
             // go to the next read
             read_iter++;
             continue;
         } else {
             // substring the read to get the new length
-            extendedSlaveDR = (*read_iter)->getSeq().substr((*read_iter)->startStopsAt(dr_start_index) - 2, slaveDRLength + 4);
+            extendedSlaveDR = read.getSeq().substr(read.startStopsAt(dr_start_index) - 2, slaveDRLength + 4);
             break;
         }
     }
@@ -452,16 +507,18 @@ void Aligner::extendSlaveDR(StringToken& token, size_t slaveDRLength, std::strin
 
 
 void Aligner::calculateDRZone() {
+    ReadHolder read;
     ReadListIterator read_iter = mReads->at(AL_masterDRToken)->begin();
     while (read_iter != mReads->at(AL_masterDRToken)->end()) 
     {
+        mReadStore->get(*read_iter, read);
         // don't care about partials
         int dr_start_index = 0;
         int dr_end_index = 1;
         
         // Find the DR which is the master DR length.
         // compensates for partial repeats
-        while(((*read_iter)->startStopsAt(dr_end_index) - (*read_iter)->startStopsAt(dr_start_index)) != (AL_masterDRLength - 1))
+        while((read.startStopsAt(dr_end_index) - read.startStopsAt(dr_start_index)) != (AL_masterDRLength - 1))
         {
             dr_start_index += 2;
             dr_end_index += 2;
@@ -469,29 +526,25 @@ void Aligner::calculateDRZone() {
         
         //  This if is to catch some weird-ass scenario, if you get a report that everything is wrong, then you've most likely
         // corrupted memory somewhere!
-        if(((*read_iter)->startStopsAt(dr_end_index) - (*read_iter)->startStopsAt(dr_start_index)) == (AL_masterDRLength - 1))
+        if((read.startStopsAt(dr_end_index) - read.startStopsAt(dr_start_index)) == (AL_masterDRLength - 1))
         {
             // the start of the read is the position of the master DR - the position of the DR in the read
-            int this_read_start_pos = AL_Offsets.at(AL_masterDRToken) - (*read_iter)->startStopsAt(dr_start_index);
-            AL_ZoneStart =  this_read_start_pos + (*read_iter)->startStopsAt(dr_start_index);
-            AL_ZoneEnd =  this_read_start_pos + (*read_iter)->startStopsAt(dr_end_index);
+            int this_read_start_pos = AL_Offsets.at(AL_masterDRToken) - read.startStopsAt(dr_start_index);
+            AL_ZoneStart =  this_read_start_pos + read.startStopsAt(dr_start_index);
+            AL_ZoneEnd =  this_read_start_pos + read.startStopsAt(dr_end_index);
             break;
         }
     }
 }
 
 void Aligner::print(std::ostream& out) {
-    std::vector<int>::iterator iter;
-    for (int j = 1; j <= 4;++j) {
-        for (int i = 0; i < AL_length; ++i) {
-            out<<AL_coverage[i*j]<<",";
+    // only the window, which starts at AL_windowStart
+    for (int j = 0; j < 4;++j) {
+        for (int i = 0; i < AL_windowLength; ++i) {
+            out<<AL_coverage[j * AL_windowLength + i]<<",";
         }
         out<<"$"<<std::endl;
     }
-
-    //for(iter = AL_coverage.begin(); iter != AL_coverage.end();iter++) {
-    //    std::cout<<*iter<<",";
-    //}
     out<<std::endl;
 }
 
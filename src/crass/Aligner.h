@@ -45,7 +45,11 @@
 #include "crassDefines.h"
 
 
-#define coverageIndex(i,c) (((CHAR_TO_INDEX[(int)c] - 1) * AL_length) + i)
+// index of a base at a position in the window of the coverage array
+#define coverageIndex(i,c) (((CHAR_TO_INDEX[(int)c] - 1) * AL_windowLength) + (i) - AL_windowStart)
+
+// counts stop here so that the depth of a position still fits in an int
+#define AL_MAX_COVERAGE (0x1FFFFFFFU)
 
 typedef std::bitset<3> AlignerFlag_t;
 
@@ -102,18 +106,20 @@ class Aligner
     };*/
 public:
     //int gapo = 5, gape = 2, minsc = 0, xtra = KSW_XSTART;
-    Aligner(int length, ReadMap *wh_reads, StringCheck *wh_st, int gapo=5, int gape=2, int minsc=5, int xtra=KSW_XSTART): 
+    Aligner(int length, ReadMap *wh_reads, ReadStore *wh_store, StringCheck *wh_st, int gapo=5, int gape=2, int minsc=5, int xtra=KSW_XSTART): 
         AL_length(length),
-        AL_consensus(length,'N'), 
-        AL_conservation(length, 0.0f), 
-        AL_coverage(length*4, 0),
+        AL_windowStart(0),
+        AL_windowLength(0),
         AL_gapOpening(gapo), 
         AL_gapExtension(gape), 
         AL_minAlignmentScore(minsc), 
-        AL_xtra(xtra) {
+        AL_xtra(xtra),
+        AL_masterDR(NULL),
+        AL_masterProfile(NULL) {
         
             // assign workhorse variables
             mReads = wh_reads;
+            mReadStore = wh_store;
             mStringCheck = wh_st;
         
         // set up default parameters for ksw alignment
@@ -136,6 +142,7 @@ public:
             delete [] AL_masterDR;
             AL_masterDR = NULL;
         } 
+        clearMasterProfiles();
     }
     
     inline StringToken getMasterDrToken(){return AL_masterDRToken;}
@@ -165,13 +172,14 @@ public:
     
     inline void setDRZoneEnd(int i){AL_ZoneEnd = i;}
     
-    inline int coverageAt(int i, char c){return AL_coverage.at(coverageIndex(i,c)); }
+    // nothing outside of the window has been covered
+    inline int coverageAt(int i, char c){return inWindow(i) ? static_cast<int>(AL_coverage[coverageIndex(i,c)]) : 0; }
     
-    inline char consensusAt(int i){return AL_consensus.at(i);}
+    inline char consensusAt(int i){return (inWindow(i) && ! AL_consensus.empty()) ? AL_consensus[i - AL_windowStart] : 'N';}
     
-    inline float conservationAt(int i){return AL_conservation.at(i);}
+    inline float conservationAt(int i){return (inWindow(i) && ! AL_conservation.empty()) ? AL_conservation[i - AL_windowStart] : 0.0f;}
     
-    inline int depthAt(int i){return AL_coverage[coverageIndex(i,'A')] + AL_coverage[coverageIndex(i,'C')] + AL_coverage[coverageIndex(i,'G')] + AL_coverage[coverageIndex(i,'T')];}
+    inline int depthAt(int i){return (inWindow(i) && ! AL_depth.empty()) ? AL_depth[i - AL_windowStart] : 0;}
 
 private:
     // private methods
@@ -193,12 +201,35 @@ private:
     inline void prepareMasterForAlignment(std::string& masterDR) {
         AL_masterDRLength = masterDR.length();
         //AL_minAlignmentScore = static_cast<int>(AL_masterDRLength * 0.5);
+        if (AL_masterDR != NULL) {
+            delete [] AL_masterDR;
+        }
         AL_masterDR = new uint8_t[AL_masterDRLength+1];
         prepareSequenceForAlignment(masterDR, AL_masterDR);
+        clearMasterProfiles();
+        AL_masterProfile = ksw_qinit((AL_xtra & KSW_XBYTE) ? 1 : 2, AL_masterDRLength, AL_masterDR, 5, AL_scoringMatrix);
     };
+
+    // ksw_align of a slave against the master, but with the master as
+    // the query so that its profiles can be used for every slave. The
+    // result is turned round so it reads as if the slave was the query
+    kswr_t alignAgainstMaster(int slaveLength, uint8_t * slave);
+
+    // the profile of the first length bases of the master reversed, which
+    // ksw uses to find where an alignment starts. Made the first time 
+    // an alignment ends there
+    kswq_t * reversedMasterProfile(int length);
+
+    void clearMasterProfiles(void);
     
 
     void placeReadsInCoverageArray(StringToken& currentDRToken);
+
+    inline bool inWindow(int i){return i >= AL_windowStart && i < AL_windowStart + AL_windowLength;}
+
+    // make sure the window covers first to last, it grows with some room 
+    // to spare on the side it had to grow
+    void growWindow(int first, int last);
     
     void extendSlaveDR(StringToken& slaveDRToken, size_t slaveDRLength, std::string& extendedSlaveDR);
 
@@ -207,13 +238,20 @@ private:
     void printAlignment(const kswr_t& alignment, const std::string& slave, std::ostream& out);
     //Members
     
-    // length of the arrays
+    // length of the arrays. Only the window of it that reads have been
+    // placed in is kept, the coverage of each base one after the other.
+    // The window is a multiple of 4 long so it can be worked on 4 
+    // positions at a time
     int AL_length;
+    int AL_windowStart;
+    int AL_windowLength;
     
-    // Vectors to hold the alignment data
+    // Vectors to hold the alignment data, the consensus, conservation and
+    // depth are made for the window by generateConsensus
     std::vector<char> AL_consensus;
     std::vector<float> AL_conservation;
-    std::vector<int> AL_coverage;
+    std::vector<int> AL_depth;
+    std::vector<uint32_t> AL_coverage;
     
     // Storage of all the offsets against the master
     std::map<StringToken, int> AL_Offsets;
@@ -229,9 +267,16 @@ private:
     uint8_t *AL_masterDR;
     int AL_masterDRLength;
     StringToken AL_masterDRToken;
+    kswq_t * AL_masterProfile;
+    std::map<int, kswq_t *> AL_reversedMasterProfiles;
+
+    // slaves are transformed into these, so aligning does not allocate
+    std::vector<uint8_t> AL_slaveForward;
+    std::vector<uint8_t> AL_slaveReverse;
     
     // "Glue" between WorkHorse
     ReadMap * mReads;
+    ReadStore * mReadStore;
     StringCheck * mStringCheck;
     int AL_ZoneStart;
     int AL_ZoneEnd;
@@ -37,6 +37,7 @@
 // system includes
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 
@@ -54,6 +55,21 @@
 //
 // Edge level functions
 //
+
+// compares an edge against the id being searched for
+struct CrisprEdgeBefore {
+    inline bool operator()(const CrisprEdge& edge, StringToken id) const { return edge.id < id; }
+};
+
+edgeListIterator CrisprNode::findEdge(edgeList * currentList, StringToken id)
+{
+    //-----
+    // binary search for the edge joining us to the node with this id.
+    // If it isn't there we get back where it would need to be inserted
+    //
+    return std::lower_bound(currentList->begin(), currentList->end(), id, CrisprEdgeBefore());
+}
+
 bool CrisprNode::addEdge(CrisprNode * parterNode, EDGE_TYPE type)
 {
     //-----
@@ -64,10 +80,15 @@ bool CrisprNode::addEdge(CrisprNode * parterNode, EDGE_TYPE type)
     edgeList * add_list = getEdges(type);
     
     // now see we haven't added it before
-    if(add_list->find(parterNode) == add_list->end())
+    edgeListIterator add_iter = findEdge(add_list, parterNode->getID());
+    if(add_iter == add_list->end() || add_iter->id != parterNode->getID())
     {
         // new guy
-        (*add_list)[parterNode] = true;
+        CrisprEdge new_edge;
+        new_edge.node = parterNode;
+        new_edge.id = parterNode->getID();
+        new_edge.attached = true;
+        add_list->insert(add_iter, new_edge);
         switch(type)
         {
             case CN_EDGE_FORWARD:
@@ -122,15 +143,15 @@ void CrisprNode::calculateReadCoverage(edgeList * currentList, std::map<StringTo
     for (eli = currentList->begin(); eli != currentList->end(); eli++)
     {
     	// check if he's attached
-    	if(! eli->second)
+    	if(! eli->attached)
     	{
             continue;
         }
 #ifdef DEBUG
-        logInfo("Edge: "<<(eli->first)->getID(), 10);
+        logInfo("Edge: "<<(eli->node)->getID(), 10);
 #endif
         // get the headers
-        std::vector<StringToken> * inner_headers = (eli->first)->getReadHeaders();
+        std::vector<StringToken> * inner_headers = (eli->node)->getReadHeaders();
         std::vector<StringToken>::iterator inner_rh_iter = inner_headers->begin();
         std::vector<StringToken>::iterator inner_rh_last = inner_headers->end();
         while(inner_rh_iter != inner_rh_last)
@@ -209,15 +230,29 @@ void CrisprNode::setEdgeAttachState(edgeList * currentList, bool attachState, ED
     for (eli = currentList->begin(); eli != currentList->end(); eli++) {
 
         // go through each edge, check if it's not the right state
-        if((eli->second ^ attachState) && (eli->first)->isAttached())
+        if((eli->attached ^ attachState) && (eli->node)->isAttached())
         {
             // this edge is not the right state and the corresponding node is actually attached
-            edgeList * other_eli = (eli->first)->getEdges(currentType);
-            (*other_eli)[this] = attachState;
-            eli->second = attachState;
-            (eli->first)->updateRank(attachState, currentType);
-            if((eli->first)->getTotalRank() == 0)
-            	(eli->first)->setAsDetached();
+            edgeList * other_eli = (eli->node)->getEdges(currentType);
+            edgeListIterator other_iter = (eli->node)->findEdge(other_eli, mid);
+            if(other_iter != other_eli->end() && other_iter->id == mid)
+            {
+                other_iter->attached = attachState;
+            }
+            else
+            {
+                // the partner has no edge of this type back to us yet,
+                // it gets one in the new state
+                CrisprEdge back_edge;
+                back_edge.node = this;
+                back_edge.id = mid;
+                back_edge.attached = attachState;
+                other_eli->insert(other_iter, back_edge);
+            }
+            eli->attached = attachState;
+            (eli->node)->updateRank(attachState, currentType);
+            if((eli->node)->getTotalRank() == 0)
+            	(eli->node)->setAsDetached();
         }
     }
 }
@@ -307,13 +342,13 @@ void CrisprNode::printEdgesForList(edgeList * currentList,
     edgeListIterator eli; 
     for (eli = currentList->begin(); eli != currentList->end(); eli++) {
         // check if the edge is active
-        if((eli->second) || showDetached)
+        if((eli->attached) || showDetached)
         {
         	std::stringstream ss;
         	if(longDesc)
-        		ss << (eli->first)->getID() << "_" << ST->getString((eli->first)->getID());
+        		ss << (eli->node)->getID() << "_" << ST->getString((eli->node)->getID());
         	else
-        		ss << (eli->first)->getID();
+        		ss << (eli->node)->getID();
             gvEdge(dataOut,label,ss.str());
         }
     }
@@ -61,10 +61,26 @@ enum EDGE_TYPE {
     CN_EDGE_ERROR
 };
 
-// a list of edges ( we use a map to make lookups faster )
-// The bool teels us if the edge is active (ie, if the joining node is still attached / in use)
-typedef std::map<CrisprNode *, bool> edgeList;
-typedef std::map<CrisprNode *, bool>::iterator edgeListIterator;
+// orders nodes by their id rather than by their address so that walking
+// the edges gives the same result no matter where the nodes were allocated
+struct CrisprNodeOrder {
+    inline bool operator()(CrisprNode * lhs, CrisprNode * rhs) const;
+};
+
+// one edge out of a node. The id of the node at the other end is kept next
+// to the pointer so that a list can be searched without following it and
+// the attached flag tells us if the edge is active (ie, if the joining node
+// is still attached / in use). It all fits in 16 bytes.
+typedef struct {
+    CrisprNode * node;
+    StringToken id;
+    bool attached;
+} CrisprEdge;
+
+// a list of edges, kept in one block sorted by the id of the joining node
+// so that walking it gives the same order no matter where the nodes live
+typedef std::vector<CrisprEdge> edgeList;
+typedef std::vector<CrisprEdge>::iterator edgeListIterator;
 
 class CrisprNode 
 {
@@ -106,7 +122,8 @@ class CrisprNode
         inline int getCoverage() {return mCoverage;}
         int getDiscountedCoverage(void);
         inline void addReadHeader(StringToken readHeader) { mReadHeaders.push_back(readHeader); }
-        inline void addReadHolder(ReadHolder * RH) { mReadHolders.push_back(RH); }
+        inline void addReadHeaders(const std::vector<StringToken>& readHeaders) { mReadHeaders.insert(mReadHeaders.end(), readHeaders.begin(), readHeaders.end()); }
+        inline void addReadHolder(ReadIndex readIndex) { mReadHolders.push_back(readIndex); }
         inline std::vector<StringToken> * getReadHeaders(void) { return &mReadHeaders; }
         inline ReadList * getReadHolders(void) { return &mReadHolders; }
         
@@ -115,6 +132,7 @@ class CrisprNode
         //
         bool addEdge(CrisprNode * parterNode, EDGE_TYPE type);          // return success if the partner has been added
         edgeList * getEdges(EDGE_TYPE type);                            // get edges of a particular type
+        edgeListIterator findEdge(edgeList * currentList, StringToken id); // where the edge to id is, or would go
         
         //
         // Node level functions
@@ -126,6 +144,7 @@ class CrisprNode
         int getRank(EDGE_TYPE type);                                    // return the rank of the node
         void updateRank(bool attachState, EDGE_TYPE type);				// increment or decrement the rank of this type
         inline void incrementCount(void) { mCoverage++; }             // Increment the coverage
+        inline void incrementCount(int count) { mCoverage += count; } // Increment the coverage by copies of a read
         int getTotalRank(void) { return getRank(CN_EDGE_BACKWARD) + getRank(CN_EDGE_FORWARD) + getRank(CN_EDGE_JUMPING_F) + getRank(CN_EDGE_JUMPING_B); }
         int getJumpingRank(void) { return getRank(CN_EDGE_JUMPING_F) + getRank(CN_EDGE_JUMPING_B); }
         int getInnerRank(void) { return getRank(CN_EDGE_BACKWARD) + getRank(CN_EDGE_FORWARD); }
@@ -198,4 +217,10 @@ class CrisprNode
         ReadList mReadHolders;					// waste of the last var,  shut up.
 };
 
+inline bool CrisprNodeOrder::operator()(CrisprNode * lhs, CrisprNode * rhs) const
+{
+    return lhs->getID() < rhs->getID();
+}
+
+
 #endif //CrisprNode_h
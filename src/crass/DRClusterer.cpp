@@ -0,0 +1,427 @@
+// File: DRClusterer.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of DRClusterer functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+// system includes
+#include <algorithm>
+
+// local includes
+#include "DRClusterer.h"
+#include "ThreadPool.h"
+
+// every stage is split into this many parts for each thread so that
+// a slow part doesn't leave the other threads waiting
+#define DC_PARTS_PER_THREAD (4)
+
+// a DR walks at most this many of the DRs after it that hold one of its
+// kmers. A kmer held by more DRs than this, like the kmers of a repeat
+// with many thousands of variants, only has that many of them sampled 
+// evenly and each DR sampled is then checked kmer by kmer. A DR that 
+// is never sampled is not checked, so pairs can be missed
+#define DC_MAX_WALKED_DRS (64)
+
+DRClusterer::DRClusterer(int kmerLength, int minSharedKmers, unsigned int numThreads) :
+    DC_Coder(kmerLength)
+{
+    DC_KmerLength = kmerLength;
+    DC_MinSharedKmers = (minSharedKmers < 1) ? 1 : minSharedKmers;
+    DC_NumThreads = (numThreads < 1) ? 1 : numThreads;
+    DC_DRs = NULL;
+}
+
+DRClusterer::~DRClusterer(void)
+{
+    clear();
+}
+
+void DRClusterer::cluster(const std::vector<std::string>& drs, std::vector<int>& clusterOf)
+{
+    clear();
+    DC_DRs = &drs;
+    size_t num_drs = drs.size();
+    size_t num_parts = DC_NumThreads * DC_PARTS_PER_THREAD;
+
+    // room for every kmer, duplicates within a DR are dropped as they are cut
+    DC_KmerStarts.resize(num_drs);
+    DC_KmerCounts.assign(num_drs, 0);
+    size_t total_kmers = 0;
+    for (size_t i = 0; i < num_drs; i++)
+    {
+        DC_KmerStarts[i] = total_kmers;
+        if (drs[i].length() >= static_cast<size_t>(DC_KmerLength))
+        {
+            total_kmers += drs[i].length() - DC_KmerLength + 1;
+        }
+    }
+    DC_Kmers.resize(total_kmers);
+    DC_Parents.resize(num_drs);
+    for (size_t i = 0; i < num_drs; i++)
+    {
+        DC_Parents[i] = static_cast<int>(i);
+    }
+    for (size_t i = 0; i < num_parts; i++)
+    {
+        Shard * shard = new Shard;
+        shard->lists = new KmerGroupTable(DC_KmerLength);
+        DC_Shards.push_back(shard);
+    }
+
+    DC_Hits.resize(num_parts * num_parts);
+
+    std::vector<Task> tasks(num_parts);
+    for (size_t i = 0; i < num_parts; i++)
+    {
+        tasks[i].clusterer = this;
+        tasks[i].part = i;
+    }
+    {
+        //-----
+        // each stage needs everything from the one before it
+        //
+        ThreadPool pool(DC_NumThreads);
+        for (size_t i = 0; i < num_parts; i++)
+        {
+            pool.submit(DRClusterer::cutTask, &tasks[i]);
+        }
+        pool.waitAll();
+        for (size_t i = 0; i < num_parts; i++)
+        {
+            pool.submit(DRClusterer::indexTask, &tasks[i]);
+        }
+        pool.waitAll();
+        for (size_t i = 0; i < num_parts; i++)
+        {
+            pool.submit(DRClusterer::joinTask, &tasks[i]);
+        }
+        pool.waitAll();
+    }
+
+    clusterOf.resize(num_drs);
+    for (size_t i = 0; i < num_drs; i++)
+    {
+        clusterOf[i] = findRoot(static_cast<int>(i));
+    }
+    DC_DRs = NULL;
+}
+
+size_t DRClusterer::numKmers(void) const
+{
+    size_t num_kmers = 0;
+    std::vector<Shard *>::const_iterator shard_iter;
+    for (shard_iter = DC_Shards.begin(); shard_iter != DC_Shards.end(); ++shard_iter)
+    {
+        num_kmers += ((*shard_iter)->lists)->size();
+    }
+    return num_kmers;
+}
+
+size_t DRClusterer::memoryUsage(void) const
+{
+    size_t bytes = DC_Kmers.capacity() * sizeof(KmerCode) +
+                   (DC_KmerStarts.capacity() + DC_KmerCounts.capacity()) * sizeof(size_t) +
+                   DC_Parents.capacity() * sizeof(int);
+    std::vector<Shard *>::const_iterator shard_iter;
+    for (shard_iter = DC_Shards.begin(); shard_iter != DC_Shards.end(); ++shard_iter)
+    {
+        bytes += ((*shard_iter)->lists)->memoryUsage() +
+                 (*shard_iter)->offsets.capacity() * sizeof(size_t) +
+                 (*shard_iter)->drs.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+
+void DRClusterer::cutTask(void * arg)
+{
+    Task * task = static_cast<Task *>(arg);
+    (task->clusterer)->cutKmers(task->part);
+}
+
+void DRClusterer::indexTask(void * arg)
+{
+    Task * task = static_cast<Task *>(arg);
+    (task->clusterer)->indexKmers(task->part);
+}
+
+void DRClusterer::joinTask(void * arg)
+{
+    Task * task = static_cast<Task *>(arg);
+    (task->clusterer)->joinSharedDRs(task->part);
+}
+
+void DRClusterer::cutKmers(size_t part)
+{
+    //-----
+    // a kmer that turns up twice in a DR is only shared once. This
+    // part cuts a run of DRs and sorts their kmers out by shard
+    //
+    size_t num_shards = DC_Shards.size();
+    size_t first_dr = DC_DRs->size() * part / num_shards;
+    size_t last_dr = DC_DRs->size() * (part + 1) / num_shards;
+    std::vector<KmerHit> * hits = &DC_Hits[part * num_shards];
+    std::vector<KmerCode> kmers;
+    for (size_t dr = first_dr; dr < last_dr; dr++)
+    {
+        DC_Coder.cutKmers((*DC_DRs)[dr], kmers);
+        std::sort(kmers.begin(), kmers.end());
+        kmers.erase(std::unique(kmers.begin(), kmers.end()), kmers.end());
+        std::copy(kmers.begin(), kmers.end(), DC_Kmers.begin() + DC_KmerStarts[dr]);
+        DC_KmerCounts[dr] = kmers.size();
+        std::vector<KmerCode>::iterator kmer_iter;
+        for (kmer_iter = kmers.begin(); kmer_iter != kmers.end(); ++kmer_iter)
+        {
+            hits[*kmer_iter % num_shards].push_back(KmerHit(*kmer_iter, static_cast<int>(dr)));
+        }
+    }
+}
+
+void DRClusterer::indexKmers(size_t part)
+{
+    //-----
+    // this shard holds the kmers whose code leaves part over. Count
+    // how many DRs have each kmer then lay the DRs out one list after
+    // the other. The parts of the DRs are taken in order so every 
+    // list is sorted
+    //
+    Shard * shard = DC_Shards[part];
+    KmerGroupTable * lists = shard->lists;
+    size_t num_shards = DC_Shards.size();
+    std::vector<size_t> list_sizes;
+    for (size_t from = 0; from < num_shards; from++)
+    {
+        std::vector<KmerHit>& hits = DC_Hits[from * num_shards + part];
+        std::vector<KmerHit>::iterator hit_iter;
+        for (hit_iter = hits.begin(); hit_iter != hits.end(); ++hit_iter)
+        {
+            int list = lists->getGroup(hit_iter->first);
+            if (list == 0)
+            {
+                list_sizes.push_back(0);
+                list = static_cast<int>(list_sizes.size());
+                lists->setGroup(hit_iter->first, list);
+            }
+            list_sizes[list - 1]++;
+        }
+    }
+
+    shard->offsets.resize(list_sizes.size() + 1);
+    shard->offsets[0] = 0;
+    for (size_t i = 0; i < list_sizes.size(); i++)
+    {
+        shard->offsets[i + 1] = shard->offsets[i] + list_sizes[i];
+        // now where the next DR goes in each list
+        list_sizes[i] = shard->offsets[i];
+    }
+    shard->drs.resize(shard->offsets.back());
+    for (size_t from = 0; from < num_shards; from++)
+    {
+        std::vector<KmerHit>& hits = DC_Hits[from * num_shards + part];
+        std::vector<KmerHit>::iterator hit_iter;
+        for (hit_iter = hits.begin(); hit_iter != hits.end(); ++hit_iter)
+        {
+            int list = lists->getGroup(hit_iter->first);
+            shard->drs[list_sizes[list - 1]++] = hit_iter->second;
+        }
+        // done with these
+        std::vector<KmerHit>().swap(hits);
+    }
+}
+
+void DRClusterer::joinSharedDRs(size_t part)
+{
+    //-----
+    // count the kmers each DR shares with the DRs after it, each pair
+    // is only looked at from the smaller side. The counts are kept for
+    // every DR and only the ones that were touched get reset. A count
+    // never goes past the kmers really shared, so a pair can be joined
+    // as soon as it gets there
+    //
+    std::vector<int> shared(DC_DRs->size(), 0);
+    std::vector<int> touched;
+    for (size_t dr = part; dr < DC_DRs->size(); dr += DC_Shards.size())
+    {
+        int this_dr = static_cast<int>(dr);
+        int num_sampled_kmers = 0;
+        size_t last = DC_KmerStarts[dr] + DC_KmerCounts[dr];
+        for (size_t i = DC_KmerStarts[dr]; i < last; i++)
+        {
+            const int * first_dr;
+            const int * last_dr;
+            findDRs(DC_Kmers[i], first_dr, last_dr);
+            const int * others = std::upper_bound(first_dr, last_dr, this_dr);
+            size_t num_others = last_dr - others;
+            size_t step = 1;
+            if (num_others > DC_MAX_WALKED_DRS)
+            {
+                step = (num_others + DC_MAX_WALKED_DRS - 1) / DC_MAX_WALKED_DRS;
+                num_sampled_kmers++;
+            }
+            for (size_t j = 0; j < num_others; j += step)
+            {
+                int other = others[j];
+                if (shared[other]++ == 0)
+                {
+                    touched.push_back(other);
+                }
+                if (shared[other] == DC_MinSharedKmers)
+                {
+                    join(this_dr, other);
+                }
+            }
+        }
+        //-----
+        // the sampled kmers could make up the difference for a DR that
+        // was seen, unless it is already in this DR's cluster. A DR 
+        // that shares kmers with this one only through sampled lists 
+        // and was skipped by every sample is never seen here
+        //
+        int this_root = findRoot(this_dr);
+        std::vector<int>::iterator touched_iter;
+        for (touched_iter = touched.begin(); touched_iter != touched.end(); ++touched_iter)
+        {
+            if (num_sampled_kmers > 0 && 
+                shared[*touched_iter] < DC_MinSharedKmers && 
+                shared[*touched_iter] + num_sampled_kmers >= DC_MinSharedKmers && 
+                this_root != findRoot(*touched_iter) && 
+                countSharedKmers(this_dr, *touched_iter) >= DC_MinSharedKmers)
+            {
+                join(this_dr, *touched_iter);
+                this_root = findRoot(this_dr);
+            }
+            shared[*touched_iter] = 0;
+        }
+        touched.clear();
+    }
+}
+
+int DRClusterer::countSharedKmers(int lhs, int rhs) const
+{
+    // the kmers of each DR are sorted and never repeated
+    const KmerCode * lhs_kmer = &DC_Kmers[0] + DC_KmerStarts[lhs];
+    const KmerCode * lhs_last = lhs_kmer + DC_KmerCounts[lhs];
+    const KmerCode * rhs_kmer = &DC_Kmers[0] + DC_KmerStarts[rhs];
+    const KmerCode * rhs_last = rhs_kmer + DC_KmerCounts[rhs];
+    int count = 0;
+    while (lhs_kmer != lhs_last && rhs_kmer != rhs_last)
+    {
+        if (*lhs_kmer < *rhs_kmer)
+        {
+            ++lhs_kmer;
+        }
+        else if (*rhs_kmer < *lhs_kmer)
+        {
+            ++rhs_kmer;
+        }
+        else
+        {
+            count++;
+            ++lhs_kmer;
+            ++rhs_kmer;
+        }
+    }
+    return count;
+}
+
+void DRClusterer::findDRs(KmerCode kmer, const int *& first, const int *& last) const
+{
+    const Shard * shard = DC_Shards[kmer % DC_Shards.size()];
+    // every kmer we ask about was indexed
+    int list = (shard->lists)->getGroup(kmer) - 1;
+    first = &(shard->drs[0]) + shard->offsets[list];
+    last = &(shard->drs[0]) + shard->offsets[list + 1];
+}
+
+int DRClusterer::findRoot(int dr)
+{
+    //-----
+    // path halving. A DR only ever points at a smaller DR so even
+    // with other threads moving things around there are no loops
+    //
+    while (true)
+    {
+        int parent = DC_Parents[dr];
+        if (parent == dr)
+        {
+            return dr;
+        }
+        int grandparent = DC_Parents[parent];
+        if (grandparent != parent)
+        {
+            __sync_bool_compare_and_swap(&DC_Parents[dr], parent, grandparent);
+        }
+        dr = grandparent;
+    }
+}
+
+void DRClusterer::join(int lhs, int rhs)
+{
+    //-----
+    // hang the larger root off the smaller one. If another thread
+    // moved the root first the swap fails and we go again
+    //
+    while (true)
+    {
+        lhs = findRoot(lhs);
+        rhs = findRoot(rhs);
+        if (lhs == rhs)
+        {
+            return;
+        }
+        if (lhs < rhs)
+        {
+            std::swap(lhs, rhs);
+        }
+        if (__sync_bool_compare_and_swap(&DC_Parents[lhs], lhs, rhs))
+        {
+            return;
+        }
+    }
+}
+
+void DRClusterer::clear(void)
+{
+    std::vector<Shard *>::iterator shard_iter;
+    for (shard_iter = DC_Shards.begin(); shard_iter != DC_Shards.end(); ++shard_iter)
+    {
+        delete (*shard_iter)->lists;
+        delete *shard_iter;
+    }
+    DC_Shards.clear();
+    DC_KmerStarts.clear();
+    DC_KmerCounts.clear();
+    DC_Kmers.clear();
+    DC_Hits.clear();
+    DC_Parents.clear();
+}
@@ -0,0 +1,134 @@
+// File: DRClusterer.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Puts DR variants that share enough kmers into the same cluster.
+// The kmers of every DR are indexed, split into shards by kmer code
+// so the shards can be built side by side. Each DR then counts the
+// kmers it shares with the DRs after it, and any pair that reaches
+// the threshold is joined in a union-find. The clusters are whole
+// connected components (single linkage), so a chain of DRs can pull
+// two repeats into one cluster even if their own DRs share little.
+// While no kmer is held by more than 64 DRs every pair that shares
+// enough kmers is joined and the clusters do not depend on the order
+// the DRs are given in. Past that only a sample of the DRs holding a
+// kmer is looked at, see joinSharedDRs, and the clustering can miss 
+// pairs. A pair whose shared kmers are all held by more than 64 DRs,
+// and that no sample picks up, is never compared and stays split 
+// unless other DRs join it. Such pairs are usually variants of the
+// same very common repeat, which are joined through the many others.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef DRClusterer_h
+#define DRClusterer_h
+
+// system includes
+#include <string>
+#include <vector>
+#include <utility>
+
+// local includes
+#include "KmerGroupTable.h"
+
+class DRClusterer
+{
+    public:
+        DRClusterer(int kmerLength, int minSharedKmers, unsigned int numThreads);
+        ~DRClusterer(void);
+
+        // clusterOf[i] is the index of the first DR in the cluster
+        // that drs[i] ends up in
+        void cluster(const std::vector<std::string>& drs, std::vector<int>& clusterOf);
+
+        // number of different kmers in the index
+        size_t numKmers(void) const;
+
+        // bytes held by the index
+        size_t memoryUsage(void) const;
+
+    private:
+        // a slice of the kmer index
+        typedef struct {
+            KmerGroupTable * lists;         // kmer code -> 1 + the number of its list of DRs
+            std::vector<size_t> offsets;    // where each list starts in drs
+            std::vector<int> drs;           // the DRs holding each kmer, in order
+        } Shard;
+
+        // a kmer of a DR, on its way to the index
+        typedef std::pair<KmerCode, int> KmerHit;
+
+        // what a single task works on
+        typedef struct {
+            DRClusterer * clusterer;
+            size_t part;
+        } Task;
+
+        static void cutTask(void * arg);
+        static void indexTask(void * arg);
+        static void joinTask(void * arg);
+
+        void cutKmers(size_t part);
+        void indexKmers(size_t part);
+        void joinSharedDRs(size_t part);
+
+        // how many kmers two DRs have in common
+        int countSharedKmers(int lhs, int rhs) const;
+
+        // the DRs holding a kmer, sorted
+        void findDRs(KmerCode kmer, const int *& first, const int *& last) const;
+
+        // the union-find, safe to run from several threads at once.
+        // The root of a cluster is always its smallest DR
+        int findRoot(int dr);
+        void join(int lhs, int rhs);
+
+        void clear(void);
+
+        DRClusterer(const DRClusterer&);
+        const DRClusterer& operator=(const DRClusterer&);
+
+        // members
+        int DC_KmerLength;
+        int DC_MinSharedKmers;
+        unsigned int DC_NumThreads;
+        KmerGroupTable DC_Coder;                    // only used to cut kmers
+        const std::vector<std::string> * DC_DRs;    // the DRs being clustered
+        std::vector<size_t> DC_KmerStarts;          // where the kmers of each DR start in DC_Kmers
+        std::vector<size_t> DC_KmerCounts;          // how many different kmers each DR has
+        std::vector<KmerCode> DC_Kmers;             // the kmers of every DR, each DR's sorted
+        std::vector<Shard *> DC_Shards;
+        std::vector<std::vector<KmerHit> > DC_Hits;     // from each part of the DRs to each shard, in DR order
+        std::vector<int> DC_Parents;                // the union-find, parent of each DR
+};
+
+#endif //DRClusterer_h
@@ -0,0 +1,188 @@
+// File: HeaderSet.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of HeaderSet functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+// local includes
+#include "HeaderSet.h"
+
+// the table starts off with this many slots and is kept at most half full
+#define HS_MIN_SLOTS (1024)
+
+// no long long constants in C++98
+#define HS_U64(high, low) ((static_cast<uint64_t>(high) << 32) | static_cast<uint64_t>(low))
+
+// FNV-1a with the murmur3 finaliser on the end so that the low bits,
+// which pick the slot, depend on all of the header
+static inline uint64_t fingerprintHeader(const char * header, size_t length)
+{
+    uint64_t hash = HS_U64(0xcbf29ce4U, 0x84222325U);
+    for (size_t i = 0; i < length; i++) 
+    {
+        hash ^= static_cast<unsigned char>(header[i]);
+        hash *= HS_U64(0x00000100U, 0x000001b3U);
+    }
+    hash ^= hash >> 33;
+    hash *= HS_U64(0xff51afd7U, 0xed558ccdU);
+    hash ^= hash >> 33;
+    hash *= HS_U64(0xc4ceb9feU, 0x1a85ec53U);
+    hash ^= hash >> 33;
+    // 0 marks an empty slot
+    return (hash == 0) ? 1 : hash;
+}
+
+// Jenkins one-at-a-time, nothing in common with the fingerprint so 
+// two headers that share a fingerprint won't share this as well
+static inline unsigned int checkHeader(const char * header, size_t length)
+{
+    unsigned int hash = 0;
+    for (size_t i = 0; i < length; i++) 
+    {
+        hash += static_cast<unsigned char>(header[i]);
+        hash += hash << 10;
+        hash ^= hash >> 6;
+    }
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+    return hash;
+}
+
+HeaderSet::HeaderSet(void)
+{
+    HS_Size = 0;
+}
+
+bool HeaderSet::insert(const char * header, size_t length)
+{
+    if (2 * (HS_Size + 1) > HS_Fingerprints.size()) 
+    {
+        growSlots();
+    }
+    uint64_t fingerprint = fingerprintHeader(header, length);
+    unsigned int check = checkHeader(header, length);
+    size_t slot = findSlot(fingerprint, check);
+    if (HS_Fingerprints[slot] != 0) 
+    {
+        return false;
+    }
+    HS_Fingerprints[slot] = fingerprint;
+    HS_Checks[slot] = check;
+    HS_Size++;
+    return true;
+}
+
+bool HeaderSet::contains(const char * header, size_t length) const
+{
+    if (HS_Size == 0) 
+    {
+        return false;
+    }
+    return HS_Fingerprints[findSlot(fingerprintHeader(header, length), checkHeader(header, length))] != 0;
+}
+
+size_t HeaderSet::memoryUsage(void) const
+{
+    return HS_Fingerprints.capacity() * sizeof(uint64_t) + HS_Checks.capacity() * sizeof(unsigned int);
+}
+
+void HeaderSet::clear(void)
+{
+    HS_Fingerprints.clear();
+    HS_Checks.clear();
+    HS_Size = 0;
+}
+
+bool HeaderSet::operator==(const HeaderSet& other) const
+{
+    if (HS_Size != other.HS_Size) 
+    {
+        return false;
+    }
+    for (size_t i = 0; i < HS_Fingerprints.size(); i++) 
+    {
+        if (HS_Fingerprints[i] != 0 && 
+            other.HS_Fingerprints[other.findSlot(HS_Fingerprints[i], HS_Checks[i])] == 0) 
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t HeaderSet::findSlot(uint64_t fingerprint, unsigned int check) const
+{
+    //-----
+    // linear probing, the table is never more than half full. Two headers
+    // with the same fingerprint but a different check both get a slot
+    //
+    size_t mask = HS_Fingerprints.size() - 1;
+    size_t slot = static_cast<size_t>(fingerprint) & mask;
+    while (HS_Fingerprints[slot] != 0) 
+    {
+        if (HS_Fingerprints[slot] == fingerprint && HS_Checks[slot] == check) 
+        {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void HeaderSet::growSlots(void)
+{
+    std::vector<uint64_t> old_fingerprints;
+    std::vector<unsigned int> old_checks;
+    old_fingerprints.swap(HS_Fingerprints);
+    old_checks.swap(HS_Checks);
+    size_t num_slots = (old_fingerprints.empty()) ? HS_MIN_SLOTS : old_fingerprints.size() * 2;
+    HS_Fingerprints.assign(num_slots, 0);
+    HS_Checks.assign(num_slots, 0);
+    size_t mask = num_slots - 1;
+    for (size_t i = 0; i < old_fingerprints.size(); i++) 
+    {
+        if (old_fingerprints[i] == 0) 
+        {
+            continue;
+        }
+        size_t slot = static_cast<size_t>(old_fingerprints[i]) & mask;
+        while (HS_Fingerprints[slot] != 0) 
+        {
+            slot = (slot + 1) & mask;
+        }
+        HS_Fingerprints[slot] = old_fingerprints[i];
+        HS_Checks[slot] = old_checks[i];
+    }
+}
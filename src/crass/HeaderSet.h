@@ -0,0 +1,85 @@
+// File: HeaderSet.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// The set of reads that the search has already found, which the
+// singleton scan checks every read it recruits against. Only a 64 bit
+// fingerprint of each header is kept, along with a second 32 bit hash
+// made a different way that has to match as well before a header is
+// said to be in the set. Headers can be looked up straight out of the
+// parser's buffer so nothing gets allocated on the singleton hot path.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef HeaderSet_h
+#define HeaderSet_h
+
+// system includes
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+class HeaderSet
+{
+    public:
+        HeaderSet(void);
+        ~HeaderSet(void) {}
+
+        // returns false if the header was already in the set
+        bool insert(const char * header, size_t length);
+        inline bool insert(const std::string& header) { return insert(header.data(), header.length()); }
+
+        bool contains(const char * header, size_t length) const;
+        inline bool contains(const std::string& header) const { return contains(header.data(), header.length()); }
+
+        inline size_t size(void) const { return HS_Size; }
+
+        // bytes held by the set
+        size_t memoryUsage(void) const;
+
+        void clear(void);
+
+        // the same headers have been inserted into both
+        bool operator==(const HeaderSet& other) const;
+
+    private:
+        // the slot holding the fingerprint or the empty slot where it would go
+        size_t findSlot(uint64_t fingerprint, unsigned int check) const;
+        void growSlots(void);
+
+        // members
+        std::vector<uint64_t> HS_Fingerprints;      // open addressing, 0 is empty. Always a power of 2 in size
+        std::vector<unsigned int> HS_Checks;        // the second hash for the fingerprint in the same slot
+        size_t HS_Size;                             // number of headers in the set
+};
+
+#endif //HeaderSet_h
@@ -0,0 +1,456 @@
+// File: InputStream.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of InputStream functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+
+// system includes
+#include <string.h>
+
+// local includes
+#include "InputStream.h"
+#include "SeqUtils.h"
+#include "crassDefines.h"
+#include "Exception.h"
+#include "LoggerSimp.h"
+
+// BGZF blocks never inflate to more than this
+#define BGZF_MAX_BLOCK_SIZE (65536)
+
+static inline unsigned int littleEndian16(const unsigned char * bytes)
+{
+    return static_cast<unsigned int>(bytes[0]) | (static_cast<unsigned int>(bytes[1]) << 8);
+}
+
+static inline unsigned long littleEndian32(const unsigned char * bytes)
+{
+    return static_cast<unsigned long>(littleEndian16(bytes)) | (static_cast<unsigned long>(littleEndian16(bytes + 2)) << 16);
+}
+
+InputStream::InputStream(const char * inputFile, unsigned int numThreads)
+{
+    IS_Gz = NULL;
+    IS_Raw = NULL;
+    IS_Inflaters = NULL;
+    IS_Finished = false;
+    IS_Stopping = false;
+    IS_Current = NULL;
+    IS_CurrentOffset = 0;
+    IS_ErrorLogged = false;
+    
+    IS_Bgzf = (strcmp(inputFile, "-") != 0) && isBgzfFile(inputFile);
+    if (IS_Bgzf) 
+    {
+        IS_Raw = fopen(inputFile, "rb");
+        if (IS_Raw == NULL) 
+        {
+            throw crispr::no_file_exception(__FILE__,
+                                            __LINE__,
+                                            __PRETTY_FUNCTION__,
+                                            inputFile);
+        }
+        if (numThreads > 1) 
+        {
+            IS_Inflaters = new ThreadPool(numThreads);
+        }
+    } 
+    else 
+    {
+        IS_Gz = getFileHandle(inputFile);
+#if ZLIB_VERNUM >= 0x1240
+        // zlib only reads 8KB of the file at a time by default
+        gzbuffer(IS_Gz, 128 * 1024);
+#endif
+    }
+    
+    pthread_mutex_init(&IS_Lock, NULL);
+    pthread_cond_init(&IS_ChunkReady, NULL);
+    pthread_cond_init(&IS_ChunkFree, NULL);
+    for (int i = 0; i < CRASS_DEF_INPUT_READ_AHEAD; i++) 
+    {
+        Chunk * chunk = new Chunk;
+        chunk->length = 0;
+        IS_Free.push_back(chunk);
+    }
+    
+    int err = pthread_create(&IS_Producer, NULL, InputStream::producerMain, this);
+    if (err != 0) 
+    {
+        throw crispr::runtime_exception(__FILE__,
+                                        __LINE__,
+                                        __PRETTY_FUNCTION__,
+                                        strerror(err));
+    }
+}
+
+InputStream::~InputStream(void)
+{
+    //-----
+    // the producer might still be going if the parser stopped early
+    //
+    pthread_mutex_lock(&IS_Lock);
+    IS_Stopping = true;
+    pthread_cond_broadcast(&IS_ChunkFree);
+    pthread_mutex_unlock(&IS_Lock);
+    pthread_join(IS_Producer, NULL);
+    
+    delete IS_Inflaters;
+    if (IS_Gz != NULL) 
+    {
+        gzclose(IS_Gz);
+    }
+    if (IS_Raw != NULL) 
+    {
+        fclose(IS_Raw);
+    }
+    
+    delete IS_Current;
+    std::vector<Chunk *>::iterator free_iter;
+    for (free_iter = IS_Free.begin(); free_iter != IS_Free.end(); ++free_iter) 
+    {
+        delete *free_iter;
+    }
+    std::deque<Chunk *>::iterator full_iter;
+    for (full_iter = IS_Full.begin(); full_iter != IS_Full.end(); ++full_iter) 
+    {
+        delete *full_iter;
+    }
+    pthread_cond_destroy(&IS_ChunkFree);
+    pthread_cond_destroy(&IS_ChunkReady);
+    pthread_mutex_destroy(&IS_Lock);
+}
+
+bool InputStream::isBgzfFile(const char * inputFile)
+{
+    //-----
+    // a BGZF block is a gzip member whose extra field starts
+    // with a 'BC' subfield holding the size of the block
+    //
+    FILE * fp = fopen(inputFile, "rb");
+    if (fp == NULL) 
+    {
+        return false;
+    }
+    unsigned char header[18];
+    size_t header_length = fread(header, 1, 18, fp);
+    fclose(fp);
+    return header_length == 18 && 
+           header[0] == 31 && header[1] == 139 && header[2] == 8 && (header[3] & 4) && 
+           littleEndian16(header + 10) >= 6 && 
+           header[12] == 'B' && header[13] == 'C' && littleEndian16(header + 14) == 2;
+}
+
+int InputStream::read(char * buffer, int length)
+{
+    int copied = 0;
+    while (copied < length) 
+    {
+        if (IS_Current == NULL || IS_CurrentOffset >= IS_Current->length) 
+        {
+            pthread_mutex_lock(&IS_Lock);
+            if (IS_Current != NULL) 
+            {
+                IS_Free.push_back(IS_Current);
+                IS_Current = NULL;
+                pthread_cond_signal(&IS_ChunkFree);
+            }
+            while (IS_Full.empty() && ! IS_Finished) 
+            {
+                pthread_cond_wait(&IS_ChunkReady, &IS_Lock);
+            }
+            if (IS_Full.empty()) 
+            {
+                std::string error = IS_Error;
+                pthread_mutex_unlock(&IS_Lock);
+                if (! error.empty() && IS_Bgzf) 
+                {
+                    throw crispr::runtime_exception(__FILE__,
+                                                    __LINE__,
+                                                    __PRETTY_FUNCTION__,
+                                                    error.c_str());
+                }
+                else if (! error.empty() && ! IS_ErrorLogged) 
+                {
+                    // gzread errors were always treated as the end of the 
+                    // file, reading stdin a second time relies on that
+                    logWarn("Stopped reading input early: "<<error, 1);
+                    IS_ErrorLogged = true;
+                }
+                break;
+            }
+            IS_Current = IS_Full.front();
+            IS_Full.pop_front();
+            IS_CurrentOffset = 0;
+            pthread_mutex_unlock(&IS_Lock);
+        }
+        size_t available = IS_Current->length - IS_CurrentOffset;
+        size_t wanted = static_cast<size_t>(length - copied);
+        size_t n = (available < wanted) ? available : wanted;
+        memcpy(buffer + copied, &(IS_Current->data[IS_CurrentOffset]), n);
+        IS_CurrentOffset += n;
+        copied += static_cast<int>(n);
+    }
+    return copied;
+}
+
+int InputStream::readStream(void * stream, char * buffer, int length)
+{
+    return static_cast<InputStream *>(stream)->read(buffer, length);
+}
+
+void * InputStream::producerMain(void * stream)
+{
+    static_cast<InputStream *>(stream)->produce();
+    return NULL;
+}
+
+void InputStream::produce(void)
+{
+    while (true) 
+    {
+        pthread_mutex_lock(&IS_Lock);
+        while (IS_Free.empty() && ! IS_Stopping) 
+        {
+            pthread_cond_wait(&IS_ChunkFree, &IS_Lock);
+        }
+        if (IS_Stopping) 
+        {
+            pthread_mutex_unlock(&IS_Lock);
+            return;
+        }
+        Chunk * chunk = IS_Free.back();
+        IS_Free.pop_back();
+        pthread_mutex_unlock(&IS_Lock);
+        
+        std::string error;
+        int more = (IS_Bgzf) ? fillFromBgzf(chunk, error) : fillFromGz(chunk, error);
+        
+        pthread_mutex_lock(&IS_Lock);
+        if (chunk->length > 0) 
+        {
+            IS_Full.push_back(chunk);
+        } 
+        else 
+        {
+            IS_Free.push_back(chunk);
+        }
+        if (more <= 0) 
+        {
+            IS_Finished = true;
+            IS_Error = error;
+        }
+        pthread_cond_signal(&IS_ChunkReady);
+        pthread_mutex_unlock(&IS_Lock);
+        if (more <= 0) 
+        {
+            return;
+        }
+    }
+}
+
+int InputStream::fillFromGz(Chunk * chunk, std::string& error)
+{
+    chunk->data.resize(CRASS_DEF_INPUT_CHUNK_SIZE);
+    chunk->length = 0;
+    while (chunk->length < CRASS_DEF_INPUT_CHUNK_SIZE) 
+    {
+        int n = gzread(IS_Gz, &(chunk->data[chunk->length]), static_cast<unsigned int>(CRASS_DEF_INPUT_CHUNK_SIZE - chunk->length));
+        if (n < 0) 
+        {
+            int errnum;
+            error = gzerror(IS_Gz, &errnum);
+            return -1;
+        }
+        if (n == 0) 
+        {
+            return 0;
+        }
+        chunk->length += static_cast<size_t>(n);
+    }
+    return 1;
+}
+
+int InputStream::readBgzfBlock(BgzfBlock& block, std::string& error)
+{
+    unsigned char header[12];
+    size_t header_length = fread(header, 1, 12, IS_Raw);
+    if (header_length == 0 && feof(IS_Raw)) 
+    {
+        return 0;
+    }
+    if (header_length < 12 || header[0] != 31 || header[1] != 139 || header[2] != 8 || ! (header[3] & 4)) 
+    {
+        error = "Input is not a complete BGZF file";
+        return -1;
+    }
+    
+    //-----
+    // find the block size in the extra field then 
+    // read the rest of the block in one go
+    //
+    unsigned int extra_length = littleEndian16(header + 10);
+    size_t start = IS_Compressed.size();
+    IS_Compressed.resize(start + extra_length);
+    if (fread(&(IS_Compressed[start]), 1, extra_length, IS_Raw) != extra_length) 
+    {
+        error = "Input is not a complete BGZF file";
+        return -1;
+    }
+    long block_size = -1;
+    for (unsigned int i = 0; i + 4 <= extra_length; ) 
+    {
+        const unsigned char * subfield = &(IS_Compressed[start + i]);
+        unsigned int subfield_length = littleEndian16(subfield + 2);
+        if (subfield[0] == 'B' && subfield[1] == 'C' && subfield_length == 2 && i + 6 <= extra_length) 
+        {
+            block_size = static_cast<long>(littleEndian16(subfield + 4)) + 1;
+            break;
+        }
+        i += 4 + subfield_length;
+    }
+    if (block_size < static_cast<long>(12 + extra_length + 8)) 
+    {
+        error = "Input has a gzip member that is not a BGZF block";
+        return -1;
+    }
+    size_t rest = static_cast<size_t>(block_size) - 12 - extra_length;
+    start = IS_Compressed.size();
+    IS_Compressed.resize(start + rest);
+    if (fread(&(IS_Compressed[start]), 1, rest, IS_Raw) != rest) 
+    {
+        error = "Input is not a complete BGZF file";
+        return -1;
+    }
+    const unsigned char * trailer = &(IS_Compressed[start + rest - 8]);
+    block.compressedOffset = start;
+    block.compressedLength = static_cast<unsigned int>(rest - 8);
+    block.crc = littleEndian32(trailer);
+    block.outLength = static_cast<unsigned int>(littleEndian32(trailer + 4));
+    block.failed = false;
+    if (block.outLength > BGZF_MAX_BLOCK_SIZE) 
+    {
+        error = "Input has a BGZF block that is too big";
+        return -1;
+    }
+    return 1;
+}
+
+int InputStream::fillFromBgzf(Chunk * chunk, std::string& error)
+{
+    //-----
+    // gather up a chunk's worth of blocks, they are all independent 
+    // so each one can be inflated straight into its place in the chunk
+    //
+    IS_Compressed.clear();
+    IS_Blocks.clear();
+    chunk->length = 0;
+    size_t total_length = 0;
+    int more = 1;
+    while (total_length < CRASS_DEF_INPUT_CHUNK_SIZE) 
+    {
+        BgzfBlock block;
+        more = readBgzfBlock(block, error);
+        if (more <= 0) 
+        {
+            break;
+        }
+        block.outOffset = total_length;
+        total_length += block.outLength;
+        IS_Blocks.push_back(block);
+    }
+    if (more < 0) 
+    {
+        return more;
+    }
+    
+    if (chunk->data.size() < total_length) 
+    {
+        chunk->data.resize(total_length);
+    }
+    std::vector<BgzfBlock>::iterator block_iter;
+    for (block_iter = IS_Blocks.begin(); block_iter != IS_Blocks.end(); ++block_iter) 
+    {
+        // the end of file marker is empty
+        if (block_iter->outLength == 0) 
+        {
+            continue;
+        }
+        block_iter->compressed = &(IS_Compressed[block_iter->compressedOffset]);
+        block_iter->out = &(chunk->data[block_iter->outOffset]);
+        if (IS_Inflaters != NULL) 
+        {
+            IS_Inflaters->submit(InputStream::inflateBlock, &(*block_iter));
+        } 
+        else 
+        {
+            inflateBlock(&(*block_iter));
+        }
+    }
+    if (IS_Inflaters != NULL) 
+    {
+        IS_Inflaters->waitAll();
+    }
+    for (block_iter = IS_Blocks.begin(); block_iter != IS_Blocks.end(); ++block_iter) 
+    {
+        if (block_iter->failed) 
+        {
+            error = "Input has a corrupt BGZF block";
+            return -1;
+        }
+    }
+    chunk->length = total_length;
+    return more;
+}
+
+void InputStream::inflateBlock(void * block)
+{
+    BgzfBlock * bgzf_block = static_cast<BgzfBlock *>(block);
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -15) != Z_OK) 
+    {
+        bgzf_block->failed = true;
+        return;
+    }
+    stream.next_in = const_cast<Bytef *>(bgzf_block->compressed);
+    stream.avail_in = bgzf_block->compressedLength;
+    stream.next_out = reinterpret_cast<Bytef *>(bgzf_block->out);
+    stream.avail_out = bgzf_block->outLength;
+    int ret = inflate(&stream, Z_FINISH);
+    bgzf_block->failed = (ret != Z_STREAM_END || 
+                          stream.total_out != bgzf_block->outLength || 
+                          crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<Bytef *>(bgzf_block->out), bgzf_block->outLength) != bgzf_block->crc);
+    inflateEnd(&stream);
+}
@@ -0,0 +1,134 @@
+// File: InputStream.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Reads and decompresses an input file on a separate thread so that
+// kseq can keep parsing while the next chunk is being inflated. BGZF
+// files (bgzip, samtools) are made of small independent gzip blocks
+// so they are inflated in parallel. Anything else goes through gzread
+// which handles plain gzip and uncompressed files alike.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef InputStream_h
+#define InputStream_h
+
+// system includes
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <zlib.h>
+
+// local includes
+#include "ThreadPool.h"
+
+class InputStream
+{
+    public:
+        // "-" reads from stdin, which is never treated as BGZF as it can't be peeked at.
+        // numThreads is the number of threads that inflate BGZF blocks
+        InputStream(const char * inputFile, unsigned int numThreads = 1);
+        ~InputStream(void);
+
+        // behaves like gzread, the buffer is always filled unless the 
+        // end of the file was reached. Throws if a BGZF input is corrupt, 
+        // other read errors are logged and treated as the end of the file
+        int read(char * buffer, int length);
+
+        // for handing to kseq_init_reader
+        static int readStream(void * stream, char * buffer, int length);
+
+        inline bool isBgzf(void) { return IS_Bgzf; }
+
+        // true if the file starts with a BGZF block
+        static bool isBgzfFile(const char * inputFile);
+
+    private:
+        typedef struct {
+            std::vector<char> data;
+            size_t length;
+        } Chunk;
+
+        typedef struct {
+            size_t compressedOffset;            // where the deflate stream is in IS_Compressed
+            unsigned int compressedLength;
+            unsigned long crc;                  // from the block trailer
+            size_t outOffset;                   // where in the chunk this block goes
+            unsigned int outLength;
+            const unsigned char * compressed;   // only set once all of the chunk's blocks are read
+            char * out;
+            bool failed;
+        } BgzfBlock;
+
+        static void * producerMain(void * stream);
+        static void inflateBlock(void * block);
+        void produce(void);
+
+        // fill the chunk with the next bit of the file. Returns 1 if there 
+        // is more to come, 0 at the end of the file and -1 if it can't be read
+        int fillFromGz(Chunk * chunk, std::string& error);
+        int fillFromBgzf(Chunk * chunk, std::string& error);
+
+        // read one whole BGZF block onto the end of IS_Compressed, 
+        // returns like the fill functions
+        int readBgzfBlock(BgzfBlock& block, std::string& error);
+
+        InputStream(const InputStream&);
+        const InputStream& operator=(const InputStream&);
+
+        // members
+        bool IS_Bgzf;
+        gzFile IS_Gz;                           // used when the input is not BGZF
+        FILE * IS_Raw;                          // used when it is
+        ThreadPool * IS_Inflaters;              // only made for BGZF
+        std::vector<unsigned char> IS_Compressed;   // the blocks that make up the next chunk
+        std::vector<BgzfBlock> IS_Blocks;
+        
+        pthread_t IS_Producer;
+        pthread_mutex_t IS_Lock;                // guards everything below
+        pthread_cond_t IS_ChunkReady;           // signalled when a chunk is full or the producer has finished
+        pthread_cond_t IS_ChunkFree;            // signalled when the parser gives a chunk back or we are stopping
+        std::vector<Chunk *> IS_Free;
+        std::deque<Chunk *> IS_Full;
+        bool IS_Finished;                       // the producer has nothing more to give
+        bool IS_Stopping;                       // we are being destroyed before the end of the file
+        std::string IS_Error;                   // set by the producer when the input could not be read
+        
+        // only touched by the parser
+        Chunk * IS_Current;
+        size_t IS_CurrentOffset;
+        bool IS_ErrorLogged;
+};
+
+#endif //InputStream_h
@@ -0,0 +1,237 @@
+// File: KmerGroupTable.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of KmerGroupTable functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+// local includes
+#include "KmerGroupTable.h"
+#include "SeqUtils.h"
+#include "Exception.h"
+
+// 2 bits a base in a KmerCode with room left for the odd kmers
+#define KG_MAX_KMER_LENGTH (15)
+
+// most runs only have a few thousand DR variants so start small
+#define KG_MIN_SLOTS (1024)
+
+// only upper case bases are coded, laurenize() sees 'a' and 'A' as
+// different bases so the codes have to as well
+static inline int groupBaseCode(char base)
+{
+    switch (base)
+    {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default: return -1;
+    }
+}
+
+// the murmur3 32 bit finaliser
+static inline size_t hashKmerCode(KmerCode kmer)
+{
+    kmer ^= kmer >> 16;
+    kmer *= 0x85ebca6bU;
+    kmer ^= kmer >> 13;
+    kmer *= 0xc2b2ae35U;
+    kmer ^= kmer >> 16;
+    return static_cast<size_t>(kmer);
+}
+
+KmerGroupTable::KmerGroupTable(int kmerLength)
+{
+    if (kmerLength < 1 || kmerLength > KG_MAX_KMER_LENGTH)
+    {
+        throw crispr::exception(__FILE__,
+                                __LINE__,
+                                __PRETTY_FUNCTION__,
+                                "kmer length does not fit in a KmerCode");
+    }
+    KG_KmerLength = kmerLength;
+    KG_NumKmers = 0;
+    makeSlots(KG_MIN_SLOTS);
+    pthread_mutex_init(&KG_OddLock, NULL);
+}
+
+KmerGroupTable::~KmerGroupTable(void)
+{
+    pthread_mutex_destroy(&KG_OddLock);
+}
+
+void KmerGroupTable::cutKmers(const std::string& seq, std::vector<KmerCode>& kmers)
+{
+    kmers.clear();
+    size_t length = seq.length();
+    size_t kmer_length = static_cast<size_t>(KG_KmerLength);
+    if (length < kmer_length)
+    {
+        return;
+    }
+    kmers.reserve(length - kmer_length + 1);
+
+    //-----
+    // roll the kmer along both strands at once. A < C < G < T so
+    // the smaller code is the strand laurenize() would have picked
+    //
+    KmerCode mask = (1U << (2 * KG_KmerLength)) - 1;
+    unsigned int top_shift = 2 * (KG_KmerLength - 1);
+    KmerCode forward = 0;
+    KmerCode reverse = 0;
+    size_t valid_bases = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        int base = groupBaseCode(seq[i]);
+        if (base < 0)
+        {
+            valid_bases = 0;
+        }
+        else
+        {
+            forward = ((forward << 2) | base) & mask;
+            reverse = (reverse >> 2) | (static_cast<KmerCode>(3 - base) << top_shift);
+            valid_bases++;
+        }
+        if (i + 1 < kmer_length)
+        {
+            continue;
+        }
+        if (valid_bases >= kmer_length)
+        {
+            kmers.push_back((forward < reverse) ? forward : reverse);
+        }
+        else
+        {
+            kmers.push_back(oddKmerCode(seq, i + 1 - kmer_length));
+        }
+    }
+}
+
+int KmerGroupTable::getGroup(KmerCode kmer) const
+{
+    return KG_Slots[findSlot(kmer)].group;
+}
+
+void KmerGroupTable::setGroup(KmerCode kmer, int group)
+{
+    size_t slot = findSlot(kmer);
+    if (KG_Slots[slot].group == 0)
+    {
+        if (2 * (KG_NumKmers + 1) > KG_Slots.size())
+        {
+            makeSlots(KG_Slots.size() * 2);
+            slot = findSlot(kmer);
+        }
+        KG_NumKmers++;
+    }
+    KG_Slots[slot].kmer = kmer;
+    KG_Slots[slot].group = group;
+}
+
+size_t KmerGroupTable::memoryUsage(void) const
+{
+    // give the odd kmers about 80 bytes of node and string each
+    return KG_Slots.capacity() * sizeof(Slot) + KG_OddKmers.size() * (80 + KG_KmerLength);
+}
+
+void KmerGroupTable::clear(void)
+{
+    KG_NumKmers = 0;
+    KG_OddKmers.clear();
+    KG_Slots.clear();
+    makeSlots(KG_MIN_SLOTS);
+}
+
+KmerCode KmerGroupTable::oddKmerCode(const std::string& seq, size_t start)
+{
+    //-----
+    // these are rare so they can live in a map. Their codes start
+    // after the last 2-bit code so the two can never be mixed up
+    //
+    std::string kmer = laurenize(seq.substr(start, KG_KmerLength));
+    pthread_mutex_lock(&KG_OddLock);
+    KmerCode code;
+    std::map<std::string, KmerCode>::iterator odd_iter = KG_OddKmers.find(kmer);
+    if (odd_iter != KG_OddKmers.end())
+    {
+        code = odd_iter->second;
+    }
+    else
+    {
+        code = (1U << (2 * KG_KmerLength)) + static_cast<KmerCode>(KG_OddKmers.size());
+        KG_OddKmers[kmer] = code;
+    }
+    pthread_mutex_unlock(&KG_OddLock);
+    return code;
+}
+
+size_t KmerGroupTable::findSlot(KmerCode kmer) const
+{
+    //-----
+    // linear probing, the table is never more than half full
+    //
+    size_t mask = KG_Slots.size() - 1;
+    size_t slot = hashKmerCode(kmer) & mask;
+    while (KG_Slots[slot].group != 0 && KG_Slots[slot].kmer != kmer)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void KmerGroupTable::makeSlots(size_t numSlots)
+{
+    std::vector<Slot> old_slots;
+    old_slots.swap(KG_Slots);
+    Slot empty;
+    empty.kmer = 0;
+    empty.group = 0;
+    KG_Slots.assign(numSlots, empty);
+    size_t mask = numSlots - 1;
+    std::vector<Slot>::iterator slot_iter;
+    for (slot_iter = old_slots.begin(); slot_iter != old_slots.end(); ++slot_iter)
+    {
+        if (slot_iter->group == 0)
+        {
+            continue;
+        }
+        size_t slot = hashKmerCode(slot_iter->kmer) & mask;
+        while (KG_Slots[slot].group != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        KG_Slots[slot] = *slot_iter;
+    }
+}
@@ -0,0 +1,102 @@
+// File: KmerGroupTable.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Which DR group each kmer was first seen in while clustering. Kmers
+// are cut from the DR as 2-bit codes, the smaller of the kmer and its
+// reverse complement, so a kmer and its reverse complement share a
+// code. The few kmers with anything other than ACGT in them are given
+// codes past the end of the 2-bit ones. Codes and their groups are
+// kept in an open addressing table. Several threads can cut kmers at
+// once, everything else needs the table to itself.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef KmerGroupTable_h
+#define KmerGroupTable_h
+
+// system includes
+#include <string>
+#include <vector>
+#include <map>
+#include <pthread.h>
+
+typedef unsigned int KmerCode;
+
+class KmerGroupTable
+{
+    public:
+        KmerGroupTable(int kmerLength);
+        ~KmerGroupTable(void);
+
+        // the code of every kmer in seq in the order they are cut,
+        // kmers is emptied first. Safe to call from several threads
+        void cutKmers(const std::string& seq, std::vector<KmerCode>& kmers);
+
+        // the group the kmer belongs to or 0 if it has not got one
+        int getGroup(KmerCode kmer) const;
+
+        void setGroup(KmerCode kmer, int group);
+
+        // number of kmers with a group
+        inline size_t size(void) const { return KG_NumKmers; }
+
+        size_t memoryUsage(void) const;
+
+        void clear(void);
+
+    private:
+        struct Slot
+        {
+            KmerCode kmer;
+            int group;      // 0 is an empty slot
+        };
+
+        // the code for a kmer that is not all ACGT
+        KmerCode oddKmerCode(const std::string& seq, size_t start);
+
+        KmerGroupTable(const KmerGroupTable&);
+        const KmerGroupTable& operator=(const KmerGroupTable&);
+
+        // the slot holding the kmer or the empty slot where it would go
+        size_t findSlot(KmerCode kmer) const;
+        void makeSlots(size_t numSlots);
+
+        // members
+        int KG_KmerLength;
+        std::vector<Slot> KG_Slots;                     // open addressing, always a power of 2 in size
+        size_t KG_NumKmers;                             // slots in use
+        std::map<std::string, KmerCode> KG_OddKmers;    // laurenized kmers that are not all ACGT
+        pthread_mutex_t KG_OddLock;                     // guards KG_OddKmers while cutting
+};
+
+#endif //KmerGroupTable_h
@@ -47,6 +47,7 @@
 #include "LoggerSimp.h"
 
 LoggerSimp* LoggerSimp::mInstance = NULL;
+pthread_mutex_t LoggerSimp::mLock = PTHREAD_MUTEX_INITIALIZER;
 
 LoggerSimp* LoggerSimp::Inst(void) {
     if(mInstance == NULL){
@@ -64,7 +65,16 @@ LoggerSimp* LoggerSimp::Inst(void) {
     return mInstance;
 }
 
-LoggerSimp::LoggerSimp() {}
+LoggerSimp::LoggerSimp() : 
+    mGlobalHandle(NULL),
+    mFileHandle(NULL),
+    mBuff(NULL),
+    mTmpFH(NULL),
+    mLogLevel(0),
+    mStartTime(0),
+    mCurrentTime(0),
+    mFileOpen(false)
+{}
 
 LoggerSimp::~LoggerSimp(){
     if(mFileOpen)
@@ -195,7 +205,7 @@ std::string LoggerSimp::timeToString(bool elapsed)
     //-----
     // get the time in a pretty form. Also can get time elapsed
     //
-    struct tm * timeinfo;
+    struct tm timeinfo;
     char buffer [80];
     
     time ( &mCurrentTime );
@@ -227,8 +237,9 @@ std::string LoggerSimp::timeToString(bool elapsed)
     }
     else
     {
-        timeinfo = localtime ( &mCurrentTime );
-        strftime (buffer,80,"%d/%m/%Y_%I:%M",timeinfo);
+        // localtime shares its result with every other caller
+        localtime_r ( &mCurrentTime, &timeinfo );
+        strftime (buffer,80,"%d/%m/%Y_%I:%M",&timeinfo);
         std::string tmp(buffer);
         return tmp;
     }
@@ -260,6 +271,19 @@ void LoggerSimp::closeLogFile(void)
     }
 }
 
+void LoggerSimp::lock(void)
+{
+    //-----
+    // only one thread gets to write a message at a time
+    //
+    pthread_mutex_lock(&mLock);
+}
+
+void LoggerSimp::unlock(void)
+{
+    pthread_mutex_unlock(&mLock);
+}
+
 void LoggerSimp::clearLogFile(void)
 {
     //-----
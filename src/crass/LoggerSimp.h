@@ -49,6 +49,7 @@
 #include "crassDefines.h"
 #include <config.h>
 #include <sstream>
+#include <pthread.h>
 using namespace std;
 
 // for making the main logger
@@ -85,6 +86,9 @@ public:
     void openLogFile(void);                                         // open the log file
     void clearLogFile(void);                                        // clear the logFile at the start
     
+    void lock(void);                                                // grab the logger before writing to it
+    void unlock(void);                                              // and let it go again
+    
     std::iostream * mGlobalHandle;                                       // what we realy write to
     
 protected:
@@ -93,6 +97,7 @@ protected:
 private:
     
     static LoggerSimp * mInstance;                                  // the internal instance for the singleton
+    static pthread_mutex_t mLock;                                   // stops search threads from mashing their messages together
     
     std::ofstream * mFileHandle;                                         // for writing to files
     std::streambuf *mBuff;                                               // for holding rbuffs
@@ -107,6 +112,15 @@ private:
 
 static LoggerSimp* logger = LoggerSimp::Inst();                     // this makes the singleton available to all classes
                                                                     // which include LoggerSimp.h
+
+// holds the logger lock for as long as it is in scope
+class LoggerLock {
+public:
+    LoggerLock(LoggerSimp * l) : mLogger(l) { mLogger->lock(); }
+    ~LoggerLock() { mLogger->unlock(); }
+private:
+    LoggerSimp * mLogger;
+};
 // get the log level
 #define isLogging(ll) (logger->getLogLevel() >= ll) 
 
@@ -116,33 +130,41 @@ static LoggerSimp* logger = LoggerSimp::Inst();                     // this make
 // for logging info
 #define logInfo(cOUTsTRING, ll) { \
 if(logger->getLogLevel() >= ll) { \
-(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tI   " << cOUTsTRING << std::endl; \
+std::stringstream lOGmESSAGE; lOGmESSAGE << cOUTsTRING; \
+LoggerLock lOGlOCK(logger); \
+(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tI   " << lOGmESSAGE.str() << std::endl; \
 } \
 }
 
 // for dumping large amounts of info to the logfile after a msg
 #define logInfoNoPrefix(cOUTsTRING, ll) {                       \
     if(logger->getLogLevel() >= ll) {                           \
-        (*(logger->mGlobalHandle)) << cOUTsTRING <<std::endl;   \
+        std::stringstream lOGmESSAGE; lOGmESSAGE << cOUTsTRING; \
+        LoggerLock lOGlOCK(logger);                             \
+        (*(logger->mGlobalHandle)) << lOGmESSAGE.str() <<std::endl; \
     }                                                           \
 }
 
 // for errors
 #define logError(cOUTsTRING) { \
-std::stringstream s; s<<cOUTsTRING;\
-(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tERR " << __FILE__ << " : " << __PRETTY_FUNCTION__ << " : " << __LINE__ << ": " <<  cOUTsTRING << std::endl; \
-throw crispr::exception(__FILE__, __LINE__, __PRETTY_FUNCTION__,s.str().c_str());\
+std::stringstream lOGmESSAGE; lOGmESSAGE << cOUTsTRING; \
+{ LoggerLock lOGlOCK(logger); \
+(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tERR " << __FILE__ << " : " << __PRETTY_FUNCTION__ << " : " << __LINE__ << ": " << lOGmESSAGE.str() << std::endl; } \
+throw crispr::exception(__FILE__, __LINE__, __PRETTY_FUNCTION__, lOGmESSAGE.str().c_str());\
 }
 
 // for warnings
 #define logWarn(cOUTsTRING, ll) { \
 if(logger->getLogLevel() >= ll) { \
-(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tW   " << cOUTsTRING << std::endl; \
+std::stringstream lOGmESSAGE; lOGmESSAGE << cOUTsTRING; \
+LoggerLock lOGlOCK(logger); \
+(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tW   " << lOGmESSAGE.str() << std::endl; \
 } \
 }
 
 // time stamp
 #define logTimeStamp() { \
+LoggerLock lOGlOCK(logger); \
 (*(logger->mGlobalHandle)) << "----------------------------------------------------------------------\n----------------------------------------------------------------------\n-- " << logger->timeToString(false) << "  --  " << PACKAGE_FULL_NAME<<" ("<<PACKAGE_NAME<<")" << " --  Version: " << PACKAGE_VERSION << " --\n----------------------------------------------------------------------\n----------------------------------------------------------------------\n" << std::endl; \
 }
 
@@ -154,19 +176,25 @@ if(logger->getLogLevel() >= ll) { \
 // for logging info
 #define logInfo(cOUTsTRING, ll) { \
 if(logger->getLogLevel() >= ll) { \
-(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tI   " << __FILE__ << " : " << __PRETTY_FUNCTION__ << " : " << __LINE__ << ": " <<  cOUTsTRING << std::endl; \
+std::stringstream lOGmESSAGE; lOGmESSAGE << cOUTsTRING; \
+LoggerLock lOGlOCK(logger); \
+(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tI   " << __FILE__ << " : " << __PRETTY_FUNCTION__ << " : " << __LINE__ << ": " << lOGmESSAGE.str() << std::endl; \
 } \
 }
 
 // for errors
 #define logError(cOUTsTRING) { \
-(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tERR " << __FILE__ << " : " << __PRETTY_FUNCTION__ << " : " << __LINE__ << ": " <<  cOUTsTRING << std::endl; \
+std::stringstream lOGmESSAGE; lOGmESSAGE << cOUTsTRING; \
+LoggerLock lOGlOCK(logger); \
+(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tERR " << __FILE__ << " : " << __PRETTY_FUNCTION__ << " : " << __LINE__ << ": " << lOGmESSAGE.str() << std::endl; \
 }
 
 // for warnings
 #define logWarn(cOUTsTRING, ll) { \
 if(logger->getLogLevel() >= ll) { \
-(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tW   " << __FILE__ << " : " << __PRETTY_FUNCTION__ << " : " << __LINE__ << ": " <<  cOUTsTRING << std::endl; \
+std::stringstream lOGmESSAGE; lOGmESSAGE << cOUTsTRING; \
+LoggerLock lOGlOCK(logger); \
+(*(logger->mGlobalHandle)) << logger->timeToString(true) << "\tW   " << __FILE__ << " : " << __PRETTY_FUNCTION__ << " : " << __LINE__ << ": " << lOGmESSAGE.str() << std::endl; \
 } \
 }
 
@@ -69,13 +69,14 @@ SpacerInstance * WalkingManager::shift(SpacerInstance * newNode)
     return old_node;
 }
 
-NodeManager::NodeManager(std::string drSeq, const options * userOpts)
+NodeManager::NodeManager(std::string drSeq, const options * userOpts, ReadStore * readStore)
 {
     //-----
     // constructor
     //
     NM_DirectRepeatSequence = drSeq;
     NM_Opts = userOpts;
+    NM_ReadStore = readStore;
     NM_StringCheck.setName("NM_" + drSeq);
     NM_NextContigID = 0;
     
@@ -91,14 +92,15 @@ NodeManager::~NodeManager(void)
     NodeListIterator node_iter = NM_Nodes.begin();
     while(node_iter != NM_Nodes.end())
     {
-        if(NULL != node_iter->second)
+        if(NULL != *node_iter)
         {
-            delete node_iter->second;
-            node_iter->second = NULL;
+            delete *node_iter;
+            *node_iter = NULL;
         }
         node_iter++;
     }
     NM_Nodes.clear();
+    NM_NodeIndex.clear();
     
     SpacerListIterator spacer_iter = NM_Spacers.begin();
     while(spacer_iter != NM_Spacers.end())
@@ -116,14 +118,16 @@ NodeManager::~NodeManager(void)
     clearContigs();
 }
 
-bool NodeManager::addReadHolder(ReadHolder * RH)
+bool NodeManager::addReadHolder(ReadIndex readIndex)
 {
     //-----
     // add a readholder to this mofo
     //
-    if (splitReadHolder(RH))
+    ReadHolder read;
+    NM_ReadStore->get(readIndex, read);
+    if (splitReadHolder(&read, readIndex))
     {
-        NM_ReadList.push_back(RH);
+        NM_ReadList.push_back(readIndex);
         return true;
     }
     else
@@ -136,7 +140,7 @@ bool NodeManager::addReadHolder(ReadHolder * RH)
 //----
 // private function called from addReadHolder to split the read into spacers and pass it through to others
 //
-bool NodeManager::splitReadHolder(ReadHolder * RH)
+bool NodeManager::splitReadHolder(ReadHolder * RH, ReadIndex readIndex)
 {
     //-----
     // Split down a read holder and make some nodes
@@ -144,14 +148,23 @@ bool NodeManager::splitReadHolder(ReadHolder * RH)
 	std::string working_str;
 	CrisprNode * prev_node = NULL;
 	
-	// add the header of this read to our stringcheck
-
-	StringToken header_st = NM_StringCheck.addString(RH->getHeader());
+	// add the header of this read to our stringcheck, along with the
+	// headers of any copies of it that were folded together when stored
+
+	std::vector<StringToken> header_sts;
+	header_sts.push_back(NM_StringCheck.addString(RH->getHeader()));
+	std::vector<std::string> copy_headers;
+	NM_ReadStore->getDuplicateHeaders(readIndex, copy_headers);
+	std::vector<std::string>::iterator copy_iter;
+	for (copy_iter = copy_headers.begin(); copy_iter != copy_headers.end(); ++copy_iter) 
+	{
+	    header_sts.push_back(NM_StringCheck.addString(*copy_iter));
+	}
 #ifdef SEARCH_SINGLETON
     SearchCheckerList::iterator debug_iter = debugger->find(RH->getHeader());
     if ( debug_iter != debugger->end()) {
         // an interesting read
-        debug_iter->second.nmtoken(header_st);
+        debug_iter->second.nmtoken(header_sts.front());
     }
 #endif
 	//MI std::cout << std::endl << "----------------------------------\n" << RH->getHeader() << std::endl; 
@@ -165,13 +178,13 @@ bool NodeManager::splitReadHolder(ReadHolder * RH)
 			if (RH->startStopsAt(0) == 0) 
 			{
 				//MI std::cout << "both" << std::endl;
-				addCrisprNodes(&prev_node, working_str, header_st, RH);
+				addCrisprNodes(&prev_node, working_str, header_sts, readIndex);
 			} 
 			else 
 			{
 				//MI std::cout << "sec" << std::endl;
 				// we only want to add the second kmer, since it is anchored by the direct repeat
-				addSecondCrisprNode(&prev_node, working_str, header_st, RH);
+				addSecondCrisprNode(&prev_node, working_str, header_sts, readIndex);
 			}
 			
 			// get all the spacers in the middle
@@ -183,7 +196,7 @@ bool NodeManager::splitReadHolder(ReadHolder * RH)
 				while (RH->getNextSpacer(&working_str)) 
 				{		
 					//MI std::cout << "SP: " << working_str << std::endl;
-					addCrisprNodes(&prev_node, working_str, header_st, RH);
+					addCrisprNodes(&prev_node, working_str, header_sts, readIndex);
 				}
 			} 
 			else 
@@ -196,7 +209,7 @@ bool NodeManager::splitReadHolder(ReadHolder * RH)
 					//std::cout<<RH->getLastSpacerPos()<<" : "<<(int)RH->getStartStopListSize() - 1<<" : "<<working_str<<std::endl;
 					RH->getNextSpacer(&working_str);
 					//MI std::cout << "SP: " << working_str << std::endl;
-					addCrisprNodes(&prev_node, working_str, header_st, RH);
+					addCrisprNodes(&prev_node, working_str, header_sts, readIndex);
 				} 
 				
 				// get our last spacer
@@ -204,7 +217,7 @@ bool NodeManager::splitReadHolder(ReadHolder * RH)
 				{
 					//std::cout<<working_str<<std::endl;
 					//MI std::cout << "last SP: " << working_str << std::endl;
-					addFirstCrisprNode(&prev_node, working_str, header_st, RH);
+					addFirstCrisprNode(&prev_node, working_str, header_sts, readIndex);
 				} 
 			}
 		} catch (crispr::substring_exception& e) {
@@ -225,7 +238,7 @@ bool NodeManager::splitReadHolder(ReadHolder * RH)
 //----
 // Private function called from splitReadHolder to cut the kmers and make the nodes
 //
-void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingString, StringToken headerSt, ReadHolder * RH)
+void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingString, const std::vector<StringToken>& headerSts, ReadIndex readIndex)
 {
     //-----
     // Given a spacer string, cut kmers from each end and make crispr nodes
@@ -234,6 +247,8 @@ void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingStr
     if ((int)workingString.length() < NM_Opts->cNodeKmerLength)
         return;
     
+    // every copy of the read adds to the coverage
+    int copies = static_cast<int>(headerSts.size());
     std::string first_kmer = workingString.substr(0, NM_Opts->cNodeKmerLength);
     std::string second_kmer = workingString.substr(workingString.length() - NM_Opts->cNodeKmerLength, NM_Opts->cNodeKmerLength );
     
@@ -251,8 +266,10 @@ void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingStr
         st1 = NM_StringCheck.addString(first_kmer);
         first_kmer_node = new CrisprNode(st1);
         
+        first_kmer_node->incrementCount(copies - 1);
+        
         // add them to the pile
-        NM_Nodes[st1] = first_kmer_node;
+        addNode(first_kmer_node);
 #ifdef DEBUG
         logInfo("creating node "<<st1<<" with string: "<<first_kmer, 10);
 #endif
@@ -260,8 +277,8 @@ void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingStr
     else
     {
         // we already have a node for this guy
-        first_kmer_node = NM_Nodes[st1];
-        first_kmer_node->incrementCount();
+        first_kmer_node = getNode(st1);
+        first_kmer_node->incrementCount(copies);
     }
     
     StringToken st2 = NM_StringCheck.getToken(second_kmer);
@@ -270,29 +287,30 @@ void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingStr
         st2 = NM_StringCheck.addString(second_kmer);
         second_kmer_node = new CrisprNode(st2);
         second_kmer_node->setForward(false);
-        NM_Nodes[st2] = second_kmer_node;
+        second_kmer_node->incrementCount(copies - 1);
+        addNode(second_kmer_node);
 #ifdef DEBUG
         logInfo("creating node "<<st2<<" with string: "<<second_kmer, 10);
 #endif
     }
     else
     {
-        second_kmer_node = NM_Nodes[st2];
-        second_kmer_node->incrementCount();
+        second_kmer_node = getNode(st2);
+        second_kmer_node->incrementCount(copies);
     }
 
     // add in the read headers for the two CrisprNodes
-    first_kmer_node->addReadHeader(headerSt);
-    second_kmer_node->addReadHeader(headerSt);
-    first_kmer_node->addReadHolder(RH);
-    second_kmer_node->addReadHolder(RH);
+    first_kmer_node->addReadHeaders(headerSts);
+    second_kmer_node->addReadHeaders(headerSts);
+    first_kmer_node->addReadHolder(readIndex);
+    second_kmer_node->addReadHolder(readIndex);
     
     // the first kmers pair is the previous node which lay before it therefore bool is true
     // make sure prevNode is not NULL
     if (NULL != *prevNode) 
     {
         this_sp_key = makeSpacerKey(st1, (*prevNode)->getID());
-        if(NM_Spacers.find(this_sp_key) == NM_Spacers.end())
+        if(NULL == NM_Spacers.find(this_sp_key))
         {
             (*prevNode)->addEdge(first_kmer_node, CN_EDGE_JUMPING_F);
             first_kmer_node->addEdge(*prevNode, CN_EDGE_JUMPING_B);
@@ -300,7 +318,7 @@ void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingStr
     }
     
 #ifdef SEARCH_SINGLETON
-    SearchCheckerList::iterator debug_iter = debugger->find(NM_StringCheck.getString(headerSt));
+    SearchCheckerList::iterator debug_iter = debugger->find(NM_StringCheck.getString(headerSts.front()));
     if (debug_iter != debugger->end()) {
         // interesting read
         debug_iter->second.addNode(st1);       
@@ -315,7 +333,7 @@ void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingStr
     // check to see if we already have it here
     this_sp_key = makeSpacerKey(st1, st2);
     
-    if(NM_Spacers.find(this_sp_key) == NM_Spacers.end())
+    if(NULL == NM_Spacers.find(this_sp_key))
     {
         // new instance
         StringToken sp_str_token = NM_StringCheck.getToken(workingString);
@@ -324,7 +342,8 @@ void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingStr
             sp_str_token = NM_StringCheck.addString(workingString);
     	}
         curr_spacer = new SpacerInstance(sp_str_token, first_kmer_node, second_kmer_node);
-        NM_Spacers[this_sp_key] = curr_spacer;
+        curr_spacer->incrementCount(copies - 1);
+        NM_Spacers.insert(this_sp_key, curr_spacer);
 #ifdef SEARCH_SINGLETON
         if (debug_iter != debugger->end()) {
             debug_iter->second.addSpacer(workingString);
@@ -341,17 +360,18 @@ void NodeManager::addCrisprNodes(CrisprNode ** prevNode, std::string& workingStr
     else
     {
         // increment the number of times we've seen this guy
-        (NM_Spacers[this_sp_key])->incrementCount();
+        (NM_Spacers.find(this_sp_key))->incrementCount(copies);
     }
     
     *prevNode = second_kmer_node;
 }
 
-void NodeManager::addSecondCrisprNode(CrisprNode ** prevNode, std::string& workingString, StringToken headerSt, ReadHolder * RH)
+void NodeManager::addSecondCrisprNode(CrisprNode ** prevNode, std::string& workingString, const std::vector<StringToken>& headerSts, ReadIndex readIndex)
 {
     if ((int)workingString.length() < NM_Opts->cNodeKmerLength)
         return;
     
+    int copies = static_cast<int>(headerSts.size());
     std::string second_kmer = workingString.substr(workingString.length() - NM_Opts->cNodeKmerLength, NM_Opts->cNodeKmerLength );
     CrisprNode * second_kmer_node;
     
@@ -365,26 +385,27 @@ void NodeManager::addSecondCrisprNode(CrisprNode ** prevNode, std::string& worki
         st2 = NM_StringCheck.addString(second_kmer);
         second_kmer_node = new CrisprNode(st2);
         second_kmer_node->setForward(false);
+        second_kmer_node->incrementCount(copies - 1);
         
         // add them to the pile
-        NM_Nodes[st2] = second_kmer_node;
+        addNode(second_kmer_node);
     }
     else
     {
         // we already have a node for this guy
-        second_kmer_node = NM_Nodes[st2];
-        (NM_Nodes[st2])->incrementCount();
+        second_kmer_node = getNode(st2);
+        second_kmer_node->incrementCount(copies);
     }
 #ifdef SEARCH_SINGLETON
-    SearchCheckerList::iterator debug_iter = debugger->find(NM_StringCheck.getString(headerSt));
+    SearchCheckerList::iterator debug_iter = debugger->find(NM_StringCheck.getString(headerSts.front()));
     if (debug_iter != debugger->end()) {
         // interesting read
         debug_iter->second.addNode(st2);
     }
 #endif
     // add in the read headers for the this CrisprNode
-    second_kmer_node->addReadHeader(headerSt);
-    second_kmer_node->addReadHolder(RH);
+    second_kmer_node->addReadHeaders(headerSts);
+    second_kmer_node->addReadHolder(readIndex);
     
     // add this guy in as the previous node for the next iteration
     *prevNode = second_kmer_node;
@@ -392,11 +413,12 @@ void NodeManager::addSecondCrisprNode(CrisprNode ** prevNode, std::string& worki
     // there is no one yet to make an edge
 }
 
-void NodeManager::addFirstCrisprNode(CrisprNode ** prevNode, std::string& workingString, StringToken headerSt, ReadHolder * RH)
+void NodeManager::addFirstCrisprNode(CrisprNode ** prevNode, std::string& workingString, const std::vector<StringToken>& headerSts, ReadIndex readIndex)
 {
     if ((int)workingString.length() < NM_Opts->cNodeKmerLength)
         return;
     
+    int copies = static_cast<int>(headerSts.size());
     std::string first_kmer = workingString.substr(0, NM_Opts->cNodeKmerLength);
     CrisprNode * first_kmer_node;
     
@@ -409,32 +431,33 @@ void NodeManager::addFirstCrisprNode(CrisprNode ** prevNode, std::string& workin
         // first time we've seen this guy. Make some new objects
         st1 = NM_StringCheck.addString(first_kmer);
         first_kmer_node = new CrisprNode(st1);
+        first_kmer_node->incrementCount(copies - 1);
         
         // add them to the pile
-        NM_Nodes[st1] = first_kmer_node;
+        addNode(first_kmer_node);
     }
     else
     {
         // we already have a node for this guy
-        first_kmer_node = NM_Nodes[st1];
-        (NM_Nodes[st1])->incrementCount();
+        first_kmer_node = getNode(st1);
+        first_kmer_node->incrementCount(copies);
     }
 #ifdef SEARCH_SINGLETON
-    SearchCheckerList::iterator debug_iter = debugger->find(NM_StringCheck.getString(headerSt));
+    SearchCheckerList::iterator debug_iter = debugger->find(NM_StringCheck.getString(headerSts.front()));
     if (debug_iter != debugger->end()) {
         // interesting read
         debug_iter->second.addNode(st1);       
     }
 #endif
     // add in the read headers for the this CrisprNode
-    first_kmer_node->addReadHeader(headerSt);
-    first_kmer_node->addReadHolder(RH);
+    first_kmer_node->addReadHeaders(headerSts);
+    first_kmer_node->addReadHolder(readIndex);
     
     // check to see if we already have it here
     if(NULL != *prevNode)
     {
         SpacerKey this_sp_key = makeSpacerKey(st1, (*prevNode)->getID());
-        if(NM_Spacers.find(this_sp_key) == NM_Spacers.end())
+        if(NULL == NM_Spacers.find(this_sp_key))
         {
             (*prevNode)->addEdge(first_kmer_node, CN_EDGE_JUMPING_F);
             first_kmer_node->addEdge(*prevNode, CN_EDGE_JUMPING_B);
@@ -442,6 +465,21 @@ void NodeManager::addFirstCrisprNode(CrisprNode ** prevNode, std::string& workin
     }
 }
 
+void NodeManager::addNode(CrisprNode * node)
+{
+    //-----
+    // nodes are only made for strings that have just been given a new 
+    // token, so pushing onto the back keeps NM_Nodes sorted by id
+    //
+    StringToken token = node->getID();
+    if(static_cast<size_t>(token) >= NM_NodeIndex.size())
+    {
+        NM_NodeIndex.resize(NM_StringCheck.mNextFreeToken + 1, 0);
+    }
+    NM_Nodes.push_back(node);
+    NM_NodeIndex[token] = static_cast<unsigned int>(NM_Nodes.size());
+}
+
 // Walking
 
 
@@ -456,11 +494,11 @@ void NodeManager::findCapNodes(NodeVector * capNodes)
     NodeListIterator all_node_iter = NM_Nodes.begin();
     while (all_node_iter != NM_Nodes.end()) 
     {
-        if((all_node_iter->second)->isAttached())
+        if((*all_node_iter)->isAttached())
         {
-            if ((all_node_iter->second)->getTotalRank() == 1) 
+            if ((*all_node_iter)->getTotalRank() == 1) 
             {
-                capNodes->push_back(all_node_iter->second);
+                capNodes->push_back(*all_node_iter);
             }
         }
         all_node_iter++;
@@ -477,9 +515,9 @@ void NodeManager::findAllNodes(NodeVector * allNodes)
     NodeListIterator all_node_iter = NM_Nodes.begin();
     while (all_node_iter != NM_Nodes.end()) 
     {
-        if((all_node_iter->second)->isAttached())
+        if((*all_node_iter)->isAttached())
         {
-            allNodes->push_back(all_node_iter->second);
+            allNodes->push_back(*all_node_iter);
             all_node_iter++;
         }
     }
@@ -496,13 +534,13 @@ void NodeManager::findAllNodes(NodeVector * capNodes, NodeVector * otherNodes)
     NodeListIterator all_node_iter = NM_Nodes.begin();
     while (all_node_iter != NM_Nodes.end()) 
     {
-        if((all_node_iter->second)->isAttached())
+        if((*all_node_iter)->isAttached())
         {
-            int rank = (all_node_iter->second)->getTotalRank(); 
+            int rank = (*all_node_iter)->getTotalRank(); 
             if (rank == 1) 
-            { capNodes->push_back(all_node_iter->second); }
+            { capNodes->push_back(*all_node_iter); }
             else
-            { otherNodes->push_back(all_node_iter->second); }
+            { otherNodes->push_back(*all_node_iter); }
         }
         all_node_iter++;
     }
@@ -542,9 +580,9 @@ int NodeManager::findCapsAt(NodeVector * capNodes, bool searchForward, bool isIn
         while(el_iter != el->end())
         {
             // make sure we only look at attached edges
-            if(el_iter->second)
+            if(el_iter->attached)
             {
-                CrisprNode * attached_node = el_iter->first;
+                CrisprNode * attached_node = el_iter->node;
                 if(1 == attached_node->getTotalRank())
                 {
                     // this guy is a cap!
@@ -693,7 +731,7 @@ int NodeManager::cleanGraph(void)
     
     while(some_detached)
     {
-        std::multimap<CrisprNode *, CrisprNode *> fork_choice_map;
+        std::multimap<CrisprNode *, CrisprNode *, CrisprNodeOrder> fork_choice_map;
         NodeVector nv_cap, nv_other, detach_list;
         NodeVectorIterator nv_iter;
         some_detached = false;
@@ -716,7 +754,7 @@ int NodeManager::cleanGraph(void)
                     el = (*nv_iter)->getEdges(CN_EDGE_JUMPING_B);
                 
                 // there is only one guy in this list!
-                int other_rank = ((el->begin())->first)->getTotalRank();
+                int other_rank = ((el->begin())->node)->getTotalRank();
                 if(other_rank != 2)
                     detach_list.push_back(*nv_iter);
             }
@@ -737,7 +775,7 @@ int NodeManager::cleanGraph(void)
                 }
                 
                 // there is only one guy in this list!
-                CrisprNode * joining_node = ((el->begin())->first); 
+                CrisprNode * joining_node = ((el->begin())->node); 
                 int other_rank = joining_node->getTotalRank();
                 if(other_rank != 2)
                 {
@@ -760,9 +798,9 @@ int NodeManager::cleanGraph(void)
         }
         
         // make coverage decisions for end forks
-        std::map<CrisprNode *, int> best_coverage_map_cov;
-        std::map<CrisprNode *, CrisprNode *> best_coverage_map_node;
-        std::multimap<CrisprNode *, CrisprNode *>::iterator fcm_iter = fork_choice_map.begin();
+        std::map<CrisprNode *, int, CrisprNodeOrder> best_coverage_map_cov;
+        std::map<CrisprNode *, CrisprNode *, CrisprNodeOrder> best_coverage_map_node;
+        std::multimap<CrisprNode *, CrisprNode *, CrisprNodeOrder>::iterator fcm_iter = fork_choice_map.begin();
         while(fcm_iter != fork_choice_map.end())
         {
             if(best_coverage_map_cov.find(fcm_iter->first) == best_coverage_map_cov.end())
@@ -875,39 +913,41 @@ bool NodeManager::clearBubbles(CrisprNode * rootNode, EDGE_TYPE currentEdgeType)
     edgeListIterator curr_edges_iter; //= curr_edges->begin();
     for (curr_edges_iter = curr_edges->begin(); curr_edges_iter != curr_edges->end(); ++curr_edges_iter) {
         
-        if ( !(curr_edges_iter->first)->isAttached()) 
+        if ( !(curr_edges_iter->node)->isAttached()) 
         {
             continue;
         }
         // we want to go through all the edges of the nodes above (2nd degree separation)
         // and since we used the forward edges to get here we now want the opposite (Jummping_F)
-        edgeList * edges_of_curr_edge = (curr_edges_iter->first)->getEdges(getOppositeEdgeType(currentEdgeType));
+        edgeList * edges_of_curr_edge = (curr_edges_iter->node)->getEdges(getOppositeEdgeType(currentEdgeType));
         
         edgeListIterator edges_of_curr_edge_iter; //= edges_of_curr_edge->begin();
         for (edges_of_curr_edge_iter = edges_of_curr_edge->begin(); edges_of_curr_edge_iter != edges_of_curr_edge->end(); ++edges_of_curr_edge_iter) 
         {
             // make sue that this guy is attached
-            if (! (edges_of_curr_edge_iter->first)->isAttached()) 
+            if (! (edges_of_curr_edge_iter->node)->isAttached()) 
             {
                 continue;
             }
             // so now we're at the second degree of separation for our edges
             // again make a key but check to see if the key exists in the hash
             
-            int new_key = makeKey(rootNode->getID(), (edges_of_curr_edge_iter->first)->getID());
+            int new_key = makeKey(rootNode->getID(), (edges_of_curr_edge_iter->node)->getID());
             if (bubble_map.find(new_key) == bubble_map.end()) 
             {
                 // first time we've seen him
-                bubble_map[new_key] = (curr_edges_iter->first)->getID();
+                bubble_map[new_key] = (curr_edges_iter->node)->getID();
             } 
             else 
             {
                 // aha! he is pointing back onto the same guy as someone else.  We have a bubble!
                 //get the CrisprNode of the first guy
                 
-                CrisprNode * first_node = NM_Nodes[bubble_map[new_key]];
+                CrisprNode * first_node = getNode(bubble_map[new_key]);
+                StringToken curr_id = curr_edges_iter->id;
+                StringToken inner_id = edges_of_curr_edge_iter->id;
 #ifdef DEBUG
-                logInfo("Bubble found conecting "<<rootNode->getID()<<" : "<<first_node->getID()<<" : "<<(edges_of_curr_edge_iter->first)->getID()<< " : "<<(curr_edges_iter->first)->getID(), 8);
+                logInfo("Bubble found conecting "<<rootNode->getID()<<" : "<<first_node->getID()<<" : "<<(edges_of_curr_edge_iter->node)->getID()<< " : "<<(curr_edges_iter->node)->getID(), 8);
 #endif
                 //perform a coverage test on the nodes that end up here and kill the one with the least coverage
                 
@@ -917,23 +957,23 @@ bool NodeManager::clearBubbles(CrisprNode * rootNode, EDGE_TYPE currentEdgeType)
                 // NodeManager to calculate the average and stdev of the coverage and then remove a node only if
                 // it is below 1 stdev of the average, else it could be a biological thing that this bubble exists.
                 
-                if (first_node->getDiscountedCoverage() > (curr_edges_iter->first)->getDiscountedCoverage()) 
+                if (first_node->getDiscountedCoverage() > (curr_edges_iter->node)->getDiscountedCoverage()) 
                 {
 #ifdef DEBUG
-                    logInfo("Node "<<first_node->getID()<<" has higher discounted coverage ("<<first_node->getDiscountedCoverage()<<") than Node "<<(curr_edges_iter->first)->getID()<<" ("<<(curr_edges_iter->first)->getDiscountedCoverage()<<")", 8);
+                    logInfo("Node "<<first_node->getID()<<" has higher discounted coverage ("<<first_node->getDiscountedCoverage()<<") than Node "<<(curr_edges_iter->node)->getID()<<" ("<<(curr_edges_iter->node)->getDiscountedCoverage()<<")", 8);
 #endif
                     
                     // the first guy has greater coverage so detach our current node
-                    (curr_edges_iter->first)->detachNode();
+                    (curr_edges_iter->node)->detachNode();
                     some_detached = true;
 #ifdef DEBUG
-                    logInfo("Detaching "<<(curr_edges_iter->first)->getID()<<" as it has lower coverage", 8);
+                    logInfo("Detaching "<<(curr_edges_iter->node)->getID()<<" as it has lower coverage", 8);
 #endif
                 } 
                 else 
                 {
 #ifdef DEBUG
-                    logInfo("Node "<<first_node->getID()<<" has lower discounted coverage ("<<first_node->getDiscountedCoverage()<<") than Node "<<(curr_edges_iter->first)->getID()<<" ("<<(curr_edges_iter->first)->getDiscountedCoverage()<<")", 8);
+                    logInfo("Node "<<first_node->getID()<<" has lower discounted coverage ("<<first_node->getDiscountedCoverage()<<") than Node "<<(curr_edges_iter->node)->getID()<<" ("<<(curr_edges_iter->node)->getDiscountedCoverage()<<")", 8);
 #endif
                     // the first guy was lower so kill him
                     first_node->detachNode();
@@ -942,8 +982,13 @@ bool NodeManager::clearBubbles(CrisprNode * rootNode, EDGE_TYPE currentEdgeType)
                     logInfo("Detaching "<<first_node->getID()<<" as it has lower coverage", 8);
 #endif
                     // replace the existing key (to check for triple bubbles)
-                    bubble_map[new_key] = (curr_edges_iter->first)->getID();
+                    bubble_map[new_key] = (curr_edges_iter->node)->getID();
                 }
+
+                // detaching can give the nodes around here new (detached) edges
+                // and the lists may have moved, so find our place in them again
+                curr_edges_iter = rootNode->findEdge(curr_edges, curr_id);
+                edges_of_curr_edge_iter = (curr_edges_iter->node)->findEdge(edges_of_curr_edge, inner_id);
             }
         }
     }
@@ -1007,7 +1052,7 @@ void NodeManager::clearContigs(void)
             SpacerVectorIterator sp_iter = (cl_iter->second)->begin();
             while(sp_iter != (cl_iter->second)->end())
             {
-                (NM_Spacers[*sp_iter])->setContigID(0);
+                (NM_Spacers.find(*sp_iter))->setContigID(0);
                 sp_iter++;
             }
             delete cl_iter->second;
@@ -1027,9 +1072,9 @@ void NodeManager::findAllForwardAttachedNodes(NodeVector * nodes)
     NodeListIterator all_node_iter = NM_Nodes.begin();
     while (all_node_iter != NM_Nodes.end()) 
     {
-        if((all_node_iter->second)->isAttached()&& (all_node_iter->second)->isForward())
+        if((*all_node_iter)->isAttached()&& (*all_node_iter)->isForward())
         {
-            nodes->push_back(all_node_iter->second);
+            nodes->push_back(*all_node_iter);
         }
         all_node_iter++;
     }
@@ -1062,17 +1107,17 @@ int NodeManager::buildSpacerGraph(void)
             edgeListIterator qel_iter = qel->begin();
             while(qel_iter != qel->end())
             {
-                if((qel_iter->first)->isAttached() && (qel_iter->first)->isForward())
+                if((qel_iter->node)->isAttached() && (qel_iter->node)->isForward())
                 {
                     // a forward attached node. Now check for inner edges.
-                    edgeList * el = (qel_iter->first)->getEdges(CN_EDGE_FORWARD);
+                    edgeList * el = (qel_iter->node)->getEdges(CN_EDGE_FORWARD);
                     edgeListIterator el_iter = el->begin();
                     while(el_iter != el->end())
                     {
-                        if((el_iter->first)->isAttached())
+                        if((el_iter->node)->isAttached())
                         {
                             // bingo!
-                            SpacerInstance * next_spacer = NM_Spacers[makeSpacerKey((el_iter->first)->getID(), (qel_iter->first)->getID())];
+                            SpacerInstance * next_spacer = NM_Spacers.find(makeSpacerKey((el_iter->node)->getID(), (qel_iter->node)->getID()));
                             
                             if (next_spacer == spacers_iter->second) {
                                 //logError("Spacer "<<spacers_iter->second << " with id "<< (spacers_iter->second)->getID()<< " has an edge to itself... aborting edge "<<next_spacer <<" : "<< spacers_iter->second);
@@ -1485,13 +1530,29 @@ void NodeManager::dumpReads(std::string readsFileName, bool showDetached)
         }
         
         // now we can print all the reads to file
+        ReadHolder read;
+        std::vector<std::string> copy_headers;
         ReadListIterator read_iter = NM_ReadList.begin();
         while (read_iter != NM_ReadList.end()) 
         {
-            std::string header = (*read_iter)->getHeader();
+            std::string header = NM_ReadStore->getHeader(*read_iter);
             if(reads_set.find(header) != reads_set.end())
             {
-                reads_file <<*(*read_iter)<<std::endl;
+                NM_ReadStore->get(*read_iter, read);
+                reads_file <<read<<std::endl;
+            }
+            // copies of the read that were folded into it are the same 
+            // read under another name
+            NM_ReadStore->getDuplicateHeaders(*read_iter, copy_headers);
+            std::vector<std::string>::iterator copy_iter;
+            for (copy_iter = copy_headers.begin(); copy_iter != copy_headers.end(); ++copy_iter) 
+            {
+                if(reads_set.find(*copy_iter) != reads_set.end())
+                {
+                    NM_ReadStore->get(*read_iter, read);
+                    read.setHeader(*copy_iter);
+                    reads_file <<read<<std::endl;
+                }
             }
             read_iter++;
         }
@@ -1762,7 +1823,7 @@ void NodeManager::setDebugColourLimits(void)
     NodeListIterator nl_iter = nodeBegin();
     while (nl_iter != nodeEnd()) 
     {
-        int coverage = (nl_iter->second)->getCoverage();
+        int coverage = (*nl_iter)->getCoverage();
         if (coverage > max_coverage) 
         {
             max_coverage = coverage;
@@ -1833,9 +1894,9 @@ void NodeManager::printDebugGraph(std::ostream &dataOut, std::string title, bool
     while (nl_iter != nodeEnd()) 
     {
         // check whether we should print
-        if((nl_iter->second)->isAttached() | showDetached)
+        if((*nl_iter)->isAttached() | showDetached)
         {
-            printDebugNodeAttributes(dataOut, nl_iter->second ,NM_DebugRainbow.getColour((nl_iter->second)->getCoverage()), longDesc);
+            printDebugNodeAttributes(dataOut, *nl_iter ,NM_DebugRainbow.getColour((*nl_iter)->getCoverage()), longDesc);
         }
         nl_iter++;
     }
@@ -1845,14 +1906,14 @@ void NodeManager::printDebugGraph(std::ostream &dataOut, std::string title, bool
     while (nl_iter != nodeEnd()) 
     {
         // check whether we should print
-        if((nl_iter->second)->isAttached() | showDetached)
+        if((*nl_iter)->isAttached() | showDetached)
         {
             std::stringstream ss;
             if(longDesc)
-                ss << (nl_iter->second)->getID() << "_" << NM_StringCheck.getString((nl_iter->second)->getID());
+                ss << (*nl_iter)->getID() << "_" << NM_StringCheck.getString((*nl_iter)->getID());
             else
-                ss << (nl_iter->second)->getID();
-            (nl_iter->second)->printEdges(dataOut, &NM_StringCheck, ss.str(), showDetached, printBackEdges, longDesc);
+                ss << (*nl_iter)->getID();
+            (*nl_iter)->printEdges(dataOut, &NM_StringCheck, ss.str(), showDetached, printBackEdges, longDesc);
         }
         nl_iter++;
     }
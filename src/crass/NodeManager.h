@@ -53,9 +53,11 @@
 #include "crassDefines.h"
 #include "CrisprNode.h"
 #include "SpacerInstance.h"
+#include "SpacerList.h"
 #include "libcrispr.h"
 #include "StringCheck.h"
 #include "ReadHolder.h"
+#include "ReadStore.h"
 #include "GraphDrawingDefines.h"
 #include "Rainbow.h"
 #include "writer.h"
@@ -66,11 +68,12 @@
 #endif
 
 // typedefs
-typedef std::map<StringToken, CrisprNode *> NodeList;
-typedef std::map<StringToken, CrisprNode *>::iterator NodeListIterator;
+// nodes are made in the order their tokens are handed out so this is
+// always sorted by id
+typedef std::vector<CrisprNode *> NodeList;
+typedef std::vector<CrisprNode *>::iterator NodeListIterator;
 
-typedef std::map<SpacerKey, SpacerInstance *> SpacerList;
-typedef std::map<SpacerKey, SpacerInstance *>::iterator SpacerListIterator;
+typedef SpacerList::iterator SpacerListIterator;
 
 typedef std::vector<CrisprNode *> NodeVector;
 typedef std::vector<CrisprNode *>::iterator NodeVectorIterator;
@@ -121,10 +124,10 @@ class WalkingManager {
 class NodeManager {
     public:
 
-        NodeManager(std::string drSeq, const options * userOpts);
+        NodeManager(std::string drSeq, const options * userOpts, ReadStore * readStore);
         ~NodeManager(void);
 
-		bool addReadHolder(ReadHolder * RH);
+		bool addReadHolder(ReadIndex readIndex);
 
         NodeListIterator nodeBegin(void) { return NM_Nodes.begin(); } 
         NodeListIterator nodeEnd(void) { return NM_Nodes.end(); }
@@ -254,27 +257,39 @@ class NodeManager {
     
     // Stats
         inline size_t meanSpacerLength(void) { return NM_SpacerLenStat.mean();}
+        inline size_t numNodes(void) { return NM_Nodes.size(); }
+        inline size_t numSpacers(void) { return NM_Spacers.size(); }
+        inline size_t numContigs(void) { return NM_Contigs.size(); }
         
     inline double stdevSpacerLength(void) { return NM_SpacerLenStat.standardDeviation();}
     private:
 		
 	// functions
-		bool splitReadHolder(ReadHolder * RH);
+		bool splitReadHolder(ReadHolder * RH, ReadIndex readIndex);
+
+        // the node made from the string with this token or NULL
+        inline CrisprNode * getNode(StringToken token)
+        {
+            if(token < 0 || static_cast<size_t>(token) >= NM_NodeIndex.size() || 0 == NM_NodeIndex[token])
+                return NULL;
+            return NM_Nodes[NM_NodeIndex[token] - 1];
+        }
+        void addNode(CrisprNode * node);
 
 		void addCrisprNodes(CrisprNode ** prevNode, 
                             std::string& workingString, 
-                            StringToken headerSt,
-                            ReadHolder * RH);
+                            const std::vector<StringToken>& headerSts,
+                            ReadIndex readIndex);
     
         void addSecondCrisprNode(CrisprNode ** prevNode, 
                                  std::string& workingString, 
-                                 StringToken headerSt,
-                                 ReadHolder * RH);
+                                 const std::vector<StringToken>& headerSts,
+                                 ReadIndex readIndex);
     
         void addFirstCrisprNode(CrisprNode ** prevNode, 
                                 std::string& workingString, 
-                                StringToken headerSt,
-                                ReadHolder * RH);
+                                const std::vector<StringToken>& headerSts,
+                                ReadIndex readIndex);
     
         void setContigIDForSpacers(SpacerInstanceVector * currentContigNodes);
     
@@ -283,8 +298,10 @@ class NodeManager {
     // members
         std::string NM_DirectRepeatSequence;  				// the sequence of this managers direct repeat
         NodeList NM_Nodes;                    				// list of CrisprNodes this manager manages
+        std::vector<unsigned int> NM_NodeIndex;             // for each string token, 1 + where its node is in NM_Nodes or 0 if it is not a node
         SpacerList NM_Spacers;                				// list of all the spacers
         ReadList NM_ReadList;                 				// list of readholders
+        ReadStore * NM_ReadStore;             				// where the reads in NM_ReadList are kept
         StringCheck NM_StringCheck;           				// string check object for unique strings 
         Rainbow NM_DebugRainbow;              				// the Rainbow class for making colours
         Rainbow NM_SpacerRainbow;      				        // the Rainbow class for making colours
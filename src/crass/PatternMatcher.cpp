@@ -22,10 +22,22 @@
 
 #include "PatternMatcher.h"
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PM_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// one entry for every byte value, reads are not always plain ascii
+#define BMP_NUM_ASCII_CHARS 256
 
 int PatternMatcher::bmpSearch(const std::string &text, const std::string &pattern){
-    size_t textSize = text.size();
-    size_t patternSize = pattern.size();
+    return bmpSearch(text.data(), text.size(), pattern.data(), pattern.size());
+}
+
+int PatternMatcher::bmpSearch(const char * text, size_t textSize, const char * pattern, size_t patternSize){
     if(textSize == 0 || patternSize == 0){
         return -1;
     }
@@ -33,7 +45,8 @@ int PatternMatcher::bmpSearch(const std::string &text, const std::string &patter
         return -1;
     }
     
-    std::vector<int> bmpLast = computeBmpLast(pattern);
+    int bmpLast[BMP_NUM_ASCII_CHARS];
+    computeBmpLast(pattern, patternSize, bmpLast);
     size_t tIdx = patternSize - 1;
     size_t pIdx = patternSize - 1;
     while(tIdx < textSize)
@@ -50,7 +63,7 @@ int PatternMatcher::bmpSearch(const std::string &text, const std::string &patter
         else 
         {
             //Character Jump Heuristics
-            int lastOccur = bmpLast[text[tIdx]];
+            int lastOccur = bmpLast[static_cast<unsigned char>(text[tIdx])];
             tIdx = tIdx + patternSize - std::min<int>((int)pIdx, 1 + lastOccur);
             pIdx = patternSize - 1;
         }
@@ -58,6 +71,133 @@ int PatternMatcher::bmpSearch(const std::string &text, const std::string &patter
     return - 1;
 }
 
+//-----
+// Exact search for short patterns. The texts we look through are only a 
+// few hundred bases and the patterns are the 6-9bp search windows so 
+// Boyer-Moore never gets to make a decent jump. Instead compare the first 
+// and last base of the pattern against a whole block of the text at once 
+// and only check the middle of the pattern where both of those match.
+//
+typedef int (*ExactSearchKernel)(const char *, size_t, const char *, size_t);
+
+int PatternMatcher::exactSearchScalar(const char * text, size_t textSize, const char * pattern, size_t patternSize){
+    if(textSize == 0 || patternSize == 0 || patternSize > textSize){
+        return -1;
+    }
+    const char * last_start = text + textSize - patternSize;
+    const char * candidate = text;
+    while(candidate <= last_start)
+    {
+        candidate = static_cast<const char *>(memchr(candidate, pattern[0], last_start - candidate + 1));
+        if(candidate == NULL)
+        {
+            return -1;
+        }
+        if(memcmp(candidate + 1, pattern + 1, patternSize - 1) == 0)
+        {
+            return (int)(candidate - text);
+        }
+        candidate++;
+    }
+    return -1;
+}
+
+#ifdef PM_HAVE_X86_SIMD
+// check the middle of the pattern for each set bit of mask, lowest first
+static inline int verifyCandidates(unsigned int mask, const char * block, const char * pattern, size_t patternSize, size_t offset)
+{
+    while(mask != 0)
+    {
+        unsigned int bit = __builtin_ctz(mask);
+        if(patternSize <= 2 || memcmp(block + bit + 1, pattern + 1, patternSize - 2) == 0)
+        {
+            return (int)(offset + bit);
+        }
+        mask &= mask - 1;
+    }
+    return -1;
+}
+
+__attribute__((target("sse2")))
+static int exactSearchSse2(const char * text, size_t textSize, const char * pattern, size_t patternSize){
+    if(textSize == 0 || patternSize == 0 || patternSize > textSize){
+        return -1;
+    }
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[patternSize - 1]);
+    size_t i = 0;
+    // both loads must stay inside the text
+    for(; i + patternSize + 15 <= textSize; i += 16)
+    {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+        __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i + patternSize - 1));
+        __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last));
+        int found = verifyCandidates((unsigned int)_mm_movemask_epi8(eq), text + i, pattern, patternSize, i);
+        if(found >= 0)
+        {
+            return found;
+        }
+    }
+    int found = PatternMatcher::exactSearchScalar(text + i, textSize - i, pattern, patternSize);
+    return (found < 0) ? -1 : found + (int)i;
+}
+
+__attribute__((target("avx2")))
+static int exactSearchAvx2(const char * text, size_t textSize, const char * pattern, size_t patternSize){
+    if(textSize == 0 || patternSize == 0 || patternSize > textSize){
+        return -1;
+    }
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last = _mm256_set1_epi8(pattern[patternSize - 1]);
+    size_t i = 0;
+    for(; i + patternSize + 31 <= textSize; i += 32)
+    {
+        __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i));
+        __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i + patternSize - 1));
+        __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last));
+        int found = verifyCandidates((unsigned int)_mm256_movemask_epi8(eq), text + i, pattern, patternSize, i);
+        if(found >= 0)
+        {
+            return found;
+        }
+    }
+    // finish off the tail with the narrower kernel
+    int found = exactSearchSse2(text + i, textSize - i, pattern, patternSize);
+    return (found < 0) ? -1 : found + (int)i;
+}
+#endif
+
+static ExactSearchKernel chooseExactSearchKernel(const char ** name)
+{
+#ifdef PM_HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+        *name = "avx2";
+        return exactSearchAvx2;
+    }
+    if(__builtin_cpu_supports("sse2"))
+    {
+        *name = "sse2";
+        return exactSearchSse2;
+    }
+#endif
+    *name = "scalar";
+    return PatternMatcher::exactSearchScalar;
+}
+
+// picked during static initialisation so there is no race between search threads
+static const char * exact_search_kernel_name = "scalar";
+static ExactSearchKernel exact_search_kernel = chooseExactSearchKernel(&exact_search_kernel_name);
+
+int PatternMatcher::exactSearch(const char * text, size_t textSize, const char * pattern, size_t patternSize){
+    return exact_search_kernel(text, textSize, pattern, patternSize);
+}
+
+const char * PatternMatcher::exactSearchKernel(void){
+    return exact_search_kernel_name;
+}
+
 // slight variation of the code above so that when a match is found it is pushed to 
 // a vector of starting positions
 void PatternMatcher::bmpMultiSearch(const std::string &text, const std::string &pattern, std::vector<int> &startOffsetVec )
@@ -71,7 +211,8 @@ void PatternMatcher::bmpMultiSearch(const std::string &text, const std::string &
         return;
     }
     
-    std::vector<int> bmpLast = computeBmpLast(pattern);
+    int bmpLast[BMP_NUM_ASCII_CHARS];
+    computeBmpLast(pattern.data(), patternSize, bmpLast);
     size_t tIdx = patternSize - 1;
     size_t pIdx = patternSize - 1;
     while(tIdx < textSize)
@@ -88,7 +229,7 @@ void PatternMatcher::bmpMultiSearch(const std::string &text, const std::string &
         else 
         {
             //Character Jump Heuristics
-            int lastOccur = bmpLast[text[tIdx]];
+            int lastOccur = bmpLast[static_cast<unsigned char>(text[tIdx])];
             tIdx = tIdx + patternSize - std::min<int>((int)pIdx, 1 + lastOccur);
             pIdx = patternSize - 1;
         }
@@ -96,102 +237,114 @@ void PatternMatcher::bmpMultiSearch(const std::string &text, const std::string &
 }
 
 
-std::vector<int> PatternMatcher::computeBmpLast(const std::string &pattern){
-    const size_t NUM_ASCII_CHARS = 128;
-    std::vector<int> bmpLast(NUM_ASCII_CHARS);
-    for(size_t i = 0; i < NUM_ASCII_CHARS; i++){
+void PatternMatcher::computeBmpLast(const char * pattern, size_t patternSize, int * bmpLast){
+    // bmpLast must hold BMP_NUM_ASCII_CHARS ints, it lives on the
+    // callers stack so that nothing gets allocated per search
+    for(size_t i = 0; i < BMP_NUM_ASCII_CHARS; i++){
         bmpLast[i] = -1;
     }
-    for(size_t i = 0; i < pattern.size(); i++){
-        bmpLast[pattern[i]] = (int)i;
+    for(size_t i = 0; i < patternSize; i++){
+        bmpLast[static_cast<unsigned char>(pattern[i])] = (int)i;
     }
-    return bmpLast;
 }
 
 int PatternMatcher::levenstheinDistance( std::string& source,  std::string& target) {
-    
-    // Step 1
-    
-    int n = (int)source.length();
-    int m = (int)target.length();
+    // the distance can never be more than the longer string
+    int longest = (int)std::max(source.length(), target.length());
+    return boundedEditDistance(source.data(), source.length(), target.data(), target.length(), longest);
+}
+
+int PatternMatcher::boundedEditDistance(const char * source, size_t sourceLength, const char * target, size_t targetLength, int maxDistance) {
+    //-----
+    // The edit distance with the transposition step from Berghel and Roach,
+    // see: "An Extension of Ukkonen's Enhanced Dynamic Programming ASM Algorithm"
+    // (http://www.acm.org/~hlb/publications/asm/asm.html)
+    // 
+    // Every cell is at least |i - j| so only the cells within maxDistance of 
+    // the diagonal are worked out, everything else is capped at maxDistance + 1.
+    // Capping does not change any cell that is below the cap. Only three rows 
+    // are needed as the transposition looks back two rows.
+    //
+    int n = (int)sourceLength;
+    int m = (int)targetLength;
+    if (maxDistance < 0) {
+        maxDistance = 0;
+    }
+    int cap = maxDistance + 1;
     if (n == 0) {
-        return m;
+        return std::min(m, cap);
     }
     if (m == 0) {
-        return n;
+        return std::min(n, cap);
     }
-    
-    // Good form to declare a TYPEDEF
-    
-    
-    Tmatrix matrix(n+1);
-    
-    // Size the vectors in the 2.nd dimension. Unfortunately C++ doesn't
-    // allow for allocation on declaration of 2.nd dimension of vec of vec
-    
-    for (int i = 0; i <= n; i++) {
-        matrix[i].resize(m+1);
+    if (std::abs(n - m) > maxDistance) {
+        return cap;
     }
     
-    // Step 2
-    
-    for (int i = 0; i <= n; i++) {
-        matrix[i][0]=i;
+    int stack_rows[3][PM_MAX_STACK_ROW];
+    std::vector<int> heap_rows;
+    int * rows[3];
+    if (m + 2 <= PM_MAX_STACK_ROW) {
+        rows[0] = stack_rows[0];
+        rows[1] = stack_rows[1];
+        rows[2] = stack_rows[2];
+    } else {
+        heap_rows.resize(3 * (m + 2));
+        rows[0] = &heap_rows[0];
+        rows[1] = &heap_rows[m + 2];
+        rows[2] = &heap_rows[2 * (m + 2)];
     }
     
-    for (int j = 0; j <= m; j++) {
-        matrix[0][j]=j;
+    // the first row
+    int * current = rows[0];
+    int hi = std::min(m, maxDistance);
+    for (int j = 0; j <= hi; j++) {
+        current[j] = j;
     }
-    
-    // Step 3
+    current[hi + 1] = cap;
+    int previous_min = 0;
     
     for (int i = 1; i <= n; i++) {
+        int * above = rows[(i - 1) % 3];
+        int * above_two = rows[(i + 1) % 3];         // row i - 2
+        current = rows[i % 3];
         
-        char s_i = source[i-1];
+        int lo = std::max(1, i - maxDistance);
+        hi = std::min(m, i + maxDistance);
         
-        // Step 4
+        // the cells either side of the band
+        current[lo - 1] = (lo == 1) ? std::min(i, cap) : cap;
+        current[hi + 1] = cap;
         
-        for (int j = 1; j <= m; j++) {
-            
+        char s_i = source[i-1];
+        int row_min = current[lo - 1];
+        for (int j = lo; j <= hi; j++) {
             char t_j = target[j-1];
-            
-            // Step 5
-            
-            int cost;
-            if (s_i == t_j) {
-                cost = 0;
-            }
-            else {
-                cost = 1;
-            }
-            
-            // Step 6
-            
-            int above = matrix[i-1][j];
-            int left = matrix[i][j-1];
-            int diag = matrix[i-1][j-1];
-            int cell = std::min( above + 1, std::min(left + 1, diag + cost));
-            
-            // Step 6A: Cover transposition, in addition to deletion,
-            // insertion and substitution. This step is taken from:
-            // Berghel, Hal ; Roach, David : "An Extension of Ukkonen's 
-            // Enhanced Dynamic Programming ASM Algorithm"
-            // (http://www.acm.org/~hlb/publications/asm/asm.html)
+            int cost = (s_i == t_j) ? 0 : 1;
+            int cell = std::min(above[j] + 1, std::min(current[j-1] + 1, above[j-1] + cost));
             
             if (i>2 && j>2) {
-                int trans=matrix[i-2][j-2]+1;
+                int trans = above_two[j-2] + 1;
                 if (source[i-2]!=t_j) trans++;
                 if (s_i!=target[j-2]) trans++;
                 if (cell>trans) cell=trans;
             }
-            
-            matrix[i][j]=cell;
+            if (cell > cap) {
+                cell = cap;
+            }
+            current[j] = cell;
+            if (cell < row_min) {
+                row_min = cell;
+            }
+        }
+        
+        // when two rows in a row are over the cap nothing below can get under it
+        if (row_min >= cap && previous_min >= cap) {
+            return cap;
         }
+        previous_min = row_min;
     }
-    
-    // Step 7
-    
-    return matrix[n][m];
+    return current[m];
 }
 
 float PatternMatcher::getStringSimilarity(std::string& s1, std::string& s2)
@@ -203,3 +356,23 @@ float PatternMatcher::getStringSimilarity(std::string& s1, std::string& s2)
     return 1.0 - (edit_distance/max_length);
 }
 
+float PatternMatcher::getStringSimilarity(std::string& s1, std::string& s2, float threshold)
+{
+    float max_length = std::max(s1.length(), s2.length());
+    if(s1.length() < 3 || s2.length() < 3)
+    	return 0;
+    
+    //-----
+    // The similarity only goes down as the distance goes up so find the 
+    // smallest distance that would put us at or below the threshold, any 
+    // distance past that is not worth working out
+    //
+    int longest = (int)max_length;
+    int give_up = std::max(0, (int)((1.0 - threshold) * max_length) - 1);
+    while (give_up < longest && (float)(1.0 - (give_up/max_length)) > threshold) {
+        give_up++;
+    }
+    float edit_distance = boundedEditDistance(s1.data(), s1.length(), s2.data(), s2.length(), give_up - 1);
+    return 1.0 - (edit_distance/max_length);
+}
+
@@ -26,18 +26,44 @@
 #include <vector>
 typedef std::vector< std::vector<int> > Tmatrix; 
 
+// rows of the edit distance matrix up to this long live on the stack
+#define PM_MAX_STACK_ROW 256
+
 class PatternMatcher{
 public:
     static int bmpSearch(const std::string& text, const std::string& pattern);
     
+    // same as above but on a window of a larger string, nothing is copied
+    static int bmpSearch(const char * text, size_t textSize, const char * pattern, size_t patternSize);
+    
+    // exact search for short patterns, gives the same answer as bmpSearch.
+    // Uses SSE2 or AVX2 when the cpu has them, picked once at startup
+    static int exactSearch(const char * text, size_t textSize, const char * pattern, size_t patternSize);
+    
+    // the plain version of exactSearch, for when there is no SIMD
+    static int exactSearchScalar(const char * text, size_t textSize, const char * pattern, size_t patternSize);
+    
+    // the name of the kernel exactSearch is using
+    static const char * exactSearchKernel(void);
+    
     static void bmpMultiSearch(const std::string &text, const std::string &pattern, std::vector<int> &startOffsetVec);
     
     static int levenstheinDistance( std::string& source,  std::string& target);
     
+    // the same distance as levenstheinDistance but it gives up once the 
+    // distance is over maxDistance and returns maxDistance + 1 instead.
+    // Only a band of the matrix is filled and nothing is allocated for 
+    // strings shorter than PM_MAX_STACK_ROW
+    static int boundedEditDistance(const char * source, size_t sourceLength, const char * target, size_t targetLength, int maxDistance);
+    
     static float getStringSimilarity(std::string& s1, std::string& s2);
+    
+    // as above, but only exact when the similarity is above threshold.
+    // Otherwise the value returned is <= threshold and >= the real similarity
+    static float getStringSimilarity(std::string& s1, std::string& s2, float threshold);
 
 private:
-    static std::vector<int> computeBmpLast(const std::string& pattern);
+    static void computeBmpLast(const char * pattern, size_t patternSize, int * bmpLast);
     
     PatternMatcher();
     PatternMatcher(const PatternMatcher&);
@@ -0,0 +1,278 @@
+// File: PipelineStats.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of PipelineStats functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+// system includes
+#include <fstream>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <time.h>
+
+// local includes
+#include "PipelineStats.h"
+
+static double wallSeconds(void)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + now.tv_usec / 1e6;
+}
+
+static double cpuSeconds(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + 
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+static long peakRssKb(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    // reported in bytes on OSX
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+// stage and count names are ours so only quotes and slashes need escaping
+static std::string jsonString(const std::string& str)
+{
+    std::string escaped = "\"";
+    for (size_t i = 0; i < str.length(); i++) 
+    {
+        if (str[i] == '"' || str[i] == '\\') 
+        {
+            escaped += '\\';
+        }
+        escaped += str[i];
+    }
+    escaped += '"';
+    return escaped;
+}
+
+PipelineStats::PipelineStats(void)
+{
+    PS_StageWallStart = 0;
+    PS_StageCpuStart = 0;
+    PS_WallStart = wallSeconds();
+}
+
+void PipelineStats::startStage(const std::string& name)
+{
+    if (! PS_CurrentStage.empty()) 
+    {
+        endStage();
+    }
+    PS_CurrentStage = name;
+    PS_StageWallStart = wallSeconds();
+    PS_StageCpuStart = cpuSeconds();
+}
+
+void PipelineStats::addStage(const std::string& name, double wallSeconds, double cpuSeconds)
+{
+    if (! PS_CurrentStage.empty()) 
+    {
+        endStage();
+    }
+    Stage stage;
+    stage.name = name;
+    stage.wallSeconds = wallSeconds;
+    stage.cpuSeconds = cpuSeconds;
+    stage.peakRssKb = peakRssKb();
+    PS_Stages.push_back(stage);
+}
+
+double PipelineStats::wallClock(void)
+{
+    return wallSeconds();
+}
+
+double PipelineStats::threadCpuClock(void)
+{
+    struct timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) 
+    {
+        return 0;
+    }
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void PipelineStats::endStage(void)
+{
+    if (PS_CurrentStage.empty()) 
+    {
+        return;
+    }
+    Stage stage;
+    stage.name = PS_CurrentStage;
+    stage.wallSeconds = wallSeconds() - PS_StageWallStart;
+    stage.cpuSeconds = cpuSeconds() - PS_StageCpuStart;
+    stage.peakRssKb = peakRssKb();
+    PS_Stages.push_back(stage);
+    PS_CurrentStage.clear();
+}
+
+std::vector<std::pair<std::string, long> >::iterator PipelineStats::findCount(const std::string& name)
+{
+    std::vector<std::pair<std::string, long> >::iterator count_iter;
+    for (count_iter = PS_Counts.begin(); count_iter != PS_Counts.end(); ++count_iter) 
+    {
+        if (count_iter->first == name) 
+        {
+            break;
+        }
+    }
+    return count_iter;
+}
+
+void PipelineStats::setCount(const std::string& name, long value)
+{
+    std::vector<std::pair<std::string, long> >::iterator count_iter = findCount(name);
+    if (count_iter == PS_Counts.end()) 
+    {
+        PS_Counts.push_back(std::pair<std::string, long>(name, value));
+    } 
+    else 
+    {
+        count_iter->second = value;
+    }
+}
+
+void PipelineStats::addCount(const std::string& name, long value)
+{
+    std::vector<std::pair<std::string, long> >::iterator count_iter = findCount(name);
+    if (count_iter == PS_Counts.end()) 
+    {
+        PS_Counts.push_back(std::pair<std::string, long>(name, value));
+    } 
+    else 
+    {
+        count_iter->second += value;
+    }
+}
+
+long PipelineStats::getCount(const std::string& name)
+{
+    std::vector<std::pair<std::string, long> >::iterator count_iter = findCount(name);
+    return (count_iter == PS_Counts.end()) ? 0 : count_iter->second;
+}
+
+void PipelineStats::setRate(const std::string& name, double value)
+{
+    std::vector<std::pair<std::string, double> >::iterator rate_iter;
+    for (rate_iter = PS_Rates.begin(); rate_iter != PS_Rates.end(); ++rate_iter) 
+    {
+        if (rate_iter->first == name) 
+        {
+            rate_iter->second = value;
+            return;
+        }
+    }
+    PS_Rates.push_back(std::pair<std::string, double>(name, value));
+}
+
+bool PipelineStats::writeJson(const std::string& fileName)
+{
+    std::ofstream out(fileName.c_str());
+    if (! out.good()) 
+    {
+        return false;
+    }
+    out<<"{"<<std::endl;
+    out<<"  \"total_wall_seconds\": "<<wallSeconds() - PS_WallStart<<","<<std::endl;
+    out<<"  \"total_cpu_seconds\": "<<cpuSeconds()<<","<<std::endl;
+    out<<"  \"peak_rss_kb\": "<<peakRssKb()<<","<<std::endl;
+    out<<"  \"stages\": ["<<std::endl;
+    for (size_t i = 0; i < PS_Stages.size(); i++) 
+    {
+        out<<"    {\"name\": "<<jsonString(PS_Stages[i].name)
+           <<", \"wall_seconds\": "<<PS_Stages[i].wallSeconds
+           <<", \"cpu_seconds\": "<<PS_Stages[i].cpuSeconds
+           <<", \"peak_rss_kb\": "<<PS_Stages[i].peakRssKb<<"}";
+        out<<((i + 1 < PS_Stages.size()) ? "," : "")<<std::endl;
+    }
+    out<<"  ],"<<std::endl;
+    out<<"  \"counts\": {"<<std::endl;
+    for (size_t i = 0; i < PS_Counts.size(); i++) 
+    {
+        out<<"    "<<jsonString(PS_Counts[i].first)<<": "<<PS_Counts[i].second;
+        out<<((i + 1 < PS_Counts.size()) ? "," : "")<<std::endl;
+    }
+    out<<"  },"<<std::endl;
+    out<<"  \"rates\": {"<<std::endl;
+    for (size_t i = 0; i < PS_Rates.size(); i++) 
+    {
+        out<<"    "<<jsonString(PS_Rates[i].first)<<": "<<PS_Rates[i].second;
+        out<<((i + 1 < PS_Rates.size()) ? "," : "")<<std::endl;
+    }
+    out<<"  }"<<std::endl;
+    out<<"}"<<std::endl;
+    return out.good();
+}
+
+bool PipelineStats::writeTable(const std::string& fileName, const std::string& delim)
+{
+    //-----
+    // one row per stage then one row per count or rate, 
+    // the columns that don't apply to them are left empty
+    //
+    std::ofstream out(fileName.c_str());
+    if (! out.good()) 
+    {
+        return false;
+    }
+    out<<"type"<<delim<<"name"<<delim<<"wall_seconds"<<delim<<"cpu_seconds"<<delim<<"peak_rss_kb"<<delim<<"value"<<std::endl;
+    for (size_t i = 0; i < PS_Stages.size(); i++) 
+    {
+        out<<"stage"<<delim<<PS_Stages[i].name<<delim<<PS_Stages[i].wallSeconds<<delim
+           <<PS_Stages[i].cpuSeconds<<delim<<PS_Stages[i].peakRssKb<<delim<<std::endl;
+    }
+    out<<"stage"<<delim<<"total"<<delim<<wallSeconds() - PS_WallStart<<delim
+       <<cpuSeconds()<<delim<<peakRssKb()<<delim<<std::endl;
+    for (size_t i = 0; i < PS_Counts.size(); i++) 
+    {
+        out<<"count"<<delim<<PS_Counts[i].first<<delim<<delim<<delim<<delim<<PS_Counts[i].second<<std::endl;
+    }
+    for (size_t i = 0; i < PS_Rates.size(); i++) 
+    {
+        out<<"rate"<<delim<<PS_Rates[i].first<<delim<<delim<<delim<<delim<<PS_Rates[i].second<<std::endl;
+    }
+    return out.good();
+}
@@ -0,0 +1,98 @@
+// File: PipelineStats.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Wall time, cpu time and peak memory for each stage of the crass
+// pipeline along with counts of what went in and came out of them. 
+// Written out as JSON and as a delimited table when a stats report 
+// has been asked for.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef PipelineStats_h
+#define PipelineStats_h
+
+// system includes
+#include <string>
+#include <vector>
+#include <utility>
+
+class PipelineStats
+{
+    public:
+        PipelineStats(void);
+        ~PipelineStats(void) {}
+
+        // stages are timed from startStage to endStage, they can't be nested
+        void startStage(const std::string& name);
+        void endStage(void);
+
+        // a stage that was timed somewhere else, like one whose work was
+        // spread over a thread pool and added up once the pool was done
+        void addStage(const std::string& name, double wallSeconds, double cpuSeconds);
+
+        // clocks for timing work on a thread of its own
+        static double wallClock(void);
+        static double threadCpuClock(void);       // cpu used by the calling thread only
+
+        // counts are reported in the order they were first set
+        void setCount(const std::string& name, long value);
+        void addCount(const std::string& name, long value);
+        long getCount(const std::string& name);
+
+        // fractions, reported after the counts
+        void setRate(const std::string& name, double value);
+
+        bool writeJson(const std::string& fileName);
+        bool writeTable(const std::string& fileName, const std::string& delim);
+
+    private:
+        typedef struct {
+            std::string name;
+            double wallSeconds;
+            double cpuSeconds;                  // user + system over all threads
+            long peakRssKb;                     // high water mark of the whole process at the end of the stage
+        } Stage;
+
+        std::vector<std::pair<std::string, long> >::iterator findCount(const std::string& name);
+
+        // members
+        std::vector<Stage> PS_Stages;
+        std::vector<std::pair<std::string, long> > PS_Counts;
+        std::vector<std::pair<std::string, double> > PS_Rates;
+        std::string PS_CurrentStage;            // empty when no stage is running
+        double PS_StageWallStart;
+        double PS_StageCpuStart;
+        double PS_WallStart;                    // when the stats were created
+};
+
+#endif //PipelineStats_h
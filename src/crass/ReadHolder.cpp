@@ -596,7 +596,7 @@ void ReadHolder::reverseComplementSeq(void)
     // Reverse complement the read and fix the start stops
     // 
 
-    RH_Seq = reverseComplement(RH_Seq);
+    reverseComplementInPlace(RH_Seq);
 	if(RH_Seq.empty()) {
 		throw crispr::runtime_exception(__FILE__,
 		                                __LINE__,
@@ -799,7 +799,7 @@ bool ReadHolder::getNextDR(std::string * retStr)
     int dist = end_cut - start_cut;
     if(0 != dist)
     {
-        *retStr = RH_Seq.substr(start_cut, dist + 1);
+        retStr->assign(RH_Seq, start_cut, dist + 1);
         RH_LastDREnd+=2;
         return true;
     }
@@ -852,7 +852,7 @@ bool ReadHolder::getNextSpacer(std::string * retStr)
     		// read starts with a spacer
     		// the next spacer starts after the first DR
             try {
-                *retStr = RH_Seq.substr(0, *ss_iter);
+                retStr->assign(RH_Seq, 0, *ss_iter);
             } catch (std::out_of_range& e) {
                 throw crispr::substring_exception(e.what(), RH_Seq.c_str(), 0, *ss_iter, __FILE__, __LINE__, __PRETTY_FUNCTION__);
             }
@@ -867,7 +867,7 @@ bool ReadHolder::getNextSpacer(std::string * retStr)
     		if(ss_iter < RH_StartStops.end())
     		{
                 try {
-                    *retStr = RH_Seq.substr(start_cut, *ss_iter - start_cut);
+                    retStr->assign(RH_Seq, start_cut, *ss_iter - start_cut);
                 } catch (std::out_of_range& e) {
                     throw crispr::substring_exception(e.what(), RH_Seq.c_str(), start_cut, (*ss_iter - start_cut), __FILE__, __LINE__, __PRETTY_FUNCTION__);
                 }
@@ -877,7 +877,7 @@ bool ReadHolder::getNextSpacer(std::string * retStr)
                 // only one DR in thie whole guy!
                 try {
                     
-                    *retStr = RH_Seq.substr(start_cut, RH_Seq.length() - start_cut);
+                    retStr->assign(RH_Seq, start_cut, RH_Seq.length() - start_cut);
                 } catch (std::exception& e) {
                     throw crispr::substring_exception(e.what(), RH_Seq.c_str(), start_cut, (int)(RH_Seq.length() - start_cut), __FILE__, __LINE__, __PRETTY_FUNCTION__);
 
@@ -900,7 +900,7 @@ bool ReadHolder::getNextSpacer(std::string * retStr)
             {
             	// read ends with a spacer
                 try {
-                    *retStr = RH_Seq.substr(*ss_iter + 1);
+                    retStr->assign(RH_Seq, *ss_iter + 1, std::string::npos);
                     RH_NextSpacerStart+=2;
                     return true;
                 } catch (std::exception& e) {
@@ -933,7 +933,7 @@ bool ReadHolder::getNextSpacer(std::string * retStr)
             ss_iter++;
     		int length = *ss_iter - start_cut;
             try {
-                *retStr = RH_Seq.substr(start_cut, length);
+                retStr->assign(RH_Seq, start_cut, length);
     		    RH_NextSpacerStart += 2;
                 return true;
             } catch (std::exception& e) {
@@ -132,16 +132,27 @@ class ReadHolder
             RH_IsFasta = false;
         }
 
+        // get ready to hold the next read from a file. Unlike clear() 
+        // this leaves the holder as if it was newly made, but the memory
+        // held by the strings is kept so that reading into it again
+        // doesn't allocate anything
+        void reuse(void)
+        {
+            clear();
+            RH_LastDREnd = 0;
+            RH_RepeatLength = 0;
+            RH_IsFasta = true;
+        }
 
     
         //----
         // Getters
         //
-        inline std::string getComment(void)
+        inline const std::string& getComment(void)
         {
             return this->RH_Comment;
         }
-        inline std::string getQual(void)
+        inline const std::string& getQual(void)
         {
             return this->RH_Qual;
         }
@@ -149,17 +160,17 @@ class ReadHolder
         {
             return this->RH_IsFasta;
         }
-        inline std::string getSeq(void)
+        inline const std::string& getSeq(void)
         {
             return this->RH_Seq;
         }
     
-        inline std::string getHeader(void)
+        inline const std::string& getHeader(void)
         {
             return this->RH_Header;
         }
         
-        inline std::string getSeqRle(void)
+        inline const std::string& getSeqRle(void)
         {
             return this->RH_Rle;
         }
@@ -174,7 +185,7 @@ class ReadHolder
             return this->RH_isSqueezed;
         }
         
-        inline StartStopList getStartStopList(void)
+        inline const StartStopList& getStartStopList(void)
         {
             return this->RH_StartStops;
         }
@@ -269,16 +280,30 @@ class ReadHolder
         {
             RH_Comment = _comment;
         }
+        inline void setComment(const char * _comment)
+        {
+            RH_Comment.assign(_comment);
+        }
         inline void setQual(std::string _qual)
         {
             RH_Qual = _qual;
             RH_IsFasta = false;
         }
+        inline void setQual(const char * _qual)
+        {
+            RH_Qual.assign(_qual);
+            RH_IsFasta = false;
+        }
         inline void setSequence(std::string _sequence)
         {
             RH_RepeatLength = 0;
             RH_Seq = _sequence;
         }
+        inline void setSequence(const char * _sequence)
+        {
+            RH_RepeatLength = 0;
+            RH_Seq.assign(_sequence);
+        }
 
         inline void setRepeatLength(int length)
         {
@@ -299,6 +324,10 @@ class ReadHolder
         {
             this->RH_Header = h;
         }
+        inline void setHeader(const char * h)
+        {
+            this->RH_Header.assign(h);
+        }
         
         inline void setDRLowLexi(bool b)
         {
@@ -436,6 +465,9 @@ class ReadHolder
         inline std::ostream& print(std::ostream& s);
     
     private:
+        // packs and unpacks the members directly
+        friend class ReadStore;
+
         // members
         std::string RH_Rle;                     // Run length encoded string
         std::string RH_Header;                  // Header for the sequence
@@ -0,0 +1,773 @@
+// File: ReadStore.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of ReadStore functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+
+// system includes
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// local includes
+#include "ReadStore.h"
+#include "Exception.h"
+
+// blocks start small as the stores used by the search threads only hold a few reads
+#define ST_MIN_BLOCK_SIZE (1 << 16)
+#define ST_MAX_BLOCK_SIZE (1 << 22)
+
+// the spill file is mapped back in this much at a time, so even a very
+// big spill only takes a few of the mappings the system allows
+#define ST_SPILL_WINDOW_SIZE (static_cast<size_t>(1) << 28)
+
+// flags
+#define ST_IS_FASTA         (1)
+#define ST_WAS_LOW_LEXI     (2)
+#define ST_WIDE_START_STOPS (4)             // start stops didn't fit in 16 bits
+
+// each non ACGT base is its position then the base
+#define ST_EXCEPTION_SIZE (5)
+
+// the lookup for copies of reads starts small like the blocks
+#define ST_MIN_DEDUP_SLOTS (1024)
+
+#define ST_U64(high, low) ((static_cast<uint64_t>(high) << 32) | static_cast<uint64_t>(low))
+
+static inline int storeBaseCode(char base)
+{
+    switch (base) 
+    {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default: return -1;
+    }
+}
+
+// the four bases in each possible packed byte
+class UnpackTable
+{
+    public:
+        UnpackTable(void)
+        {
+            const char bases[] = "ACGT";
+            for (int i = 0; i < 256; i++) 
+            {
+                for (int j = 0; j < 4; j++) 
+                {
+                    UT_Bases[i][j] = bases[(i >> (2 * j)) & 3];
+                }
+            }
+        }
+        char UT_Bases[256][4];
+};
+static const UnpackTable unpackTable;
+
+static inline void putWord(unsigned char * out, unsigned int value, unsigned int width)
+{
+    for (unsigned int i = 0; i < width; i++) 
+    {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+static inline unsigned int getWord(const unsigned char * in, unsigned int width)
+{
+    unsigned int value = 0;
+    for (unsigned int i = 0; i < width; i++) 
+    {
+        value |= static_cast<unsigned int>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+ReadStore::ReadStore(void)
+{
+    ST_BlockUsed = 0;
+    ST_MemoryLimit = 0;
+    ST_ResidentBytes = 0;
+    ST_SpilledBytes = 0;
+    ST_SpillFile = -1;
+    ST_SpillFileSize = 0;
+    ST_Dedup = false;
+    ST_NumDedupReads = 0;
+    ST_DuplicateHeaderBytes = 0;
+    ST_NumDuplicates = 0;
+    pthread_rwlock_init(&ST_Lock, NULL);
+}
+
+ReadStore::~ReadStore(void)
+{
+    clear();
+    if (ST_SpillFile != -1) 
+    {
+        close(ST_SpillFile);
+    }
+    pthread_rwlock_destroy(&ST_Lock);
+}
+
+void ReadStore::setMemoryLimit(size_t limit, const std::string& fileName)
+{
+    ST_MemoryLimit = limit;
+    if (limit == 0 || ST_SpillFile != -1) 
+    {
+        return;
+    }
+    ST_SpillFile = open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (ST_SpillFile == -1) 
+    {
+        throw crispr::runtime_exception(__FILE__, 
+                                        __LINE__, 
+                                        __PRETTY_FUNCTION__, 
+                                        ("Cannot open " + fileName + " to spill reads to: " + strerror(errno)).c_str());
+    }
+    // the mapping keeps the file alive for as long as we need it
+    unlink(fileName.c_str());
+}
+
+void ReadStore::setDeduplicate(bool dedup)
+{
+    ST_Dedup = dedup;
+    std::vector<DedupSlot>().swap(ST_DedupSlots);
+    ST_NumDedupReads = 0;
+    if (! dedup) 
+    {
+        return;
+    }
+    makeDedupSlots(ST_MIN_DEDUP_SLOTS);
+    // reads added before now can still be copied
+    for (size_t i = 0; i < ST_Records.size(); i++) 
+    {
+        const Record& record = ST_Records[i];
+        uint64_t print = fingerprint(record);
+        size_t slot = findDedupSlot(record, print);
+        if (ST_DedupSlots[slot].index != 0) 
+        {
+            continue;
+        }
+        if (2 * (ST_NumDedupReads + 1) > ST_DedupSlots.size()) 
+        {
+            makeDedupSlots(ST_DedupSlots.size() * 2);
+            slot = findDedupSlot(record, print);
+        }
+        ST_DedupSlots[slot].fingerprint = print;
+        ST_DedupSlots[slot].index = static_cast<ReadIndex>(i + 1);
+        ST_NumDedupReads++;
+    }
+}
+
+unsigned int ReadStore::packedSize(ReadHolder& read, Record& record) const
+{
+    record.seqLength = static_cast<unsigned int>(read.RH_Seq.length());
+    record.headerLength = static_cast<unsigned int>(read.RH_Header.length());
+    record.commentLength = static_cast<unsigned int>(read.RH_Comment.length());
+#ifdef OUTPUT_READS_FASTQ
+    record.qualLength = static_cast<unsigned int>(read.RH_Qual.length());
+#else
+    // never written out so don't keep it
+    record.qualLength = 0;
+#endif
+    record.numStartStops = static_cast<unsigned int>(read.RH_StartStops.size());
+    record.repeatLength = read.RH_RepeatLength;
+    record.flags = 0;
+    if (read.RH_IsFasta) 
+    {
+        record.flags |= ST_IS_FASTA;
+    }
+    if (read.RH_WasLowLexi) 
+    {
+        record.flags |= ST_WAS_LOW_LEXI;
+    }
+    if (read.RH_isSqueezed) 
+    {
+        // the run length encoding is not packed, nothing squeezes 
+        // reads before they are stored so don't bother
+        throw crispr::exception(__FILE__, 
+                                __LINE__, 
+                                __PRETTY_FUNCTION__, 
+                                "Cannot store a squeezed read");
+    }
+    StartStopListIterator ss_iter;
+    for (ss_iter = read.RH_StartStops.begin(); ss_iter != read.RH_StartStops.end(); ++ss_iter) 
+    {
+        if (*ss_iter > 0xFFFF) 
+        {
+            record.flags |= ST_WIDE_START_STOPS;
+            break;
+        }
+    }
+    record.numExceptions = 0;
+    for (unsigned int i = 0; i < record.seqLength; i++) 
+    {
+        if (storeBaseCode(read.RH_Seq[i]) < 0) 
+        {
+            record.numExceptions++;
+        }
+    }
+    unsigned int start_stop_width = (record.flags & ST_WIDE_START_STOPS) ? 4 : 2;
+    return record.numStartStops * start_stop_width + 
+           (record.seqLength + 3) / 4 + 
+           record.numExceptions * ST_EXCEPTION_SIZE + 
+           record.headerLength + 
+           record.commentLength + 
+           record.qualLength;
+}
+
+void ReadStore::pack(ReadHolder& read, const Record& record, unsigned char * packed) const
+{
+    //-----
+    // start stops, then the bases, then the exceptions, then the text
+    //
+    unsigned int start_stop_width = (record.flags & ST_WIDE_START_STOPS) ? 4 : 2;
+    for (unsigned int i = 0; i < record.numStartStops; i++) 
+    {
+        putWord(packed, read.RH_StartStops[i], start_stop_width);
+        packed += start_stop_width;
+    }
+    
+    const char * seq = read.RH_Seq.data();
+    unsigned char * exceptions = packed + (record.seqLength + 3) / 4;
+    for (unsigned int i = 0; i < record.seqLength; i += 4) 
+    {
+        unsigned char byte = 0;
+        for (unsigned int j = 0; j < 4 && i + j < record.seqLength; j++) 
+        {
+            int code = storeBaseCode(seq[i + j]);
+            if (code < 0) 
+            {
+                putWord(exceptions, i + j, 4);
+                exceptions[4] = static_cast<unsigned char>(seq[i + j]);
+                exceptions += ST_EXCEPTION_SIZE;
+                code = 0;
+            }
+            byte |= static_cast<unsigned char>(code << (2 * j));
+        }
+        *packed++ = byte;
+    }
+    packed = exceptions;
+    
+    memcpy(packed, read.RH_Header.data(), record.headerLength);
+    packed += record.headerLength;
+    memcpy(packed, read.RH_Comment.data(), record.commentLength);
+    packed += record.commentLength;
+    memcpy(packed, read.RH_Qual.data(), record.qualLength);
+}
+
+unsigned char * ReadStore::allocate(unsigned int size, Record& record)
+{
+    if (ST_Blocks.empty() || ST_Blocks.back().size - ST_BlockUsed < size) 
+    {
+        size_t block_size = (ST_Blocks.empty()) ? ST_MIN_BLOCK_SIZE : ST_Blocks.back().size * 2;
+        if (block_size > ST_MAX_BLOCK_SIZE) 
+        {
+            block_size = ST_MAX_BLOCK_SIZE;
+        }
+        if (ST_MemoryLimit > 0 && block_size > ST_MemoryLimit / 4 && block_size > ST_MIN_BLOCK_SIZE) 
+        {
+            // a few blocks have to fit under the limit
+            block_size = (ST_MemoryLimit / 4 > ST_MIN_BLOCK_SIZE) ? ST_MemoryLimit / 4 : ST_MIN_BLOCK_SIZE;
+        }
+        if (block_size < size) 
+        {
+            block_size = size;
+        }
+        if (ST_MemoryLimit > 0 && ST_ResidentBytes + block_size > ST_MemoryLimit) 
+        {
+            // nothing more goes into the blocks we have
+            spill();
+        }
+        Block block;
+        block.data = static_cast<unsigned char *>(malloc(block_size));
+        if (block.data == NULL) 
+        {
+            throw crispr::runtime_exception(__FILE__, 
+                                            __LINE__, 
+                                            __PRETTY_FUNCTION__, 
+                                            "Out of memory storing reads");
+        }
+        block.size = block_size;
+        block.spilled = false;
+        ST_Blocks.push_back(block);
+        ST_ResidentBytes += block_size;
+        ST_BlockUsed = 0;
+    }
+    record.block = static_cast<unsigned int>(ST_Blocks.size() - 1);
+    record.offset = static_cast<unsigned int>(ST_BlockUsed);
+    record.capacity = size;
+    ST_BlockUsed += size;
+    // a zero length read still needs somewhere valid to point
+    return (size > 0) ? ST_Blocks.back().data + record.offset : NULL;
+}
+
+void ReadStore::spill(void)
+{
+    //-----
+    // Each block goes on the end of the file and is read back through
+    // a shared mapping of the window it landed in, so reads can still be
+    // updated in place and the system is free to drop the pages once 
+    // they are written out
+    //
+    std::vector<Block>::iterator block_iter;
+    for (block_iter = ST_Blocks.begin(); block_iter != ST_Blocks.end(); ++block_iter) 
+    {
+        if (block_iter->spilled) 
+        {
+            continue;
+        }
+        off_t offset;
+        unsigned char * mapped = spillSpace(block_iter->size, offset);
+        size_t written = 0;
+        while (written < block_iter->size) 
+        {
+            ssize_t ret = pwrite(ST_SpillFile, block_iter->data + written, block_iter->size - written, offset + written);
+            if (ret < 0 && errno == EINTR) 
+            {
+                continue;
+            }
+            if (ret <= 0) 
+            {
+                throw crispr::runtime_exception(__FILE__, 
+                                                __LINE__, 
+                                                __PRETTY_FUNCTION__, 
+                                                (std::string("Cannot spill reads: ") + strerror(errno)).c_str());
+            }
+            written += ret;
+        }
+        free(block_iter->data);
+        block_iter->data = mapped;
+        block_iter->spilled = true;
+        ST_SpillFileSize = offset + block_iter->size;
+        ST_ResidentBytes -= block_iter->size;
+        ST_SpilledBytes += block_iter->size;
+    }
+}
+
+unsigned char * ReadStore::spillSpace(size_t size, off_t& offset)
+{
+    if (! ST_SpillWindows.empty()) 
+    {
+        const SpillWindow& window = ST_SpillWindows.back();
+        if (ST_SpillFileSize + static_cast<off_t>(size) <= window.offset + static_cast<off_t>(window.size)) 
+        {
+            offset = ST_SpillFileSize;
+            return window.data + (offset - window.offset);
+        }
+    }
+    
+    //-----
+    // map the next window from the end of the file, only the parts that
+    // have been written are ever looked at. A block too big for a window
+    // gets one of its own
+    //
+    off_t page_size = sysconf(_SC_PAGESIZE);
+    SpillWindow window;
+    window.offset = (ST_SpillFileSize + page_size - 1) / page_size * page_size;
+    window.size = (size > ST_SPILL_WINDOW_SIZE) ? size : ST_SPILL_WINDOW_SIZE;
+    void * mapped = mmap(NULL, window.size, PROT_READ | PROT_WRITE, MAP_SHARED, ST_SpillFile, window.offset);
+    if (mapped == MAP_FAILED) 
+    {
+        throw crispr::runtime_exception(__FILE__, 
+                                        __LINE__, 
+                                        __PRETTY_FUNCTION__, 
+                                        (std::string("Cannot map spilled reads: ") + strerror(errno)).c_str());
+    }
+    window.data = static_cast<unsigned char *>(mapped);
+    ST_SpillWindows.push_back(window);
+    offset = window.offset;
+    return window.data;
+}
+
+ReadIndex ReadStore::add(ReadHolder& read, bool * duplicate)
+{
+    Record record;
+    unsigned int size = packedSize(read, record);
+    unsigned char * packed = allocate(size, record);
+    if (packed != NULL) 
+    {
+        pack(read, record, packed);
+    }
+    record.multiplicity = 1;
+    return keep(record, std::vector<std::string>(), duplicate);
+}
+
+ReadIndex ReadStore::add(const ReadStore& other, ReadIndex index, bool * duplicate)
+{
+    Record record = other.ST_Records.at(index);
+    unsigned int size = record.capacity;
+    const unsigned char * from = (size > 0) ? other.packedRead(record) : NULL;
+    unsigned char * packed = allocate(size, record);
+    if (packed != NULL) 
+    {
+        memcpy(packed, from, size);
+    }
+    std::vector<std::string> copies;
+    other.getDuplicateHeaders(index, copies);
+    return keep(record, copies, duplicate);
+}
+
+ReadIndex ReadStore::keep(Record& record, const std::vector<std::string>& copies, bool * duplicate)
+{
+    if (duplicate != NULL) 
+    {
+        *duplicate = false;
+    }
+    size_t slot = 0;
+    uint64_t print = 0;
+    if (ST_Dedup) 
+    {
+        print = fingerprint(record);
+        slot = findDedupSlot(record, print);
+        if (ST_DedupSlots[slot].index != 0) 
+        {
+            ReadIndex first = ST_DedupSlots[slot].index - 1;
+            std::vector<std::string>& headers = ST_DuplicateHeaders[first];
+            headers.push_back(packedHeader(record));
+            ST_DuplicateHeaderBytes += headers.back().length() + sizeof(std::string);
+            std::vector<std::string>::const_iterator copy_iter;
+            for (copy_iter = copies.begin(); copy_iter != copies.end(); ++copy_iter) 
+            {
+                headers.push_back(*copy_iter);
+                ST_DuplicateHeaderBytes += copy_iter->length() + sizeof(std::string);
+            }
+            ST_Records[first].multiplicity += record.multiplicity;
+            ST_NumDuplicates += record.multiplicity;
+            // nothing has been allocated since so the space can go back
+            ST_BlockUsed -= record.capacity;
+            if (duplicate != NULL) 
+            {
+                *duplicate = true;
+            }
+            return first;
+        }
+    }
+
+    ReadIndex index = static_cast<ReadIndex>(ST_Records.size());
+    ST_Records.push_back(record);
+    if (! copies.empty()) 
+    {
+        ST_DuplicateHeaders[index] = copies;
+        std::vector<std::string>::const_iterator copy_iter;
+        for (copy_iter = copies.begin(); copy_iter != copies.end(); ++copy_iter) 
+        {
+            ST_DuplicateHeaderBytes += copy_iter->length() + sizeof(std::string);
+        }
+        ST_NumDuplicates += copies.size();
+    }
+    if (ST_Dedup) 
+    {
+        if (2 * (ST_NumDedupReads + 1) > ST_DedupSlots.size()) 
+        {
+            makeDedupSlots(ST_DedupSlots.size() * 2);
+            slot = findDedupSlot(record, print);
+        }
+        ST_DedupSlots[slot].fingerprint = print;
+        ST_DedupSlots[slot].index = index + 1;
+        ST_NumDedupReads++;
+    }
+    return index;
+}
+
+void ReadStore::update(ReadIndex index, ReadHolder& read)
+{
+    //-----
+    // written back over the old copy when it fits, which it nearly always 
+    // does as reads are only ever reverse complemented or have their 
+    // start stops moved about. That only touches this read, moving it 
+    // can add or spill blocks so everyone else has to wait
+    //
+    if (ST_Dedup) 
+    {
+        // the lookup would no longer find the read
+        throw crispr::exception(__FILE__, 
+                                __LINE__, 
+                                __PRETTY_FUNCTION__, 
+                                "Cannot update a read while deduplicating");
+    }
+    Record updated = ST_Records.at(index);
+    unsigned int size = packedSize(read, updated);
+    bool fits = (size <= updated.capacity);
+    if (fits) 
+    {
+        pthread_rwlock_rdlock(&ST_Lock);
+    } 
+    else 
+    {
+        pthread_rwlock_wrlock(&ST_Lock);
+    }
+    unsigned char * packed;
+    if (fits) 
+    {
+        packed = (size > 0) ? ST_Blocks[updated.block].data + updated.offset : NULL;
+    } 
+    else 
+    {
+        try {
+            packed = allocate(size, updated);
+        } catch (crispr::exception& e) {
+            pthread_rwlock_unlock(&ST_Lock);
+            throw;
+        }
+    }
+    if (packed != NULL) 
+    {
+        pack(read, updated, packed);
+    }
+    ST_Records[index] = updated;
+    pthread_rwlock_unlock(&ST_Lock);
+}
+
+void ReadStore::get(ReadIndex index, ReadHolder& read) const
+{
+    const Record& record = ST_Records.at(index);
+    pthread_rwlock_rdlock(&ST_Lock);
+    unpack(record, read);
+    pthread_rwlock_unlock(&ST_Lock);
+}
+
+void ReadStore::unpack(const Record& record, ReadHolder& read) const
+{
+    read.reuse();
+    read.RH_IsFasta = (record.flags & ST_IS_FASTA) != 0;
+    read.RH_WasLowLexi = (record.flags & ST_WAS_LOW_LEXI) != 0;
+    read.RH_RepeatLength = record.repeatLength;
+    if (record.capacity == 0) 
+    {
+        return;
+    }
+    const unsigned char * packed = packedRead(record);
+    
+    unsigned int start_stop_width = (record.flags & ST_WIDE_START_STOPS) ? 4 : 2;
+    read.RH_StartStops.resize(record.numStartStops);
+    for (unsigned int i = 0; i < record.numStartStops; i++) 
+    {
+        read.RH_StartStops[i] = getWord(packed, start_stop_width);
+        packed += start_stop_width;
+    }
+    
+    read.RH_Seq.resize(record.seqLength);
+    unsigned int full_bytes = record.seqLength / 4;
+    for (unsigned int i = 0; i < full_bytes; i++) 
+    {
+        memcpy(&(read.RH_Seq[4 * i]), unpackTable.UT_Bases[packed[i]], 4);
+    }
+    for (unsigned int i = 4 * full_bytes; i < record.seqLength; i++) 
+    {
+        read.RH_Seq[i] = unpackTable.UT_Bases[packed[full_bytes]][i - 4 * full_bytes];
+    }
+    packed += (record.seqLength + 3) / 4;
+    for (unsigned int i = 0; i < record.numExceptions; i++) 
+    {
+        read.RH_Seq[getWord(packed, 4)] = static_cast<char>(packed[4]);
+        packed += ST_EXCEPTION_SIZE;
+    }
+    
+    read.RH_Header.assign(reinterpret_cast<const char *>(packed), record.headerLength);
+    packed += record.headerLength;
+    read.RH_Comment.assign(reinterpret_cast<const char *>(packed), record.commentLength);
+    packed += record.commentLength;
+    read.RH_Qual.assign(reinterpret_cast<const char *>(packed), record.qualLength);
+}
+
+std::string ReadStore::getHeader(ReadIndex index) const
+{
+    const Record& record = ST_Records.at(index);
+    pthread_rwlock_rdlock(&ST_Lock);
+    std::string header = packedHeader(record);
+    pthread_rwlock_unlock(&ST_Lock);
+    return header;
+}
+
+void ReadStore::getDuplicateHeaders(ReadIndex index, std::vector<std::string>& headers) const
+{
+    headers.clear();
+    if (ST_Records.at(index).multiplicity == 1) 
+    {
+        // most reads have no copies, don't go looking
+        return;
+    }
+    std::map<ReadIndex, std::vector<std::string> >::const_iterator dup_iter = ST_DuplicateHeaders.find(index);
+    if (dup_iter != ST_DuplicateHeaders.end()) 
+    {
+        headers = dup_iter->second;
+    }
+}
+
+std::string ReadStore::packedHeader(const Record& record) const
+{
+    if (record.headerLength == 0) 
+    {
+        return std::string();
+    }
+    const unsigned char * header = packedRead(record) + packedBasesSize(record);
+    return std::string(reinterpret_cast<const char *>(header), record.headerLength);
+}
+
+unsigned int ReadStore::packedBasesSize(const Record& record) const
+{
+    unsigned int start_stop_width = (record.flags & ST_WIDE_START_STOPS) ? 4 : 2;
+    return record.numStartStops * start_stop_width + 
+           (record.seqLength + 3) / 4 + 
+           record.numExceptions * ST_EXCEPTION_SIZE;
+}
+
+uint64_t ReadStore::fingerprint(const Record& record) const
+{
+    //-----
+    // FNV-1a over the packed bases with the murmur3 finaliser, the 
+    // same as the header fingerprints
+    //
+    uint64_t hash = ST_U64(0xcbf29ce4U, 0x84222325U);
+    hash ^= record.seqLength;
+    hash *= ST_U64(0x00000100U, 0x000001b3U);
+    unsigned int size = packedBasesSize(record);
+    const unsigned char * packed = (size > 0) ? packedRead(record) : NULL;
+    for (unsigned int i = 0; i < size; i++) 
+    {
+        hash ^= packed[i];
+        hash *= ST_U64(0x00000100U, 0x000001b3U);
+    }
+    hash ^= hash >> 33;
+    hash *= ST_U64(0xff51afd7U, 0xed558ccdU);
+    hash ^= hash >> 33;
+    hash *= ST_U64(0xc4ceb9feU, 0x1a85ec53U);
+    hash ^= hash >> 33;
+    return hash;
+}
+
+size_t ReadStore::findDedupSlot(const Record& record, uint64_t print) const
+{
+    //-----
+    // linear probing, the table is never more than half full. Reads 
+    // with the same fingerprint are checked byte for byte
+    //
+    size_t mask = ST_DedupSlots.size() - 1;
+    size_t slot = static_cast<size_t>(print) & mask;
+    unsigned int size = packedBasesSize(record);
+    while (ST_DedupSlots[slot].index != 0) 
+    {
+        if (ST_DedupSlots[slot].fingerprint == print) 
+        {
+            const Record& other = ST_Records[ST_DedupSlots[slot].index - 1];
+            if (other.seqLength == record.seqLength && 
+                other.numStartStops == record.numStartStops &&
+                other.numExceptions == record.numExceptions &&
+                other.repeatLength == record.repeatLength &&
+                other.flags == record.flags &&
+                (size == 0 || memcmp(packedRead(other), packedRead(record), size) == 0)) 
+            {
+                return slot;
+            }
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void ReadStore::makeDedupSlots(size_t numSlots)
+{
+    std::vector<DedupSlot> old_slots;
+    old_slots.swap(ST_DedupSlots);
+    DedupSlot empty;
+    empty.fingerprint = 0;
+    empty.index = 0;
+    ST_DedupSlots.assign(numSlots, empty);
+    size_t mask = numSlots - 1;
+    std::vector<DedupSlot>::iterator slot_iter;
+    for (slot_iter = old_slots.begin(); slot_iter != old_slots.end(); ++slot_iter) 
+    {
+        if (slot_iter->index == 0) 
+        {
+            continue;
+        }
+        size_t slot = static_cast<size_t>(slot_iter->fingerprint) & mask;
+        while (ST_DedupSlots[slot].index != 0) 
+        {
+            slot = (slot + 1) & mask;
+        }
+        ST_DedupSlots[slot] = *slot_iter;
+    }
+}
+
+size_t ReadStore::memoryUsage(void) const
+{
+    return ST_Records.capacity() * sizeof(Record) + 
+           ST_ResidentBytes + 
+           ST_DedupSlots.capacity() * sizeof(DedupSlot) + 
+           ST_DuplicateHeaderBytes;
+}
+
+void ReadStore::clear(void)
+{
+    std::vector<Block>::iterator block_iter;
+    for (block_iter = ST_Blocks.begin(); block_iter != ST_Blocks.end(); ++block_iter) 
+    {
+        if (! block_iter->spilled) 
+        {
+            free(block_iter->data);
+        }
+    }
+    std::vector<SpillWindow>::iterator window_iter;
+    for (window_iter = ST_SpillWindows.begin(); window_iter != ST_SpillWindows.end(); ++window_iter) 
+    {
+        munmap(window_iter->data, window_iter->size);
+    }
+    ST_SpillWindows.clear();
+    ST_Records.clear();
+    ST_Blocks.clear();
+    ST_BlockUsed = 0;
+    ST_ResidentBytes = 0;
+    ST_SpilledBytes = 0;
+    ST_DuplicateHeaders.clear();
+    ST_DuplicateHeaderBytes = 0;
+    ST_NumDuplicates = 0;
+    if (ST_Dedup) 
+    {
+        ST_DedupSlots.clear();
+        ST_NumDedupReads = 0;
+        makeDedupSlots(ST_MIN_DEDUP_SLOTS);
+    }
+    if (ST_SpillFile != -1 && ST_SpillFileSize > 0) 
+    {
+        if (ftruncate(ST_SpillFile, 0) == 0) 
+        {
+            ST_SpillFileSize = 0;
+        }
+    }
+}
@@ -0,0 +1,218 @@
+// File: ReadStore.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Holds every read that was recruited in a compact form. Sequences are
+// packed two bits to a base with a list of the positions that were not 
+// ACGT, and everything that belongs to a read is stored together in a 
+// few big blocks. Reads are referred to by their index and are unpacked
+// into a ReadHolder whenever they need to be worked on. Quality strings
+// are only kept when reads are written out as fastq.
+//
+// The store can be given a memory limit. Once the blocks go over it the
+// full ones are written out to a temporary file, which is mapped back
+// in a few big windows, so the system pages them in and out as the 
+// reads are used. The records saying where each read is always stay in
+// memory.
+//
+// Exact copies of a read can be folded together as they are added. Only
+// the first copy is packed, the others add to its count and leave their
+// header, which is still needed to say where each spacer came from.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef ReadStore_h
+#define ReadStore_h
+
+// system includes
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+// local includes
+#include "ReadHolder.h"
+
+// typedefs
+typedef unsigned int ReadIndex;
+
+class ReadStore
+{
+    public:
+        ReadStore(void);
+        ~ReadStore(void);
+
+        // keep at most about limit bytes of reads in memory, the rest go
+        // to fileName which is removed straight away so that nothing is 
+        // left behind. A limit of 0 keeps everything in memory
+        void setMemoryLimit(size_t limit, const std::string& fileName);
+
+        // while on, a read with the same bases and repeat positions as
+        // one already in the store is not packed again. It is folded into
+        // the first copy, which counts it and keeps its header. Reads 
+        // cannot be updated while this is on, turning it off frees the
+        // lookup but keeps the counts and headers
+        void setDeduplicate(bool dedup);
+
+        // pack a copy of the read, returns its index. If the read was
+        // folded into a copy duplicate is set and the copy's index is 
+        // returned
+        ReadIndex add(ReadHolder& read, bool * duplicate = NULL);
+
+        // copy a read from another store without unpacking it
+        ReadIndex add(const ReadStore& other, ReadIndex index, bool * duplicate = NULL);
+
+        // unpack a read. The holder is reused so reading lots of reads 
+        // into the same one does not allocate. Safe to call from many 
+        // threads at once as long as nothing is being added
+        void get(ReadIndex index, ReadHolder& read) const;
+
+        // store the changes made to a read after get. Threads can update
+        // different reads at once, and get others while they do
+        void update(ReadIndex index, ReadHolder& read);
+
+        std::string getHeader(ReadIndex index) const;
+
+        // the number of reads folded into this one, counting itself
+        inline unsigned int multiplicity(ReadIndex index) const { return ST_Records.at(index).multiplicity; }
+
+        // the headers of the reads folded into this one in the order
+        // they were added, headers is emptied first
+        void getDuplicateHeaders(ReadIndex index, std::vector<std::string>& headers) const;
+
+        // reads that were folded into a copy
+        inline size_t numDuplicates(void) const { return ST_NumDuplicates; }
+
+        inline size_t size(void) const { return ST_Records.size(); }
+
+        // bytes held by the store in memory
+        size_t memoryUsage(void) const;
+
+        // bytes of reads that are in the spill file
+        inline size_t spilledBytes(void) const { return ST_SpilledBytes; }
+
+        void clear(void);
+
+    private:
+        typedef struct {
+            unsigned int block;                 // where the packed read is in ST_Blocks
+            unsigned int offset;
+            unsigned int capacity;              // bytes set aside for it
+            unsigned int seqLength;
+            unsigned int headerLength;
+            unsigned int commentLength;
+            unsigned int qualLength;
+            unsigned int numExceptions;         // bases that are not ACGT
+            unsigned int numStartStops;
+            int repeatLength;
+            unsigned int multiplicity;
+            unsigned char flags;
+        } Record;
+
+        // bytes needed to pack the read, also fills in the lengths
+        unsigned int packedSize(ReadHolder& read, Record& record) const;
+        void pack(ReadHolder& read, const Record& record, unsigned char * packed) const;
+        void unpack(const Record& record, ReadHolder& read) const;
+
+        typedef struct {
+            unsigned char * data;
+            size_t size;
+            bool spilled;                       // data points into a window of the spill file
+        } Block;
+
+        typedef struct {
+            unsigned char * data;
+            off_t offset;                       // where the window starts in the spill file
+            size_t size;
+        } SpillWindow;
+
+        // set aside space for a read, fills in the block, offset and capacity
+        unsigned char * allocate(unsigned int size, Record& record);
+
+        // move every block that is in memory out to the spill file
+        void spill(void);
+
+        // where the next size bytes go in the spill file and where they 
+        // can be read back from, maps another window when the last is full
+        unsigned char * spillSpace(size_t size, off_t& offset);
+
+        inline const unsigned char * packedRead(const Record& record) const 
+        { 
+            return ST_Blocks[record.block].data + record.offset; 
+        }
+
+        std::string packedHeader(const Record& record) const;
+
+        // the start stops, bases and exceptions, which is all that two 
+        // copies of a read have to share
+        unsigned int packedBasesSize(const Record& record) const;
+
+        typedef struct {
+            uint64_t fingerprint;
+            ReadIndex index;                    // 1 + the index of the read, 0 is an empty slot
+        } DedupSlot;
+
+        // the read just packed into record goes in the store or, if it 
+        // is a copy, is folded into the first one and its space given back
+        ReadIndex keep(Record& record, const std::vector<std::string>& copies, bool * duplicate);
+
+        uint64_t fingerprint(const Record& record) const;
+
+        // the slot holding a copy of the read or the empty slot where it would go
+        size_t findDedupSlot(const Record& record, uint64_t print) const;
+        void makeDedupSlots(size_t numSlots);
+
+        ReadStore(const ReadStore&);
+        const ReadStore& operator=(const ReadStore&);
+
+        // members
+        std::vector<Record> ST_Records;
+        std::vector<Block> ST_Blocks;
+        size_t ST_BlockUsed;                    // bytes used in the last block
+        size_t ST_MemoryLimit;                  // 0 for no limit
+        size_t ST_ResidentBytes;                // bytes of blocks that are in memory
+        size_t ST_SpilledBytes;                 // bytes of blocks that are in the spill file
+        int ST_SpillFile;                       // -1 until there is a limit
+        off_t ST_SpillFileSize;
+        std::vector<SpillWindow> ST_SpillWindows;
+        bool ST_Dedup;
+        std::vector<DedupSlot> ST_DedupSlots;   // open addressing, always a power of 2 in size
+        size_t ST_NumDedupReads;                // slots in use
+        std::map<ReadIndex, std::vector<std::string> > ST_DuplicateHeaders;
+        size_t ST_DuplicateHeaderBytes;
+        size_t ST_NumDuplicates;
+        mutable pthread_rwlock_t ST_Lock;       // shared to read or update in place, exclusive to move a read
+};
+
+#endif //ReadStore_h
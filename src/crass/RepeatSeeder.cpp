@@ -0,0 +1,233 @@
+// File: RepeatSeeder.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of RepeatSeeder functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+// local includes
+#include "RepeatSeeder.h"
+#include "PatternMatcher.h"
+#include "crassDefines.h"
+#include "Exception.h"
+
+// two bits per base. Only upper case bases get a code as the 
+// Boyer-Moore search this replaces is case sensitive
+static inline int seederBaseCode(char base)
+{
+    switch (base) 
+    {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T': return 3;
+        default: return -1;
+    }
+}
+
+RepeatSeeder::RepeatSeeder(void)
+{
+    RS_Seq = NULL;
+    RS_SeqLength = 0;
+    RS_KmerLength = 0;
+}
+
+unsigned int RepeatSeeder::codeKmers(const char * seq, unsigned int seqLength, unsigned int kmerLength)
+{
+    if (kmerLength < 1 || kmerLength > CRASS_DEF_MAX_SEARCH_WINDOW_LENGTH) 
+    {
+        throw crispr::exception(__FILE__,
+                                __LINE__,
+                                __PRETTY_FUNCTION__,
+                                "kmer length is outside of the allowed search window lengths");
+    }
+    RS_Seq = seq;
+    RS_SeqLength = seqLength;
+    if (kmerLength != RS_KmerLength) 
+    {
+        RS_KmerLength = kmerLength;
+        RS_Heads.assign(1UL << (2 * kmerLength), -1);
+        RS_WindowCounts.assign(1UL << (2 * kmerLength), 0);
+    }
+    if (seqLength < kmerLength) 
+    {
+        RS_Codes.clear();
+        return 0;
+    }
+    unsigned int num_kmers = seqLength - kmerLength + 1;
+    RS_Codes.resize(num_kmers);
+
+    //-----
+    // roll the kmer codes along the read, anything that is not
+    // ACGT poisons the kmers that overlap it
+    //
+    unsigned int mask = (1U << (2 * kmerLength)) - 1;
+    unsigned int code = 0;
+    unsigned int valid_bases = 0;
+    for (unsigned int i = 0; i < seqLength; i++) 
+    {
+        int base = seederBaseCode(seq[i]);
+        if (base < 0) 
+        {
+            valid_bases = 0;
+            code = 0;
+        } 
+        else 
+        {
+            code = ((code << 2) | static_cast<unsigned int>(base)) & mask;
+            valid_bases++;
+        }
+        if (i + 1 >= kmerLength) 
+        {
+            RS_Codes[i + 1 - kmerLength] = (valid_bases >= kmerLength) ? static_cast<int>(code) : -1;
+        }
+    }
+    return num_kmers;
+}
+
+void RepeatSeeder::index(const char * seq, unsigned int seqLength, unsigned int kmerLength)
+{
+    unsigned int num_kmers = codeKmers(seq, seqLength, kmerLength);
+    RS_Next.resize(num_kmers);
+
+    //-----
+    // link each position to the next occurrence of its kmer
+    //
+    for (unsigned int i = num_kmers; i-- > 0; ) 
+    {
+        int kmer = RS_Codes[i];
+        if (kmer < 0) 
+        {
+            RS_Next[i] = -1;
+            continue;
+        }
+        RS_Next[i] = RS_Heads[kmer];
+        RS_Heads[kmer] = static_cast<int>(i);
+    }
+    
+    // only the entries for this read were touched so only they need resetting
+    for (unsigned int i = 0; i < num_kmers; i++) 
+    {
+        if (RS_Codes[i] >= 0) 
+        {
+            RS_Heads[RS_Codes[i]] = -1;
+        }
+    }
+}
+
+int RepeatSeeder::firstRepeat(unsigned int windowStart, unsigned int searchBegin, unsigned int searchEnd)
+{
+    if (searchEnd <= searchBegin || searchEnd - searchBegin < RS_KmerLength) 
+    {
+        return -1;
+    }
+    if (windowStart >= RS_Codes.size() || RS_Codes[windowStart] < 0) 
+    {
+        // this window can't be coded so fall back to a plain search
+        return PatternMatcher::exactSearch(RS_Seq + searchBegin, 
+                                           searchEnd - searchBegin, 
+                                           RS_Seq + windowStart, 
+                                           RS_KmerLength);
+    }
+    int pos = RS_Next[windowStart];
+    while (pos != -1 && static_cast<unsigned int>(pos) < searchBegin) 
+    {
+        pos = RS_Next[pos];
+    }
+    if (pos == -1 || static_cast<unsigned int>(pos) + RS_KmerLength > searchEnd) 
+    {
+        return -1;
+    }
+    return pos - static_cast<int>(searchBegin);
+}
+
+bool RepeatSeeder::mayRepeat(const char * seq, 
+                             unsigned int seqLength, 
+                             unsigned int kmerLength, 
+                             unsigned int windowStep, 
+                             unsigned int lastWindow, 
+                             unsigned int minGap, 
+                             unsigned int maxGap)
+{
+    unsigned int num_kmers = codeKmers(seq, seqLength, kmerLength);
+    if (windowStep < 1) 
+    {
+        windowStep = 1;
+    }
+    
+    //-----
+    // slide along the read keeping a count of the windows that 
+    // are between minGap and maxGap bases behind us. Windows join 
+    // the range at p - minGap and leave it after p - maxGap
+    //
+    bool found = false;
+    unsigned int windows_added = 0;     // windows below this position have been counted
+    unsigned int last_position = (lastWindow + maxGap < num_kmers) ? lastWindow + maxGap + 1 : num_kmers;
+    for (unsigned int p = minGap; p < last_position; p++) 
+    {
+        unsigned int joining = p - minGap;
+        if (joining <= lastWindow && joining % windowStep == 0) 
+        {
+            windows_added = joining + 1;
+            if (RS_Codes[joining] < 0) 
+            {
+                found = true;
+                break;
+            }
+            RS_WindowCounts[RS_Codes[joining]]++;
+        }
+        if (p > maxGap) 
+        {
+            unsigned int leaving = p - maxGap - 1;
+            if (leaving <= lastWindow && leaving % windowStep == 0 && RS_Codes[leaving] >= 0) 
+            {
+                RS_WindowCounts[RS_Codes[leaving]]--;
+            }
+        }
+        if (RS_Codes[p] >= 0 && RS_WindowCounts[RS_Codes[p]] > 0) 
+        {
+            found = true;
+            break;
+        }
+    }
+    
+    // put the table back the way we found it
+    for (unsigned int j = 0; j < windows_added; j += windowStep) 
+    {
+        if (RS_Codes[j] >= 0) 
+        {
+            RS_WindowCounts[RS_Codes[j]] = 0;
+        }
+    }
+    return found;
+}
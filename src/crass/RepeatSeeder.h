@@ -0,0 +1,94 @@
+// File: RepeatSeeder.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Finds the seeds for the CRT style repeat search in searchCore. Rather
+// than running a Boyer-Moore search for every window of the read, every
+// kmer of the read is indexed once and each position is linked to the 
+// next position holding the same kmer. Asking where a window turns up 
+// again further along the read is then a short walk down that chain.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef RepeatSeeder_h
+#define RepeatSeeder_h
+
+// system includes
+#include <vector>
+
+class RepeatSeeder
+{
+    public:
+        RepeatSeeder(void);
+        ~RepeatSeeder(void) {}
+
+        // index every kmer of seq, the sequence is not copied so it 
+        // must stay put until the next call to index
+        void index(const char * seq, unsigned int seqLength, unsigned int kmerLength);
+
+        // where the kmer starting at windowStart is next found in the 
+        // read between searchBegin and searchEnd. Gives the same answer as 
+        // PatternMatcher::bmpSearch(seq + searchBegin, searchEnd - searchBegin, seq + windowStart, kmerLength)
+        // so the result is an offset from searchBegin or -1 when there is no match
+        int firstRepeat(unsigned int windowStart, unsigned int searchBegin, unsigned int searchEnd);
+
+        // a cheap check that can be done before indexing. Returns false only 
+        // when none of the windows at 0, windowStep, ... lastWindow has a copy 
+        // starting between minGap and maxGap bases after it, so a read that 
+        // fails can't give firstRepeat a hit on any of those windows. Windows 
+        // that are not all ACGT always pass
+        bool mayRepeat(const char * seq, 
+                       unsigned int seqLength, 
+                       unsigned int kmerLength, 
+                       unsigned int windowStep, 
+                       unsigned int lastWindow, 
+                       unsigned int minGap, 
+                       unsigned int maxGap);
+
+    private:
+        // fill RS_Codes for seq, returns the number of kmers
+        unsigned int codeKmers(const char * seq, unsigned int seqLength, unsigned int kmerLength);
+
+        RepeatSeeder(const RepeatSeeder&);
+        const RepeatSeeder& operator=(const RepeatSeeder&);
+
+        // members
+        const char * RS_Seq;
+        unsigned int RS_SeqLength;
+        unsigned int RS_KmerLength;
+        std::vector<int> RS_Codes;          // the 2-bit code of the kmer at each position, -1 if it is not all ACGT
+        std::vector<int> RS_Next;           // the next position with the same kmer, -1 if there isn't one
+        std::vector<int> RS_Heads;          // 4^k table only used while indexing, always left full of -1
+        std::vector<unsigned short> RS_WindowCounts;    // 4^k table of the windows in range for mayRepeat, always left full of 0
+};
+
+#endif //RepeatSeeder_h
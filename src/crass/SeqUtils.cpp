@@ -59,31 +59,28 @@ char comp_tab[] = {
 	'p', 'q', 'y', 's', 'a', 'a', 'b', 'w', 'x', 'r', 'z', 123, 124, 125, 126, 127
 };
 
-std::string reverseComplement(std::string str)
+std::string reverseComplement(const std::string& str)
 {
+    std::string ret(str);
+    reverseComplementInPlace(ret);
+    return ret;
+}
 
+void reverseComplementInPlace(std::string& str)
+{
 	int l = static_cast<int>(str.length());
-    char * revcomp_str = new char[l+1];
-    for (int i = 0; i <=l; i++) {
-		revcomp_str[i]='\0';
-    }
     int i, c0, c1;
     for (i = 0; i < l>>1; ++i) 
     {
         c0 = comp_tab[(int)str[i]];
         c1 = comp_tab[(int)str[l - 1 - i]];
-        revcomp_str[i] = c1;
-        revcomp_str[l - 1 - i] = c0;
+        str[i] = c1;
+        str[l - 1 - i] = c0;
     }
     if (l&1) 
     {
-        revcomp_str[l>>1] = comp_tab[(int)str[l>>1]];
+        str[l>>1] = comp_tab[(int)str[l>>1]];
     }
-
-    std::string ret = revcomp_str;
-    delete [] revcomp_str;
-
-    return ret;
 }
 
 std::string laurenize (std::string seq1)
@@ -37,7 +37,10 @@
 #include <string>
 #include <zlib.h>
 
-std::string reverseComplement(std::string str);
+std::string reverseComplement(const std::string& str);
+
+// as above but the string is turned around where it is
+void reverseComplementInPlace(std::string& str);
 
 std::string laurenize(std::string seq);
 
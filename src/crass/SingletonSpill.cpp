@@ -0,0 +1,208 @@
+// File: SingletonSpill.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of SingletonSpill functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+// system includes
+#include <cstdio>
+
+// local includes
+#include "SingletonSpill.h"
+#include "SeqUtils.h"
+#include "crassDefines.h"
+#include "Exception.h"
+
+// two bits per base
+static inline int spillBaseCode(char base)
+{
+    switch (base) 
+    {
+        case 'A': case 'a': return 0;
+        case 'C': case 'c': return 1;
+        case 'G': case 'g': return 2;
+        case 'T': case 't': return 3;
+        default: return -1;
+    }
+}
+
+SingletonSpill::SingletonSpill(std::string fileName)
+{
+    SS_FileName = fileName;
+    SS_Out.open(fileName.c_str());
+    if (! SS_Out.good()) 
+    {
+        throw crispr::exception(__FILE__,
+                                __LINE__,
+                                __PRETTY_FUNCTION__,
+                                ("Cannot open spill file " + fileName + " for writing").c_str());
+    }
+    SS_Kmers.assign(((1UL << (2 * CRASS_DEF_SPILL_KMER_SIZE)) + 31) / 32, 0);
+    SS_SpillEverything = false;
+    SS_CurrentFile = -1;
+    SS_CurrentRead = -1;
+    SS_NumSpilled = 0;
+    SS_RescanFile = -1;
+    SS_RescanReads = 0;
+    SS_SpilledBeforeRescan = 0;
+}
+
+SingletonSpill::~SingletonSpill(void)
+{
+    close();
+    remove(SS_FileName.c_str());
+}
+
+void SingletonSpill::startFile(void)
+{
+    SS_CurrentFile++;
+    SS_CurrentRead = -1;
+}
+
+void SingletonSpill::addRepeat(const std::string& repeat)
+{
+    //-----
+    // Remember the kmers on both strands. If anything new was added then 
+    // reads up to this one could have been passed over, so they will 
+    // need to be looked at again in the second pass
+    //
+    bool added = addKmers(repeat);
+    added = addKmers(reverseComplement(repeat)) || added;
+    if (! added && ! SS_SpillEverything) 
+    {
+        // a repeat with no complete kmers at all (too many Ns), 
+        // from here on we can't rule anything out
+        std::string::const_iterator base_iter;
+        int run = 0;
+        for (base_iter = repeat.begin(); base_iter != repeat.end() && run < CRASS_DEF_SPILL_KMER_SIZE; ++base_iter) 
+        {
+            run = (spillBaseCode(*base_iter) < 0) ? 0 : run + 1;
+        }
+        if (run < CRASS_DEF_SPILL_KMER_SIZE) 
+        {
+            SS_SpillEverything = true;
+            added = true;
+        }
+    }
+    if (added) 
+    {
+        SS_RescanFile = SS_CurrentFile;
+        SS_RescanReads = SS_CurrentRead + 1;
+        SS_SpilledBeforeRescan = SS_NumSpilled;
+    }
+}
+
+bool SingletonSpill::spillIfShared(ReadHolder& read)
+{
+    if (! SS_SpillEverything && ! sharesKmer(read.getSeq())) 
+    {
+        return false;
+    }
+    if (read.getIsFasta()) 
+    {
+        SS_Out<<'>'<<read.getHeader();
+        if (! read.getComment().empty()) 
+        {
+            SS_Out<<' '<<read.getComment();
+        }
+        SS_Out<<'\n'<<read.getSeq()<<'\n';
+    } 
+    else 
+    {
+        SS_Out<<'@'<<read.getHeader();
+        if (! read.getComment().empty()) 
+        {
+            SS_Out<<' '<<read.getComment();
+        }
+        SS_Out<<'\n'<<read.getSeq()<<"\n+\n"<<read.getQual()<<'\n';
+    }
+    SS_NumSpilled++;
+    return true;
+}
+
+void SingletonSpill::close(void)
+{
+    if (SS_Out.is_open()) 
+    {
+        SS_Out.close();
+    }
+}
+
+bool SingletonSpill::sharesKmer(const std::string& seq)
+{
+    unsigned int mask = (1U << (2 * CRASS_DEF_SPILL_KMER_SIZE)) - 1;
+    unsigned int kmer = 0;
+    int run = 0;
+    std::string::const_iterator base_iter;
+    for (base_iter = seq.begin(); base_iter != seq.end(); ++base_iter) 
+    {
+        int code = spillBaseCode(*base_iter);
+        if (code < 0) 
+        {
+            run = 0;
+            continue;
+        }
+        kmer = ((kmer << 2) | code) & mask;
+        if (++run >= CRASS_DEF_SPILL_KMER_SIZE && (SS_Kmers[kmer >> 5] & (1U << (kmer & 31)))) 
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SingletonSpill::addKmers(const std::string& seq)
+{
+    unsigned int mask = (1U << (2 * CRASS_DEF_SPILL_KMER_SIZE)) - 1;
+    unsigned int kmer = 0;
+    int run = 0;
+    bool added = false;
+    std::string::const_iterator base_iter;
+    for (base_iter = seq.begin(); base_iter != seq.end(); ++base_iter) 
+    {
+        int code = spillBaseCode(*base_iter);
+        if (code < 0) 
+        {
+            run = 0;
+            continue;
+        }
+        kmer = ((kmer << 2) | code) & mask;
+        if (++run >= CRASS_DEF_SPILL_KMER_SIZE && ! (SS_Kmers[kmer >> 5] & (1U << (kmer & 31)))) 
+        {
+            SS_Kmers[kmer >> 5] |= (1U << (kmer & 31));
+            added = true;
+        }
+    }
+    return added;
+}
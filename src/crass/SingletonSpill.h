@@ -0,0 +1,103 @@
+// File: SingletonSpill.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Keeps the reads from the first search that might turn out to be 
+// singletons so that the second pass does not need to go back over 
+// all of the input. A read is kept if it failed the search but shares
+// an 11-mer with a direct repeat that had already been found. Reads 
+// that came before the last new repeat was found cannot be judged like 
+// this, so the spill also remembers how far into the input the second
+// pass still has to go.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef SingletonSpill_h
+#define SingletonSpill_h
+
+// system includes
+#include <string>
+#include <vector>
+#include <fstream>
+
+// local includes
+#include "ReadHolder.h"
+
+class SingletonSpill
+{
+    public:
+        SingletonSpill(std::string fileName);
+        ~SingletonSpill(void);
+
+        //
+        // First pass
+        //
+        void startFile(void);                               // call before searching each file
+        inline void nextRead(void) { SS_CurrentRead++; }    // call before each read is handled
+        void addRepeat(const std::string& repeat);          // a new direct repeat variant was found in the current read
+        bool spillIfShared(ReadHolder& read);               // keep a read that failed the search if it shares a kmer with a repeat
+        void close(void);                                   // finished with the first pass
+
+        //
+        // Second pass
+        //
+        // files before this one must be scanned again in full, -1 if none
+        inline int lastFileToRescan(void) { return SS_RescanFile; }
+        
+        // the number of reads in lastFileToRescan that must be scanned again
+        inline long readsToRescan(void) { return SS_RescanReads; }
+        
+        // the spilled reads at the start of the spill file that 
+        // are already covered by the rescan
+        inline long spilledReadsToSkip(void) { return SS_SpilledBeforeRescan; }
+
+        inline long numSpilled(void) { return SS_NumSpilled; }
+        inline std::string getFileName(void) { return SS_FileName; }
+
+    private:
+        bool sharesKmer(const std::string& seq);
+        bool addKmers(const std::string& seq);
+
+        // members
+        std::string SS_FileName;
+        std::ofstream SS_Out;
+        std::vector<unsigned int> SS_Kmers;                 // one bit per possible kmer
+        bool SS_SpillEverything;                            // a repeat had no usable kmers so everything must be kept
+        int SS_CurrentFile;
+        long SS_CurrentRead;                                // index of the read being handled in the current file
+        long SS_NumSpilled;
+        int SS_RescanFile;
+        long SS_RescanReads;
+        long SS_SpilledBeforeRescan;
+};
+
+#endif //SingletonSpill_h
@@ -42,6 +42,7 @@
 // system includes
 #include <iostream>
 #include <list>
+#include <stdint.h>
 
 // local includes
 #include "crassDefines.h"
@@ -49,8 +50,9 @@
 #include "StringCheck.h"
 
 class SpacerInstance;
-// we hash together string tokens to make a unique key for each spacer
-typedef unsigned int SpacerKey;
+// the string tokens of the two nodes either side of a spacer make a unique
+// key for it, the smaller token in the top half
+typedef uint64_t SpacerKey;
 
 enum SI_EdgeDirection {
     REVERSE = 0,
@@ -87,9 +89,9 @@ inline SpacerKey makeSpacerKey(StringToken backST, StringToken frontST)
     //
 	if(backST < frontST)
 	{
-		return (backST * 10000000) + frontST;
+		return (static_cast<SpacerKey>(backST) << 32) | static_cast<unsigned int>(frontST);
 	}
-	return (frontST * 10000000) + backST;
+	return (static_cast<SpacerKey>(frontST) << 32) | static_cast<unsigned int>(backST);
 }
 
 class SpacerInstance {
@@ -114,6 +116,7 @@ public:
         // get / set
         //
         inline void incrementCount(void) { SI_InstanceCount++; }
+        inline void incrementCount(unsigned int count) { SI_InstanceCount += count; }
         inline unsigned int getCount(void) { return SI_InstanceCount; }
         inline StringToken getID(void) { return SI_SpacerSeqID; }
         inline CrisprNode * getLeader(void) { return SI_LeadingNode; }
@@ -0,0 +1,150 @@
+// File: SpacerList.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of SpacerList functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+// system includes
+#include <algorithm>
+
+// local includes
+#include "SpacerList.h"
+
+// the table starts off with this many slots and is kept at most half full,
+// there is a list for every group so most of them stay small
+#define SL_MIN_SLOTS (64)
+
+// no long long constants in C++98
+#define SL_U64(high, low) ((static_cast<uint64_t>(high) << 32) | static_cast<uint64_t>(low))
+
+// the murmur3 finaliser, keys from neighbouring tokens end up far apart
+static inline size_t hashSpacerKey(SpacerKey key)
+{
+    key ^= key >> 33;
+    key *= SL_U64(0xff51afd7U, 0xed558ccdU);
+    key ^= key >> 33;
+    key *= SL_U64(0xc4ceb9feU, 0x1a85ec53U);
+    key ^= key >> 33;
+    return static_cast<size_t>(key);
+}
+
+SpacerList::SpacerList(void)
+{
+    SL_Sorted = true;
+}
+
+SpacerInstance * SpacerList::find(SpacerKey key) const
+{
+    if (SL_Entries.empty()) 
+    {
+        return NULL;
+    }
+    unsigned int index = SL_Slots[findSlot(key)];
+    if (index == 0) 
+    {
+        return NULL;
+    }
+    return SL_Entries[index - 1].second;
+}
+
+void SpacerList::insert(SpacerKey key, SpacerInstance * spacer)
+{
+    if (2 * (SL_Entries.size() + 1) > SL_Slots.size()) 
+    {
+        makeSlots((SL_Slots.empty()) ? SL_MIN_SLOTS : SL_Slots.size() * 2);
+    }
+    if (! SL_Entries.empty() && key < SL_Entries.back().first) 
+    {
+        SL_Sorted = false;
+    }
+    SL_Entries.push_back(SpacerListEntry(key, spacer));
+    SL_Slots[findSlot(key)] = static_cast<unsigned int>(SL_Entries.size());
+}
+
+SpacerList::iterator SpacerList::begin(void)
+{
+    if (! SL_Sorted) 
+    {
+        // every index in the table has moved
+        std::sort(SL_Entries.begin(), SL_Entries.end());
+        makeSlots(SL_Slots.size());
+        SL_Sorted = true;
+    }
+    return SL_Entries.begin();
+}
+
+size_t SpacerList::memoryUsage(void) const
+{
+    return SL_Entries.capacity() * sizeof(SpacerListEntry) + SL_Slots.capacity() * sizeof(unsigned int);
+}
+
+void SpacerList::clear(void)
+{
+    SL_Entries.clear();
+    SL_Slots.clear();
+    SL_Sorted = true;
+}
+
+size_t SpacerList::findSlot(SpacerKey key) const
+{
+    //-----
+    // linear probing, the table is never more than half full
+    //
+    size_t mask = SL_Slots.size() - 1;
+    size_t slot = hashSpacerKey(key) & mask;
+    while (SL_Slots[slot] != 0) 
+    {
+        if (SL_Entries[SL_Slots[slot] - 1].first == key) 
+        {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void SpacerList::makeSlots(size_t numSlots)
+{
+    SL_Slots.assign(numSlots, 0);
+    size_t mask = numSlots - 1;
+    for (size_t i = 0; i < SL_Entries.size(); i++) 
+    {
+        size_t slot = hashSpacerKey(SL_Entries[i].first) & mask;
+        while (SL_Slots[slot] != 0) 
+        {
+            slot = (slot + 1) & mask;
+        }
+        SL_Slots[slot] = static_cast<unsigned int>(i + 1);
+    }
+}
@@ -0,0 +1,92 @@
+// File: SpacerList.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// The spacers of a NodeManager, found by the key made from the tokens
+// of the two nodes at either end. The spacers sit one after the other
+// in a vector with an open addressing table over the top for finding
+// them by key. Walking the list goes in key order, the same order the
+// std::map this replaces used to give.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef SpacerList_h
+#define SpacerList_h
+
+// system includes
+#include <vector>
+#include <utility>
+
+// local includes
+#include "SpacerInstance.h"
+
+typedef std::pair<SpacerKey, SpacerInstance *> SpacerListEntry;
+
+class SpacerList
+{
+    public:
+        typedef std::vector<SpacerListEntry>::iterator iterator;
+
+        SpacerList(void);
+        ~SpacerList(void) {}
+
+        // the spacer with this key or NULL if there isn't one
+        SpacerInstance * find(SpacerKey key) const;
+
+        // the key must not be in the list already
+        void insert(SpacerKey key, SpacerInstance * spacer);
+
+        // spacers added since the last walk are sorted into place
+        // here, so don't add any while walking the list
+        iterator begin(void);
+        inline iterator end(void) { return SL_Entries.end(); }
+
+        inline size_t size(void) const { return SL_Entries.size(); }
+
+        // bytes held by the list, not counting the spacers
+        size_t memoryUsage(void) const;
+
+        // forget all the spacers, they are not deleted
+        void clear(void);
+
+    private:
+        // the slot holding the key or the empty slot where it would go
+        size_t findSlot(SpacerKey key) const;
+        void makeSlots(size_t numSlots);
+
+        // members
+        std::vector<SpacerListEntry> SL_Entries;   // the spacers
+        std::vector<unsigned int> SL_Slots;        // open addressing, 1 + the index into SL_Entries, 0 is empty. Always a power of 2 in size
+        bool SL_Sorted;                            // SL_Entries is in key order
+};
+
+#endif //SpacerList_h
@@ -37,45 +37,168 @@
 // system includes
 #include <iostream>
 #include <sstream>
+#include <cstring>
 
 // local includes
 #include "StringCheck.h"
 #include "Exception.h"
 
+// the arena starts small, most StringChecks only ever hold a few strings
+#define SC_MIN_BLOCK_SIZE (4096)
+#define SC_MAX_BLOCK_SIZE (1 << 20)
+#define SC_MIN_SLOTS (64)
 
-StringToken StringCheck::addString(std::string newStr)
+// FNV-1a
+static inline unsigned int hashString(const char * str, size_t length)
+{
+    unsigned int hash = 2166136261U;
+    for (size_t i = 0; i < length; i++) 
+    {
+        hash ^= static_cast<unsigned char>(str[i]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+std::ostream& operator<<(std::ostream& out, const StringView& view)
+{
+    return out.write(view.data(), static_cast<std::streamsize>(view.length()));
+}
+
+StringToken StringCheck::addString(const std::string& newStr)
 {
     //-----
-    // add the string and retuen it's token
+    // add the string and retuen it's token. Adding a string again 
+    // gives it a new token which getToken returns from then on but 
+    // the bytes are only stored once
     //
+    if ((mUsedSlots + 1) * 2 > mSlots.size()) 
+    {
+        growSlots();
+    }
+    unsigned int hash = hashString(newStr.data(), newStr.length());
+    size_t slot = findSlot(newStr.data(), newStr.length(), hash);
+    
+    Entry entry;
+    if (mSlots[slot] != 0) 
+    {
+        entry = mEntries[mSlots[slot] - firstToken()];
+    } 
+    else 
+    {
+        size_t length = newStr.length();
+        if (mArena.empty() || mArena.back().size() - mArenaUsed < length) 
+        {
+            size_t block_size = (mArena.empty()) ? SC_MIN_BLOCK_SIZE : mArena.back().size() * 2;
+            if (block_size > SC_MAX_BLOCK_SIZE) 
+            {
+                block_size = SC_MAX_BLOCK_SIZE;
+            }
+            if (block_size < length) 
+            {
+                block_size = length;
+            }
+            mArena.push_back(std::vector<char>(block_size));
+            mArenaUsed = 0;
+        }
+        entry.block = static_cast<unsigned int>(mArena.size() - 1);
+        entry.offset = static_cast<unsigned int>(mArenaUsed);
+        entry.length = static_cast<unsigned int>(length);
+        entry.hash = hash;
+        if (length > 0) 
+        {
+            memcpy(&(mArena.back()[mArenaUsed]), newStr.data(), length);
+        }
+        mArenaUsed += length;
+        mUsedSlots++;
+    }
     mNextFreeToken++;
-    mT2S_map[mNextFreeToken] = newStr;
-    mS2T_map[newStr] = mNextFreeToken;
+    mEntries.push_back(entry);
+    mSlots[slot] = mNextFreeToken;
     return mNextFreeToken;
 }
 
-std::string StringCheck::getString(StringToken token)
+StringView StringCheck::getString(StringToken token) const
 {
     //-----
     // return the string for a given token or spew
     //
-    if(mT2S_map.find(token) != mT2S_map.end()) {
-        return mT2S_map[token];
-    } else {
+    if (token < firstToken() || token > mNextFreeToken) 
+    {
         throw crispr::exception(__FILE__, 
                                 __LINE__, 
                                 __PRETTY_FUNCTION__,
                                 "Token not stored");
     }
-
+    const Entry& entry = mEntries[token - firstToken()];
+    if (entry.length == 0) 
+    {
+        return StringView();
+    }
+    return StringView(&(mArena[entry.block][entry.offset]), entry.length);
 }
 
-StringToken StringCheck::getToken(const std::string& queryStr)
+StringToken StringCheck::getToken(const std::string& queryStr) const
 {
     //-----
     // return the token or 0
     //
-    if(mS2T_map.end() == mS2T_map.find(queryStr))
+    if (mSlots.empty()) 
+    {
         return 0;
-    return mS2T_map[queryStr];
+    }
+    return mSlots[findSlot(queryStr.data(), queryStr.length(), hashString(queryStr.data(), queryStr.length()))];
+}
+
+void StringCheck::clear(void)
+{
+    mNextFreeToken = 1;
+    mEntries.clear();
+    mSlots.clear();
+    mUsedSlots = 0;
+    mArena.clear();
+    mArenaUsed = 0;
+}
+
+size_t StringCheck::findSlot(const char * queryStr, size_t length, unsigned int hash) const
+{
+    //-----
+    // linear probing, the table is never more than half full
+    //
+    size_t mask = mSlots.size() - 1;
+    size_t slot = hash & mask;
+    while (mSlots[slot] != 0) 
+    {
+        const Entry& entry = mEntries[mSlots[slot] - firstToken()];
+        if (entry.hash == hash && 
+            entry.length == length && 
+            (length == 0 || memcmp(&(mArena[entry.block][entry.offset]), queryStr, length) == 0)) 
+        {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void StringCheck::growSlots(void)
+{
+    std::vector<StringToken> old_slots;
+    old_slots.swap(mSlots);
+    mSlots.assign((old_slots.empty()) ? SC_MIN_SLOTS : old_slots.size() * 2, 0);
+    size_t mask = mSlots.size() - 1;
+    std::vector<StringToken>::iterator slot_iter;
+    for (slot_iter = old_slots.begin(); slot_iter != old_slots.end(); ++slot_iter) 
+    {
+        if (*slot_iter == 0) 
+        {
+            continue;
+        }
+        size_t slot = mEntries[*slot_iter - firstToken()].hash & mask;
+        while (mSlots[slot] != 0) 
+        {
+            slot = (slot + 1) & mask;
+        }
+        mSlots[slot] = *slot_iter;
+    }
 }
@@ -7,7 +7,10 @@
 // Give this guy a string, get a token, give this guy a token, get a string
 // All token are unique, all strings aren't!
 // 
-// Basically a glorified map
+// Basically a glorified map. Strings are stored once, one after the 
+// other in a few big blocks, and looked up through an open addressing 
+// hash table. Tokens are handed out one after the other so they double 
+// as indexes into the list of stored strings
 //
 // --------------------------------------------------------------------
 //  Copyright  2011 Michael Imelfort and Connor Skennerton
@@ -43,31 +46,77 @@
 
 // system includes
 #include <iostream>
-#include <map>
+#include <string>
+#include <vector>
+#include <deque>
 
 
 // typedefs
 typedef int StringToken;
 
+// A read only look at a string stored in a StringCheck. It stays valid 
+// for as long as the StringCheck does and turns into a std::string 
+// wherever one is needed
+class StringView
+{
+    public:
+        StringView(void) : mData(""), mLength(0) {}
+        StringView(const char * data, size_t length) : mData(data), mLength(length) {}
+
+        inline const char * data(void) const { return mData; }
+        inline size_t length(void) const { return mLength; }
+        inline size_t size(void) const { return mLength; }
+        inline char operator[](size_t i) const { return mData[i]; }
+        inline operator std::string(void) const { return std::string(mData, mLength); }
+
+    private:
+        const char * mData;
+        size_t mLength;
+};
+
+std::ostream& operator<<(std::ostream& out, const StringView& view);
+
 class StringCheck 
 {
     public:
-		StringCheck(std::string name) { mNextFreeToken = 1; mName = name;}  
-		StringCheck(void) { mNextFreeToken = 1; mName = "unset";}  
+		StringCheck(std::string name) { mNextFreeToken = 1; mUsedSlots = 0; mArenaUsed = 0; mName = name;}  
+		StringCheck(void) { mNextFreeToken = 1; mUsedSlots = 0; mArenaUsed = 0; mName = "unset";}  
         ~StringCheck(void) {}  
         
-        StringToken addString(std::string newStr);
-        std::string getString(StringToken token);
-        StringToken getToken(const std::string& queryStr);
+        StringToken addString(const std::string& newStr);
+        StringView getString(StringToken token) const;
+        StringToken getToken(const std::string& queryStr) const;
+
+        // forget every string, tokens start again from the beginning
+        void clear(void);
         
         inline void setName(std::string name) { mName = name; }
 
+        // tokens go from here up to and including mNextFreeToken
+        inline StringToken firstToken(void) const { return 2; }
+
         // members
-        StringToken mNextFreeToken;                            // der
-        std::map<StringToken, std::string> mT2S_map;           // token to string map
-        std::map<std::string, StringToken> mS2T_map;           // string to token map
+        StringToken mNextFreeToken;                            // the last token handed out
         
         std::string mName;
+
+    private:
+        typedef struct {
+            unsigned int block;                                // where the string is in mArena
+            unsigned int offset;
+            unsigned int length;
+            unsigned int hash;
+        } Entry;
+
+        // the slot holding queryStr or the empty slot it would go in
+        size_t findSlot(const char * queryStr, size_t length, unsigned int hash) const;
+        void growSlots(void);
+        
+        std::vector<Entry> mEntries;                           // indexed by token - firstToken()
+        std::vector<StringToken> mSlots;                       // hash table of tokens, 0 is empty. Always a power of 2 in size
+        size_t mUsedSlots;                                     // number of different strings
+        std::deque<std::vector<char> > mArena;                 // the strings, blocks are never resized once made
+        size_t mArenaUsed;                                     // bytes used in the last block
 };
 
 #endif //StringCheck_h
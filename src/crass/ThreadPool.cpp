@@ -0,0 +1,177 @@
+// File: ThreadPool.cpp
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// Implementation of ThreadPool functions
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+// system includes
+#include <string.h>
+
+// local includes
+#include "ThreadPool.h"
+#include "Exception.h"
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+{
+    pthread_mutex_init(&TP_Lock, NULL);
+    pthread_cond_init(&TP_HasWork, NULL);
+    pthread_cond_init(&TP_JobDone, NULL);
+    TP_Running = 0;
+    TP_ShuttingDown = false;
+
+    if (numThreads < 1)
+    {
+        numThreads = 1;
+    }
+    for (unsigned int i = 0; i < numThreads; i++)
+    {
+        pthread_t thread;
+        int err = pthread_create(&thread, NULL, ThreadPool::workerMain, this);
+        if (err != 0)
+        {
+            throw crispr::runtime_exception(__FILE__,
+                                            __LINE__,
+                                            __PRETTY_FUNCTION__,
+                                            strerror(err));
+        }
+        TP_Threads.push_back(thread);
+    }
+}
+
+ThreadPool::~ThreadPool(void)
+{
+    //-----
+    // let the workers drain the queue and then send them home
+    //
+    pthread_mutex_lock(&TP_Lock);
+    TP_ShuttingDown = true;
+    pthread_cond_broadcast(&TP_HasWork);
+    pthread_mutex_unlock(&TP_Lock);
+
+    std::vector<pthread_t>::iterator thread_iter;
+    for (thread_iter = TP_Threads.begin(); thread_iter != TP_Threads.end(); ++thread_iter)
+    {
+        pthread_join(*thread_iter, NULL);
+    }
+    pthread_cond_destroy(&TP_JobDone);
+    pthread_cond_destroy(&TP_HasWork);
+    pthread_mutex_destroy(&TP_Lock);
+}
+
+void ThreadPool::submit(ThreadPoolTask task, void * arg, bool * doneFlag)
+{
+    Job job;
+    job.task = task;
+    job.arg = arg;
+    job.doneFlag = doneFlag;
+
+    pthread_mutex_lock(&TP_Lock);
+    if (doneFlag != NULL)
+    {
+        *doneFlag = false;
+    }
+    TP_Queue.push_back(job);
+    pthread_cond_signal(&TP_HasWork);
+    pthread_mutex_unlock(&TP_Lock);
+}
+
+void ThreadPool::waitFor(bool * doneFlag)
+{
+    pthread_mutex_lock(&TP_Lock);
+    while (! *doneFlag)
+    {
+        pthread_cond_wait(&TP_JobDone, &TP_Lock);
+    }
+    pthread_mutex_unlock(&TP_Lock);
+}
+
+bool ThreadPool::isDone(bool * doneFlag)
+{
+    pthread_mutex_lock(&TP_Lock);
+    bool done = *doneFlag;
+    pthread_mutex_unlock(&TP_Lock);
+    return done;
+}
+
+void ThreadPool::waitAll(void)
+{
+    pthread_mutex_lock(&TP_Lock);
+    while (! TP_Queue.empty() || TP_Running > 0)
+    {
+        pthread_cond_wait(&TP_JobDone, &TP_Lock);
+    }
+    pthread_mutex_unlock(&TP_Lock);
+}
+
+void * ThreadPool::workerMain(void * pool)
+{
+    static_cast<ThreadPool *>(pool)->runJobs();
+    return NULL;
+}
+
+void ThreadPool::runJobs(void)
+{
+    //-----
+    // Tasks are expected to deal with their own exceptions,
+    // nothing is allowed to escape from a worker
+    //
+    pthread_mutex_lock(&TP_Lock);
+    while (true)
+    {
+        while (TP_Queue.empty() && ! TP_ShuttingDown)
+        {
+            pthread_cond_wait(&TP_HasWork, &TP_Lock);
+        }
+        if (TP_Queue.empty())
+        {
+            // shutting down and nothing left to do
+            break;
+        }
+        Job job = TP_Queue.front();
+        TP_Queue.pop_front();
+        TP_Running++;
+        pthread_mutex_unlock(&TP_Lock);
+
+        job.task(job.arg);
+
+        pthread_mutex_lock(&TP_Lock);
+        TP_Running--;
+        if (job.doneFlag != NULL)
+        {
+            *job.doneFlag = true;
+        }
+        pthread_cond_broadcast(&TP_JobDone);
+    }
+    pthread_mutex_unlock(&TP_Lock);
+}
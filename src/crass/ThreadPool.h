@@ -0,0 +1,96 @@
+// File: ThreadPool.h
+// Original Author: agent 2026
+// --------------------------------------------------------------------
+//
+// OVERVIEW:
+//
+// A very small pool of posix worker threads. Give it a function and
+// a pointer, it will run it on one of the workers. Tasks can carry a
+// flag that gets set once they are done so that the caller can wait
+// on individual tasks in whatever order it likes.
+//
+// --------------------------------------------------------------------
+//  Copyright  2026 agent
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// --------------------------------------------------------------------
+//
+//                        A
+//                       A B
+//                      A B R
+//                     A B R A
+//                    A B R A C
+//                   A B R A C A
+//                  A B R A C A D
+//                 A B R A C A D A
+//                A B R A C A D A B
+//               A B R A C A D A B R
+//              A B R A C A D A B R A
+//
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+// system includes
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+// the signature of a function that can be run by the pool
+typedef void (*ThreadPoolTask)(void * arg);
+
+class ThreadPool
+{
+    public:
+        ThreadPool(unsigned int numThreads);
+        ~ThreadPool(void);                      // waits for all queued tasks then joins the workers
+
+        // queue a task, if doneFlag is not NULL it is set to true
+        // (while holding the pool lock) once the task has finished
+        void submit(ThreadPoolTask task, void * arg, bool * doneFlag = NULL);
+
+        // block until the task that owns doneFlag has finished
+        void waitFor(bool * doneFlag);
+
+        // check, without blocking, whether the task that owns doneFlag has finished
+        bool isDone(bool * doneFlag);
+
+        // block until every queued task has finished
+        void waitAll(void);
+
+        inline unsigned int size(void) { return static_cast<unsigned int>(TP_Threads.size()); }
+
+    private:
+        typedef struct {
+            ThreadPoolTask task;
+            void * arg;
+            bool * doneFlag;
+        } Job;
+
+        static void * workerMain(void * pool);
+        void runJobs(void);
+
+        ThreadPool(const ThreadPool&);
+        const ThreadPool& operator=(const ThreadPool&);
+
+        // members
+        std::vector<pthread_t> TP_Threads;      // the workers
+        std::deque<Job> TP_Queue;               // tasks waiting for a worker
+        pthread_mutex_t TP_Lock;                // guards everything below
+        pthread_cond_t TP_HasWork;              // signalled when a task is queued or we are shutting down
+        pthread_cond_t TP_JobDone;              // broadcast whenever a task finishes
+        unsigned int TP_Running;                // number of tasks currently being run
+        bool TP_ShuttingDown;
+};
+
+#endif //ThreadPool_h
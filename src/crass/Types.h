@@ -38,6 +38,7 @@
 #include <vector>
 #include <string>
 #include "ReadHolder.h"
+#include "ReadStore.h"
 #include "StringCheck.h"
 
 
@@ -48,8 +49,9 @@
 // Types cut from libcrispr.h
 typedef std::map<std::string, bool> lookupTable;
 
-typedef std::vector<ReadHolder *> ReadList;
-typedef std::vector<ReadHolder *>::iterator ReadListIterator;
+// the reads themselves live in a ReadStore
+typedef std::vector<ReadIndex> ReadList;
+typedef std::vector<ReadIndex>::iterator ReadListIterator;
 
 // direct repeat as a string and a list of the read objects that contain that direct repeat
 typedef std::map<StringToken, ReadList *> ReadMap;
@@ -64,7 +66,8 @@ typedef std::vector<StringToken>::iterator DR_ClusterIterator;
 typedef std::map<int, DR_Cluster *>::iterator DR_Cluster_MapIterator;
 typedef std::map<int, DR_Cluster *> DR_Cluster_Map;
 
-typedef std::map<int, std::map<std::string, int> * > GroupKmerMap;
+// groups in the order they were made
+typedef std::vector<int> GroupIdList;
 
 typedef std::vector<std::string> Vecstr;
 
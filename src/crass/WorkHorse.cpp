@@ -63,6 +63,7 @@
 #include "StringCheck.h"
 #include "config.h"
 #include "ksw.h"
+#include "ThreadPool.h"
 
 bool sortLengthDecending( const std::string& a, const std::string& b)
 {
@@ -127,18 +128,9 @@ WorkHorse::~WorkHorse()
 void WorkHorse::clearReadList(ReadList * tmp_list)
 {
     //-----
-    // clear all the reads from the readlist
+    // clear all the reads from the readlist. The reads themselves
+    // stay in mReadStore until the WorkHorse is done
     //
-    ReadListIterator read_iter = tmp_list->begin();
-    while(read_iter != tmp_list->end())
-    {
-        if(*read_iter != NULL)
-        {
-            delete *read_iter;
-            *read_iter = NULL;
-        }
-        read_iter++;
-    }
     tmp_list->clear();
 }
 
@@ -169,7 +161,12 @@ int WorkHorse::numOfReads(void)
     {
         if (read_iter->second != NULL)
         {
-            count += (int)(read_iter->second)->size();
+            // copies folded together in the store still count
+            ReadListIterator list_iter;
+            for (list_iter = (read_iter->second)->begin(); list_iter != (read_iter->second)->end(); ++list_iter)
+            {
+                count += (int)mReadStore.multiplicity(*list_iter);
+            }
         }
         read_iter++;
     }
@@ -192,10 +189,14 @@ int WorkHorse::doWork(Vecstr seqFiles)
         return 2;
 	}
 
-    // build the spacer end graph
-    if(buildGraph())
+    // build, clean and split the graphs, each group on its own
+    if(makeGraphs())
     {
-        logError("FATAL ERROR: buildGraph failed");
+        // the stages that did finish are still worth reporting
+        if (mOpts->reportStats && ! writeStatsReport()) 
+        {
+            std::cerr<<PACKAGE_NAME<<" [WARNING]: Could not write the stats report"<<std::endl;
+        }
         return 3;
     }
 #ifdef SEARCH_SINGLETON
@@ -229,61 +230,18 @@ int WorkHorse::doWork(Vecstr seqFiles)
         return 200;
     }
 #endif
-	
-#if DEBUG
-	if (!mOpts->noDebugGraph) // this option will only exist if DEBUG is set anyway
-    {
-        // print debug graphs
-        if(renderDebugGraphs())
-        {
-            logError("FATAL ERROR: renderDebugGraphs failed");
-            return 4;
-        }
-    }
-
-#endif
-	
-	// clean each spacer end graph
-	if(cleanGraph())
-	{
-        logError("FATAL ERROR: cleanGraph failed");
-        return 5;
-	}
-    
-	// make spacer graphs
-	if(makeSpacerGraphs())
-	{
-        logError("FATAL ERROR: makeSpacerGraphs failed");
-        return 50;
-	}
-	
-	// clean spacer graphs
-	if(cleanSpacerGraphs())
-	{
-        logError("FATAL ERROR: cleanSpacerGraphs failed");
-        return 51;
-	}
-	
-	// make contigs
-	if(splitIntoContigs())
-	{
-        logError("FATAL ERROR: splitIntoContigs failed");
-        return 6;
-	}
-    // call flanking regions
-    if (generateFlankers()) {
-        logError("FATAL ERROR: generateFlankers failed");
-        return 70;
-    }
     
     //remove NodeManagers with low numbers of spacers
     // and where the standard deviation of the spacer length 
     // is too high
+    mStats.startStage("removeLowConfidenceNodeManagers");
     if (removeLowConfidenceNodeManagers())
     {
         logError("FATAL ERROR: removeLowSpacerNodeManagers failed");
         return 7;
     }
+    mStats.endStage();
+    countGraphs();
 	
     // print the reads to a file if requested
 //	if(dumpReads(false))
@@ -312,7 +270,14 @@ int WorkHorse::doWork(Vecstr seqFiles)
 //        return 11;
 //	}
 	
+    mStats.startStage("outputResults");
 	outputResults();
+    mStats.endStage();
+    
+    if (mOpts->reportStats && ! writeStatsReport()) 
+    {
+        std::cerr<<PACKAGE_NAME<<" [WARNING]: Could not write the stats report"<<std::endl;
+    }
 	
     logInfo("all done!", 1);
 	return 0;
@@ -329,27 +294,66 @@ int WorkHorse::parseSeqFiles(Vecstr seqFiles)
     lookupTable patterns_lookup;
     
     // the sequence of whole spacers and their unique ID
-    lookupTable reads_found;
+    HeaderSet reads_found;
+
+    // reads that may be singletons, when running in single pass mode
+    SingletonSpill * spill = NULL;
+    if (mOpts->singlePass) 
+    {
+        try {
+            spill = new SingletonSpill(mOpts->output_fastq + "crass." + mTimeStamp + ".spill");
+        } catch (crispr::exception& e) {
+            std::cerr<<e.what()<<std::endl;
+            return 1;
+        }
+    }
+
+    // recruited reads past the memory budget go out to disk
+    if (mOpts->maxMemory > 0) 
+    {
+        try {
+            mReadStore.setMemoryLimit(mOpts->maxMemory * 1024 * 1024, mOpts->output_fastq + "crass." + mTimeStamp + ".reads");
+        } catch (crispr::exception& e) {
+            std::cerr<<e.what()<<std::endl;
+            delete spill;
+            return 1;
+        }
+    }
+
+    // exact copies of a read are stored once
+    mReadStore.setDeduplicate(mOpts->dedupReads);
 
+    SearchCounters search_counters;
+    clearSearchCounters(search_counters);
+
+    mStats.startStage("search");
     time_t start_time;
     time(&start_time);
     while(seq_iter != seqFiles.end())
     {
         logInfo("Parsing file: " << *seq_iter, 1);
         try {
+            if (spill != NULL) 
+            {
+                spill->startFile();
+            }
             int max_len = searchFile(seq_iter->c_str(), 
                                             *mOpts, 
                                             &mReads, 
+                                            &mReadStore, 
                                             &mStringCheck, 
                                             patterns_lookup, 
                                             reads_found,
-                                            start_time);
+                                            start_time,
+                                            spill,
+                                            &search_counters);
             
             mMaxReadLength = (max_len > mMaxReadLength) ? max_len : mMaxReadLength;
             logInfo("Finished file: " << *seq_iter, 1);
 
         } catch (crispr::exception& e) {
             std::cerr<<e.what()<<std::endl;
+            delete spill;
             return 1;
         }
         
@@ -364,11 +368,26 @@ int WorkHorse::parseSeqFiles(Vecstr seqFiles)
     }
     // add in a new line so the looger won't overlap itself
     std::cout<<std::endl;
-
-    GroupKmerMap group_kmer_counts_map;
+    mStats.setCount("reads_searched", search_counters.reads);
+    mStats.setCount("reads_rejected_by_prefilter", search_counters.prefilterRejects);
+    if (search_counters.reads > 0) 
+    {
+        double reject_rate = static_cast<double>(search_counters.prefilterRejects) / search_counters.reads;
+        mStats.setRate("prefilter_reject_rate", reject_rate);
+        logInfo("Prefilter rejected "<<search_counters.prefilterRejects<<" of "<<search_counters.reads<<" reads ("<<reject_rate * 100<<"%)", 2);
+    }
+    mStats.setCount("reads_with_repeated_kmers", search_counters.repeatedKmers);
+    mStats.setCount("reads_with_repeat_length_in_range", search_counters.repeatLength);
+    mStats.setCount("reads_passing_search", search_counters.passedQc);
+    mStats.setCount("dr_variants_from_search", mReads.size());
+    mStats.setCount("found_header_set_bytes", reads_found.memoryUsage());
+
+    mStats.startStage("singletons");
+    GroupIdList clustered_GIDs;
     int next_free_GID = 1;
-    Vecstr * non_redundant_set = createNonRedundantSet(group_kmer_counts_map, next_free_GID);
+    Vecstr * non_redundant_set = createNonRedundantSet(clustered_GIDs, next_free_GID);
     logInfo("Number of reads found so far: "<<this->numOfReads(), 2);
+    mStats.setCount("non_redundant_patterns", non_redundant_set->size());
 
     if (non_redundant_set->size() > 0) 
     {
@@ -378,29 +397,57 @@ int WorkHorse::parseSeqFiles(Vecstr seqFiles)
 
 
         time(&start_time);
-        while (seq_iter != seqFiles.end()) {
-            
-            logInfo("Parsing file: " << *seq_iter, 1);
-            
-            try {
-                findSingletons(seq_iter->c_str(), *mOpts, non_redundant_set, reads_found, &mReads, &mStringCheck, start_time);
-            } catch (crispr::exception& e) {
-                std::cerr<<e.what()<<std::endl;
+        if (spill != NULL) 
+        {
+            if (recruitSpilledSingletons(seqFiles, spill, non_redundant_set, reads_found, start_time)) 
+            {
                 delete non_redundant_set;
+                delete spill;
                 return 1;
             }
-            seq_iter++;
+        } 
+        else 
+        {
+            while (seq_iter != seqFiles.end()) {
+                
+                logInfo("Parsing file: " << *seq_iter, 1);
+                
+                try {
+                    findSingletons(seq_iter->c_str(), *mOpts, non_redundant_set, reads_found, &mReads, &mReadStore, &mStringCheck, start_time);
+                } catch (crispr::exception& e) {
+                    std::cerr<<e.what()<<std::endl;
+                    delete non_redundant_set;
+                    return 1;
+                }
+                seq_iter++;
+            }
         }
     }
     // add in a new line so the ouptut won't overlap itself
     std::cout<<std::endl;
     delete non_redundant_set;
+    // removes the spill file
+    delete spill;
     std::cout<<"["<<PACKAGE_NAME<<"_patternFinder]: "<<"Found "<<numOfReads()<<" reads"<<std::endl;
     logInfo("Searching complete. " << mReads.size()<<" direct repeat variants have been found", 1);
     logInfo("Number of reads found so far: "<<this->numOfReads(), 2);
+    mStats.setCount("reads_found", numOfReads());
+    mStats.setCount("dr_variants", mReads.size());
+    mStats.setCount("reads_stored", mReadStore.size());
+    mStats.setCount("read_store_bytes", mReadStore.memoryUsage());
+    mStats.setCount("read_store_spilled_bytes", mReadStore.spilledBytes());
+    mStats.setCount("reads_deduplicated", mReadStore.numDuplicates());
+    logInfo("Read store holds "<<mReadStore.size()<<" reads in "<<mReadStore.memoryUsage()<<" bytes, "<<mReadStore.spilledBytes()<<" bytes spilled to disk", 2);
+    logInfo(mReadStore.numDuplicates()<<" reads were copies of a stored read", 2);
+    
+    // reads are about to be turned around and moved, so nothing more 
+    // can be looked up
+    mReadStore.setDeduplicate(false);
+
+    mStats.startStage("findConsensusDRs");
 
     try {
-        if (findConsensusDRs(group_kmer_counts_map, next_free_GID))
+        if (findConsensusDRs(clustered_GIDs, next_free_GID))
         {
             logError("Wierd stuff happend when trying to get the 'true' direct repeat");            
             return 1;
@@ -409,136 +456,321 @@ int WorkHorse::parseSeqFiles(Vecstr seqFiles)
         std::cerr<<e.what()<<std::endl;
         return 1;
     }
+    mStats.endStage();
     
+    int num_clusters = 0;
+    DR_Cluster_MapIterator drg_iter;
+    for (drg_iter = mDR2GIDMap.begin(); drg_iter != mDR2GIDMap.end(); ++drg_iter) 
+    {
+        if (NULL != drg_iter->second) 
+        {
+            num_clusters++;
+        }
+    }
+    mStats.setCount("dr_clusters", num_clusters);
+    
+    return 0;
+}
+
+int WorkHorse::recruitSpilledSingletons(Vecstr& seqFiles, 
+                                        SingletonSpill * spill, 
+                                        Vecstr * nonRedundantSet, 
+                                        HeaderSet& readsFound, 
+                                        time_t& startTime)
+{
+    //-----
+    // The second pass for single pass mode. Reads that came before the last
+    // new direct repeat was found could not be filtered properly, so those
+    // are read again from the input files. Everything after that is in 
+    // the spill file already. The reads get recruited in the same order as
+    // a full second pass so the results are identical
+    //
+    spill->close();
+    logInfo("Rescanning "<<spill->lastFileToRescan() + 1<<" input file(s) up to read "<<spill->readsToRescan()<<" of the last one", 2);
+    logInfo(spill->numSpilled() - spill->spilledReadsToSkip()<<" of "<<spill->numSpilled()<<" spilled reads still need to be scanned", 2);
+    try {
+        for (int i = 0; i <= spill->lastFileToRescan(); i++) 
+        {
+            logInfo("Parsing file: " << seqFiles[i], 1);
+            long max_reads = (i == spill->lastFileToRescan()) ? spill->readsToRescan() : -1;
+            findSingletons(seqFiles[i].c_str(), *mOpts, nonRedundantSet, readsFound, &mReads, &mReadStore, &mStringCheck, startTime, 0, max_reads);
+        }
+        logInfo("Parsing file: " << spill->getFileName(), 1);
+        findSingletons(spill->getFileName().c_str(), *mOpts, nonRedundantSet, readsFound, &mReads, &mReadStore, &mStringCheck, startTime, spill->spilledReadsToSkip(), -1);
+    } catch (crispr::exception& e) {
+        std::cerr<<e.what()<<std::endl;
+        return 1;
+    }
     return 0;
 }
 
-void WorkHorse::combineGroupsWithIdenticalDRs()
+void WorkHorse::combineGroupsWithIdenticalDRs(std::map<std::string, int>& trueDRGroups, const std::vector<int>& newGIDs)
 {
     //----
     // After parseGroupedDRs there will be occasions where the final true DR
     // is identical between different groups. Here we explicently check for
-    // this and combine the groups as necessary
-    std::map<std::string, int> truedr_to_group;
+    // this and combine the groups as necessary. The groups that were there
+    // before all have different true DRs so only the new ones need looking
+    // at. Each lot of identical groups go into the one with the smallest 
+    // GID, the others are added to it in order
+    std::map<std::string, std::vector<int> > identical_groups;
+    std::vector<int>::const_iterator gid_iter;
+    for (gid_iter = newGIDs.begin(); gid_iter != newGIDs.end(); ++gid_iter)
+    {
+        std::map<int, std::string>::iterator true_dr_iter = mTrueDRs.find(*gid_iter);
+        if (true_dr_iter != mTrueDRs.end())
+        {
+            identical_groups[true_dr_iter->second].push_back(*gid_iter);
+        }
+    }
 
-    std::map<int, std::string>::iterator iter = mTrueDRs.begin();
-    while(iter != mTrueDRs.end())
+    std::map<std::string, std::vector<int> >::iterator ig_iter;
+    for (ig_iter = identical_groups.begin(); ig_iter != identical_groups.end(); ++ig_iter)
     {
-        std::map<std::string, int>::iterator prev_iter = truedr_to_group.find(iter->second);
-        if(prev_iter != truedr_to_group.end())
+        std::vector<int>& groups = ig_iter->second;
+        std::map<std::string, int>::iterator prev_iter = trueDRGroups.find(ig_iter->first);
+        if (prev_iter != trueDRGroups.end())
+        {
+            groups.push_back(prev_iter->second);
+        }
+        std::sort(groups.begin(), groups.end());
+        trueDRGroups[ig_iter->first] = groups.front();
+        for (size_t i = 1; i < groups.size(); i++)
         {
             // this true DR has already been identified
-            logInfo("Combining groups "<<iter->first<<" ("<<iter->second<<") and "<<prev_iter->second << " ("<<prev_iter->first<<") as they are identical",4);
+            logInfo("Combining groups "<<groups[i]<<" ("<<ig_iter->first<<") and "<<groups.front() << " ("<<ig_iter->first<<") as they are identical",4);
             // combine the DR2GID_map
             DR_ClusterIterator drc_iter;
-            for(drc_iter = mDR2GIDMap[iter->first]->begin(); drc_iter != mDR2GIDMap[iter->first]->end(); ++drc_iter)
+            for(drc_iter = mDR2GIDMap[groups[i]]->begin(); drc_iter != mDR2GIDMap[groups[i]]->end(); ++drc_iter)
             {
                 logInfo(*drc_iter, 1);
-                mDR2GIDMap[prev_iter->second]->push_back(*drc_iter);
+                mDR2GIDMap[groups.front()]->push_back(*drc_iter);
             }
             
             // delete the references to this group in DR2GID_map
-            delete mDR2GIDMap[iter->first];
-            mDR2GIDMap.erase(iter->first);
+            delete mDR2GIDMap[groups[i]];
+            mDR2GIDMap.erase(groups[i]);
             // remove the reference in the true DRs
-            mTrueDRs.erase(iter++);
-        }
-        else
-        {
-            truedr_to_group[iter->second] = iter->first;
-            ++iter;
+            mTrueDRs.erase(groups[i]);
         }
     }
 }
 
-int WorkHorse::buildGraph(void)
+int WorkHorse::makeGraphs(void)
 {
 	//-----
-	// Load the spacers into a graph
+	// Load the spacers into a graph for each group then clean it, make
+	// the spacer graph and the contigs and call the flankers
 	//
-    // go through the DR2GID_map and make all reads in each group into nodes
-    
+	logInfo("Making graphs", 1);
+    std::vector<GraphWork *> work_list;
     DR_Cluster_MapIterator drg_iter = mDR2GIDMap.begin();
-    //std::cout<<'['<<PACKAGE_NAME<<"_graphBuilder]: "<<mTrueDRs.size()<<" putative CRISPRs found!"<<std::endl;
-    //MI std::cout<<'['<<PACKAGE_NAME<<"_graphBuilder]: "<<std::flush;
     while(drg_iter != mDR2GIDMap.end())
     {
         if(NULL != drg_iter->second)
-        {            
-#ifdef DEBUG
-            logInfo("Creating NodeManager "<<drg_iter->first, 6);
-#endif
-            //MI std::cout<<'['<<drg_iter->first<<','<<mTrueDRs[drg_iter->first]<<std::flush;
-            mDRs[mTrueDRs[drg_iter->first]] = new NodeManager(mTrueDRs[drg_iter->first], mOpts);
-            //MI std::cout<<'.'<<std::flush;
-            DR_ClusterIterator drc_iter = (drg_iter->second)->begin();
-            while(drc_iter != (drg_iter->second)->end())
+        {
+            GraphWork * work = new GraphWork;
+            work->workHorse = this;
+            work->GID = drg_iter->first;
+            work->cluster = drg_iter->second;
+            work->trueDR = mTrueDRs[drg_iter->first];
+            work->manager = NULL;
+            work->failed = false;
+            for (int phase = 0; phase < WH_NUM_GRAPH_PHASES; phase++)
             {
-                // go through each read
-            	//MI std::cout<<'|'<<std::flush;
-                ReadListIterator read_iter = mReads[*drc_iter]->begin();
-                while (read_iter != mReads[*drc_iter]->end()) 
-                {
-                    if(*read_iter == NULL) {
-                        logError("Read is set to null");
-                    }
-                    //MI std::cout<<'.'<<std::flush;
-#ifdef SEARCH_SINGLETON
-                    SearchCheckerList::iterator debug_iter = debugger->find((*read_iter)->getHeader());
-                    if (debug_iter != debugger->end()) {
-                        //found one of our interesting reads
-                        // add in the true DR
-                        debug_iter->second.truedr(mTrueDRs[drg_iter->first]);
-                        debug_iter->second.gid(drg_iter->first);
-                    }
-#endif
-                    mDRs[mTrueDRs[drg_iter->first]]->addReadHolder(*read_iter);
-                    read_iter++;
-                }
-                drc_iter++;
+                work->wallSeconds[phase] = 0;
+                work->cpuSeconds[phase] = 0;
             }
-            //MI std::cout<<"],"<<std::flush;
+            work_list.push_back(work);
         }
         drg_iter++;
     }
-    //MI std::cout<<std::endl;
+
+    {
+        // the biggest groups go first so that one isn't left running on
+        // its own at the end
+        std::vector<std::pair<int, size_t> > by_size;
+        for (size_t i = 0; i < work_list.size(); i++)
+        {
+            by_size.push_back(std::pair<int, size_t>(-numberOfReadsInGroup(work_list[i]->cluster), i));
+        }
+        std::sort(by_size.begin(), by_size.end());
+        ThreadPool pool(mOpts->numThreads);
+        for (size_t i = 0; i < by_size.size(); i++)
+        {
+            pool.submit(WorkHorse::graphWorkTask, work_list[by_size[i].second]);
+        }
+        pool.waitAll();
+    }
+
+    //-----
+    // each phase gets a row in the stats. The groups were made side by
+    // side so with more than one thread the wall times add up to more
+    // than the time that went by
+    //
+    static const char * phase_names[WH_NUM_GRAPH_PHASES] = {
+        "buildGraph",
+        "cleanGraph",
+        "makeSpacerGraphs",
+        "cleanSpacerGraphs",
+        "splitIntoContigs",
+        "generateFlankers"
+    };
+    for (int phase = 0; phase < WH_NUM_GRAPH_PHASES; phase++)
+    {
+        double wall_seconds = 0;
+        double cpu_seconds = 0;
+        for (size_t i = 0; i < work_list.size(); i++)
+        {
+            wall_seconds += work_list[i]->wallSeconds[phase];
+            cpu_seconds += work_list[i]->cpuSeconds[phase];
+        }
+        mStats.addStage(phase_names[phase], wall_seconds, cpu_seconds);
+    }
+
+    //-----
+    // hand the NodeManagers over in GID order, as they would have been
+    // made one after the other
+    //
+    std::string error_msg;
+    for (size_t i = 0; i < work_list.size(); i++)
+    {
+        if (work_list[i]->failed && error_msg.empty())
+        {
+            error_msg = work_list[i]->errorMsg;
+        }
+    }
+    for (size_t i = 0; i < work_list.size(); i++)
+    {
+        if (error_msg.empty())
+        {
+            mDRs[work_list[i]->trueDR] = work_list[i]->manager;
+        }
+        else
+        {
+            delete work_list[i]->manager;
+        }
+        delete work_list[i];
+    }
+    if (! error_msg.empty())
+    {
+        std::cerr<<PACKAGE_NAME<<" [ERROR]: "<<error_msg<<std::endl;
+        logWarn("FATAL ERROR: makeGraphs failed: "<<error_msg, 1);
+        return 1;
+    }
     return 0;
 }
 
-int WorkHorse::cleanGraph(void)
+void WorkHorse::graphWorkTask(void * arg)
 {
-	//-----
-	// Wrapper for graph cleaning
-	//
-	logInfo("Cleaning graphs", 1);
-	DR_Cluster_MapIterator drg_iter = mDR2GIDMap.begin();
-	while(drg_iter != mDR2GIDMap.end())
-	{
-		if(NULL != drg_iter->second)
-		{            
+    GraphWork * work = static_cast<GraphWork *>(arg);
+    try {
+        (work->workHorse)->makeGraph(*work);
+    } catch (crispr::exception& e) {
+        work->failed = true;
+        work->errorMsg = e.what();
+    } catch (std::exception& e) {
+        work->failed = true;
+        work->errorMsg = e.what();
+    }
+}
+
+void WorkHorse::makeGraph(GraphWork& work)
+{
+    work.phaseWallStart = PipelineStats::wallClock();
+    work.phaseCpuStart = PipelineStats::threadCpuClock();
 #ifdef DEBUG
-            if (NULL == mDRs[mTrueDRs[drg_iter->first]])
-            {
-                logWarn("Before Clean Graph: NodeManager "<<drg_iter->first<<" is NULL",6);
-            }
-            else
-            {
+    logInfo("Creating NodeManager "<<work.GID, 6);
 #endif
-                if((mDRs[mTrueDRs[drg_iter->first]])->cleanGraph())
-                {
-                    return 1;
-                }
-#ifdef DEBUG
-            }
-            if (NULL == mDRs[mTrueDRs[drg_iter->first]])
-            {
-                logWarn("After Clean Graph: NodeManager "<<drg_iter->first<<" is NULL",6);
+    NodeManager * manager = new NodeManager(work.trueDR, mOpts, &mReadStore);
+    work.manager = manager;
+    DR_ClusterIterator drc_iter = (work.cluster)->begin();
+    while(drc_iter != (work.cluster)->end())
+    {
+        // go through each read, other tasks are looking in mReads as well
+        // so it is only ever searched
+        ReadMapIterator reads_iter = mReads.find(*drc_iter);
+        if (reads_iter == mReads.end())
+        {
+            drc_iter++;
+            continue;
+        }
+        ReadListIterator read_iter = (reads_iter->second)->begin();
+        while (read_iter != (reads_iter->second)->end()) 
+        {
+#ifdef SEARCH_SINGLETON
+            SearchCheckerList::iterator debug_iter = debugger->find(mReadStore.getHeader(*read_iter));
+            if (debug_iter != debugger->end()) {
+                //found one of our interesting reads
+                // add in the true DR
+                debug_iter->second.truedr(work.trueDR);
+                debug_iter->second.gid(work.GID);
             }
 #endif
-		}
-		drg_iter++;
-	}
-	return 0;
+            manager->addReadHolder(*read_iter);
+            read_iter++;
+        }
+        drc_iter++;
+    }
+	
+#if DEBUG
+	if (!mOpts->noDebugGraph) // this option will only exist if DEBUG is set anyway
+    {
+        renderDebugGraph(work.GID, work.trueDR, manager, "Group_");
+    }
+#endif
+
+    endGraphPhase(work, WH_BUILD_GRAPH);
+
+    logInfo("Cleaning graph for DR: " << work.trueDR, 1);
+    int graph_failed = manager->cleanGraph();
+    endGraphPhase(work, WH_CLEAN_GRAPH);
+    if(graph_failed)
+    {
+        work.failed = true;
+        work.errorMsg = "cleanGraph failed for group " + to_string(work.GID);
+        return;
+    }
+    logInfo("Making spacer graph for DR: " << work.trueDR, 1);
+    graph_failed = manager->buildSpacerGraph();
+    endGraphPhase(work, WH_MAKE_SPACER_GRAPH);
+    if(graph_failed)
+    {
+        work.failed = true;
+        work.errorMsg = "buildSpacerGraph failed for group " + to_string(work.GID);
+        return;
+    }
+    logInfo("Cleaning spacer graph for DR: " << work.trueDR, 1);
+    graph_failed = manager->cleanSpacerGraph();
+    endGraphPhase(work, WH_CLEAN_SPACER_GRAPH);
+    if(graph_failed)
+    {
+        work.failed = true;
+        work.errorMsg = "cleanSpacerGraph failed for group " + to_string(work.GID);
+        return;
+    }
+    logInfo("Making spacer contigs for DR: " << work.trueDR, 1);
+    graph_failed = manager->splitIntoContigs();
+    endGraphPhase(work, WH_SPLIT_INTO_CONTIGS);
+    if(graph_failed)
+    {
+        work.failed = true;
+        work.errorMsg = "splitIntoContigs failed for group " + to_string(work.GID);
+        return;
+    }
+    logInfo("Assigning flankers for NodeManager "<<work.GID, 3);
+    manager->generateFlankers();
+    endGraphPhase(work, WH_GENERATE_FLANKERS);
+}
+
+void WorkHorse::endGraphPhase(GraphWork& work, GRAPH_PHASE phase)
+{
+    double wall_now = PipelineStats::wallClock();
+    double cpu_now = PipelineStats::threadCpuClock();
+    work.wallSeconds[phase] += wall_now - work.phaseWallStart;
+    work.cpuSeconds[phase] += cpu_now - work.phaseCpuStart;
+    work.phaseWallStart = wall_now;
+    work.phaseCpuStart = cpu_now;
 }
 
 int WorkHorse::removeLowConfidenceNodeManagers(void)
@@ -575,7 +807,7 @@ int WorkHorse::removeLowConfidenceNodeManagers(void)
 //**************************************
 // Functions used to cluster DRs into groups and identify the "true" DR
 //**************************************
-int WorkHorse::findConsensusDRs(GroupKmerMap& groupKmerCountsMap, int& nextFreeGID)
+int WorkHorse::findConsensusDRs(GroupIdList& clusteredGIDs, int& nextFreeGID)
 {
     //-----
     // Cluster potential DRs and work out their true sequences
@@ -584,31 +816,154 @@ int WorkHorse::findConsensusDRs(GroupKmerMap& groupKmerCountsMap, int& nextFreeG
 
     logInfo("Reducing list of potential DRs (2): Cluster refinement and true DR finding", 1);
     
-    // go through all the counts for each group
-    GroupKmerMap::iterator group_count_iter; 
-    for(group_count_iter =  groupKmerCountsMap.begin(); 
-        group_count_iter != groupKmerCountsMap.end(); 
-        group_count_iter++)
+    // go through each group made by the initial clustering, new groups
+    // split off by parseGroupedDRs are already finished. The groups share
+    // nothing but the reads, which each only touches its own of, so they
+    // can all be worked on at once
+    std::vector<GroupWork *> work_list;
+    GroupIdList::iterator gid_iter; 
+    for(gid_iter = clusteredGIDs.begin(); 
+        gid_iter != clusteredGIDs.end(); 
+        gid_iter++)
     {
-        if(NULL == mDR2GIDMap[group_count_iter->first])
+        if(NULL == mDR2GIDMap[*gid_iter])
         {
             continue;
         }
 #ifdef DEBUG
-        logInfo(__FILE__ <<":"<<__LINE__<<" checking for null "<< mDR2GIDMap[group_count_iter->first], 6)
+        logInfo(__FILE__ <<":"<<__LINE__<<" checking for null "<< mDR2GIDMap[*gid_iter], 6)
 #endif
-        parseGroupedDRs(group_count_iter->first, &nextFreeGID);
-        combineGroupsWithIdenticalDRs();
-        // delete the kmer count lists cause we're finsihed with them now
-        if(NULL != group_count_iter->second)
+        work_list.push_back(makeGroupWork(*gid_iter));
+    }
+
+    {
+        // the biggest groups go first so that one isn't left running on
+        // its own at the end
+        std::vector<std::pair<int, size_t> > by_size;
+        for (size_t i = 0; i < work_list.size(); i++)
+        {
+            by_size.push_back(std::pair<int, size_t>(-numberOfReadsInGroup(mDR2GIDMap[work_list[i]->GID]), i));
+        }
+        std::sort(by_size.begin(), by_size.end());
+        ThreadPool pool(mOpts->numThreads);
+        for (size_t i = 0; i < by_size.size(); i++)
         {
-            delete group_count_iter->second;
-            group_count_iter->second = NULL;
+            pool.submit(WorkHorse::groupWorkTask, work_list[by_size[i].second]);
+        }
+        pool.waitAll();
+    }
+
+    //-----
+    // merged back in the order the groups were made so they end up with 
+    // the same tokens and GIDs as they would have one after the other
+    //
+    std::map<std::string, int> true_dr_groups;
+    std::map<int, std::string>::iterator true_dr_iter;
+    for (true_dr_iter = mTrueDRs.begin(); true_dr_iter != mTrueDRs.end(); ++true_dr_iter)
+    {
+        true_dr_groups[true_dr_iter->second] = true_dr_iter->first;
+    }
+    for (size_t i = 0; i < work_list.size(); i++)
+    {
+        if (work_list[i]->failed)
+        {
+            std::string error_msg = work_list[i]->errorMsg;
+            for (; i < work_list.size(); i++)
+            {
+                delete work_list[i];
+            }
+            throw crispr::exception(__FILE__,
+                                    __LINE__,
+                                    __PRETTY_FUNCTION__,
+                                    error_msg.c_str());
         }
+        std::vector<int> new_GIDs;
+        mergeGroupWork(work_list[i], nextFreeGID, new_GIDs);
+        delete work_list[i];
+        combineGroupsWithIdenticalDRs(true_dr_groups, new_GIDs);
     }
     
     return 0;
 }
+
+void WorkHorse::groupWorkTask(void * arg)
+{
+    GroupWork * work = static_cast<GroupWork *>(arg);
+    try {
+        (work->workHorse)->parseGroupedDRs(*work, work->GID, &(work->nextFreeGID));
+    } catch (crispr::exception& e) {
+        work->failed = true;
+        work->errorMsg = e.what();
+    } catch (std::exception& e) {
+        work->failed = true;
+        work->errorMsg = e.what();
+    }
+}
+
+WorkHorse::GroupWork * WorkHorse::makeGroupWork(int GID)
+{
+    GroupWork * work = new GroupWork;
+    work->workHorse = this;
+    work->GID = GID;
+    work->nextFreeGID = GID + 1;
+    work->failed = false;
+    DR_Cluster * local_cluster = new DR_Cluster;
+    DR_ClusterIterator dr_iter;
+    for (dr_iter = mDR2GIDMap[GID]->begin(); dr_iter != mDR2GIDMap[GID]->end(); ++dr_iter)
+    {
+        StringToken local_token = work->strings.addString(mStringCheck.getString(*dr_iter));
+        work->tokens.push_back(*dr_iter);
+        work->reads[local_token] = mReads[*dr_iter];
+        local_cluster->push_back(local_token);
+    }
+    work->clusters[GID] = local_cluster;
+    return work;
+}
+
+void WorkHorse::mergeGroupWork(GroupWork * work, int& nextFreeGID, std::vector<int>& newGIDs)
+{
+    //-----
+    // DRs made while working on the group get their tokens in the order 
+    // they were made, then the new groups are numbered on from 
+    // nextFreeGID in the order they were made
+    //
+    StringCheck& local_check = work->strings;
+    std::vector<StringToken> real_tokens(work->tokens);
+    for (StringToken local_token = local_check.firstToken() + static_cast<StringToken>(work->tokens.size()); local_token <= local_check.mNextFreeToken; local_token++)
+    {
+        real_tokens.push_back(mStringCheck.addString(local_check.getString(local_token)));
+    }
+    ReadMapIterator read_iter;
+    for (read_iter = work->reads.begin(); read_iter != work->reads.end(); ++read_iter)
+    {
+        mReads[real_tokens[read_iter->first - local_check.firstToken()]] = read_iter->second;
+    }
+
+    delete mDR2GIDMap[work->GID];
+    DR_Cluster_MapIterator cluster_iter;
+    for (cluster_iter = work->clusters.begin(); cluster_iter != work->clusters.end(); ++cluster_iter)
+    {
+        if (NULL != cluster_iter->second)
+        {
+            DR_ClusterIterator dr_iter;
+            for (dr_iter = (cluster_iter->second)->begin(); dr_iter != (cluster_iter->second)->end(); ++dr_iter)
+            {
+                *dr_iter = real_tokens[*dr_iter - local_check.firstToken()];
+            }
+        }
+        int real_GID = (cluster_iter->first == work->GID) ? work->GID : nextFreeGID + cluster_iter->first - (work->GID + 1);
+        mDR2GIDMap[real_GID] = cluster_iter->second;
+    }
+    std::map<int, std::string>::iterator true_dr_iter;
+    for (true_dr_iter = work->trueDRs.begin(); true_dr_iter != work->trueDRs.end(); ++true_dr_iter)
+    {
+        int real_GID = (true_dr_iter->first == work->GID) ? work->GID : nextFreeGID + true_dr_iter->first - (work->GID + 1);
+        mTrueDRs[real_GID] = true_dr_iter->second;
+        newGIDs.push_back(real_GID);
+    }
+    nextFreeGID += work->nextFreeGID - (work->GID + 1);
+}
+
 void WorkHorse::removeRedundantRepeats(Vecstr& repeatVector)
 {
     // given a vector of repeat sequences, will order the vector based on repeat
@@ -645,7 +1000,7 @@ void WorkHorse::removeRedundantRepeats(Vecstr& repeatVector)
 }
 
 
-Vecstr * WorkHorse::createNonRedundantSet(GroupKmerMap& groupKmerCountsMap, int& nextFreeGID)
+Vecstr * WorkHorse::createNonRedundantSet(GroupIdList& clusteredGIDs, int& nextFreeGID)
 {
     // cluster the direct repeats then remove the redundant ones
     // creates a vector in dynamic memory, so don't forget to delete 
@@ -653,16 +1008,9 @@ Vecstr * WorkHorse::createNonRedundantSet(GroupKmerMap& groupKmerCountsMap, int&
     // Cluster potential DRs and work out their true sequences
     // make the node managers while we're at it!
     //
-    std::map<std::string, int> k2GID_map;
     logInfo("Reducing list of potential DRs (1): Initial clustering", 1);
     logInfo("Reticulating splines...", 1);    
-    // go through all of the read holder objects
-    ReadMapIterator read_map_iter = mReads.begin();
-    while (read_map_iter != mReads.end()) 
-    {
-        clusterDRReads(read_map_iter->first, &nextFreeGID, &k2GID_map, &groupKmerCountsMap);
-        ++read_map_iter;
-    }
+    clusterDRs(nextFreeGID, clusteredGIDs);
     std::cout<<'['<<PACKAGE_NAME<<"_clusterCore]: "<<mReads.size()<<" variants mapped to "<<mDR2GIDMap.size()<<" clusters"<<std::endl;
     std::cout<<'['<<PACKAGE_NAME<<"_clusterCore]: creating non-redundant set"<<std::endl;
 
@@ -708,7 +1056,7 @@ Vecstr * WorkHorse::createNonRedundantSet(GroupKmerMap& groupKmerCountsMap, int&
     return non_redundant_repeats;
 }
 
-bool WorkHorse::findMasterDR(int GID, StringToken&  masterDRToken)
+bool WorkHorse::findMasterDR(GroupWork& work, int GID, StringToken&  masterDRToken)
 {
 	//-----
 	// Identify a master DR
@@ -723,13 +1071,13 @@ bool WorkHorse::findMasterDR(int GID, StringToken&  masterDRToken)
     
     logInfo("Identifying a master DR", 1);
 
-    DR_Cluster * current_dr_cluster = mDR2GIDMap[GID];
+    DR_Cluster * current_dr_cluster = work.clusters[GID];
     size_t current_longest_size = 0;
     DR_ClusterIterator dr_iter;// = dr_cluster->begin();
     
     for (dr_iter = current_dr_cluster->begin(); dr_iter != current_dr_cluster->end(); ++dr_iter) {
 
-        std::string tmp_dr_seq = mStringCheck.getString(*dr_iter);
+        std::string tmp_dr_seq = work.strings.getString(*dr_iter);
         if (tmp_dr_seq.size() > current_longest_size) {
             masterDRToken = *dr_iter;
 
@@ -740,14 +1088,14 @@ bool WorkHorse::findMasterDR(int GID, StringToken&  masterDRToken)
     {
         logError("Could not identify a master DR");
     }
-    logInfo("Identified: " << mStringCheck.getString(masterDRToken) << " (" << masterDRToken << ") as a master potential DR", 4);
+    logInfo("Identified: " << work.strings.getString(masterDRToken) << " (" << masterDRToken << ") as a master potential DR", 4);
 
 
     
     return true;
 }
 
-bool WorkHorse::populateCoverageArray(int GID, Aligner& drAligner)
+bool WorkHorse::populateCoverageArray(GroupWork& work, int GID, Aligner& drAligner)
 {
 	//-----
 	// Use the data structures initialised in parseGroupedDRs
@@ -755,14 +1103,14 @@ bool WorkHorse::populateCoverageArray(int GID, Aligner& drAligner)
 	//
 	logInfo("Populating consensus array", 1);
 #ifdef DEBUG
-    logInfo(__FILE__ <<":"<<__LINE__<<" checking for null "<< mDR2GIDMap[GID], 6)
+    logInfo(__FILE__ <<":"<<__LINE__<<" checking for null "<< work.clusters[GID], 6)
 #endif
 
     //++++++++++++++++++++++++++++++++++++++++++++++++
     // now go thru all the other DRs in this group and add them into
     // the consensus array
-    DR_ClusterIterator dr_iter;// = (mDR2GIDMap[GID])->begin();
-    for (dr_iter = (mDR2GIDMap[GID])->begin(); dr_iter != (mDR2GIDMap[GID])->end(); dr_iter++) 
+    DR_ClusterIterator dr_iter;// = (work.clusters[GID])->begin();
+    for (dr_iter = (work.clusters[GID])->begin(); dr_iter != (work.clusters[GID])->end(); dr_iter++) 
     {
         // we've already done the master DR
         if(drAligner.getMasterDrToken() == *dr_iter)
@@ -772,8 +1120,8 @@ bool WorkHorse::populateCoverageArray(int GID, Aligner& drAligner)
         drAligner.alignSlave(*dr_iter);
     }
     // kill the unfounded ones
-    dr_iter = (mDR2GIDMap[GID])->begin();
-    while (dr_iter != (mDR2GIDMap[GID])->end()) 
+    dr_iter = (work.clusters[GID])->begin();
+    while (dr_iter != (work.clusters[GID])->end()) 
     {
     	if(drAligner.offsetFind(*dr_iter) != drAligner.offsetEnd())
     	{
@@ -782,10 +1130,10 @@ bool WorkHorse::populateCoverageArray(int GID, Aligner& drAligner)
 #ifdef DEBUG
                 logInfo("clearing unaligned slave "<<*dr_iter, 6)
 #endif
-                if (NULL != mReads[*dr_iter]) {
-                    clearReadList(mReads[*dr_iter]);
-                    mReads[*dr_iter] = NULL;
-                    dr_iter = mDR2GIDMap[GID]->erase(dr_iter);
+                if (NULL != work.reads[*dr_iter]) {
+                    clearReadList(work.reads[*dr_iter]);
+                    work.reads[*dr_iter] = NULL;
+                    dr_iter = work.clusters[GID]->erase(dr_iter);
                     continue;
                 }
 
@@ -798,7 +1146,8 @@ bool WorkHorse::populateCoverageArray(int GID, Aligner& drAligner)
 } 
 
 
-std::string WorkHorse::calculateDRConsensus(int GID, 
+std::string WorkHorse::calculateDRConsensus(GroupWork& work,
+                                            int GID, 
                                             Aligner& drAligner, 
                                             int& nextFreeGID,
                                             int& collapsedPos,
@@ -871,10 +1220,10 @@ std::string WorkHorse::calculateDRConsensus(int GID,
 				// is this seen at the DR level?
 				refinedDREnds[i] = false;
 				std::map<char, int> collapsed_options2;
-				DR_ClusterIterator dr_iter = (mDR2GIDMap[GID])->begin();
-				while (dr_iter != (mDR2GIDMap[GID])->end()) 
+				DR_ClusterIterator dr_iter = (work.clusters[GID])->begin();
+				while (dr_iter != (work.clusters[GID])->end()) 
 				{
-					std::string tmp_DR = mStringCheck.getString(*dr_iter);
+					std::string tmp_DR = work.strings.getString(*dr_iter);
 					if(-1 != drAligner.offset(*dr_iter))
 					{
 						// check if the deciding character is within range of this DR
@@ -937,7 +1286,7 @@ std::string WorkHorse::calculateDRConsensus(int GID,
 	return true_dr;
 }
 
-void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner& dr_aligner, int collapsed_pos, int GID, int * nextFreeGID) 
+void WorkHorse::splitGroupedDR(GroupWork& work, std::map<char, int>& collapsed_options, Aligner& dr_aligner, int collapsed_pos, int GID, int * nextFreeGID) 
 {
     // We need to build a bit of new infrastructure.
     // assume we have K different DR alleles and N putative DRs
@@ -948,16 +1297,16 @@ void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner&
     while(co_iter != collapsed_options.end())
     {
         int group = (*nextFreeGID)++;
-        mDR2GIDMap[group] = new DR_Cluster;
+        work.clusters[group] = new DR_Cluster;
         coll_char_to_GID_map[co_iter->first] = group;
-        logInfo("Mapping \""<< co_iter->first << " : "  << co_iter->second << "\" to group: " << group << " "<< &mDR2GIDMap[group], 1);
+        logInfo("Mapping \""<< co_iter->first << " : "  << co_iter->second << "\" to group: " << group << " "<< &work.clusters[group], 1);
         co_iter++;
     }
 
-    DR_ClusterIterator dr_iter = (mDR2GIDMap[GID])->begin();
-    while (dr_iter != (mDR2GIDMap[GID])->end()) 
+    DR_ClusterIterator dr_iter = (work.clusters[GID])->begin();
+    while (dr_iter != (work.clusters[GID])->end()) 
     {
-        std::string tmp_DR = mStringCheck.getString(*dr_iter);
+        std::string tmp_DR = work.strings.getString(*dr_iter);
         if(-1 != dr_aligner.offset(*dr_iter))
         {
             // check if the deciding character is within range of this DR
@@ -966,7 +1315,7 @@ void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner&
                 logInfo("\tdeciding character within DR "<< *dr_iter,5);
                 // this is easy, we can compare based on this char only
                 char decision_char = tmp_DR[collapsed_pos - dr_aligner.offset(*dr_iter)];
-                (mDR2GIDMap[ coll_char_to_GID_map[ decision_char ] ])->push_back(*dr_iter);
+                (work.clusters[ coll_char_to_GID_map[ decision_char ] ])->push_back(*dr_iter);
             }
             else
             {
@@ -982,16 +1331,18 @@ void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner&
                 // First we go through just to count the forms
                 std::map<char, ReadList *> forms_map;
 
-                ReadListIterator read_iter = mReads[*dr_iter]->begin();
-                while (read_iter != mReads[*dr_iter]->end()) 
+                ReadHolder read;
+                ReadListIterator read_iter = work.reads[*dr_iter]->begin();
+                while (read_iter != work.reads[*dr_iter]->end()) 
                 {
-                    StartStopListIterator ss_iter = (*read_iter)->begin();
-                    while(ss_iter != (*read_iter)->end())
+                    mReadStore.get(*read_iter, read);
+                    StartStopListIterator ss_iter = read.begin();
+                    while(ss_iter != read.end())
                     {
                         int within_read_dec_pos = *ss_iter + dec_diff;
-                        if(within_read_dec_pos > 0 && within_read_dec_pos < (int)(*read_iter)->getSeqLength())
+                        if(within_read_dec_pos > 0 && within_read_dec_pos < (int)read.getSeqLength())
                         {
-                            char decision_char = (*read_iter)->getSeqCharAt(within_read_dec_pos);
+                            char decision_char = read.getSeqCharAt(within_read_dec_pos);
 
                             // it must be one of the collapsed options!
                             if(collapsed_options.find(decision_char) != collapsed_options.end())
@@ -1013,21 +1364,22 @@ void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner&
                             logInfo("\t\tOne form found", 5);
                             // we can just reuse the existing ReadList!
                             // find out which group this bozo is in
-                            read_iter = mReads[*dr_iter]->begin();
+                            read_iter = work.reads[*dr_iter]->begin();
                             bool break_out = false;
-                            while (read_iter != mReads[*dr_iter]->end()) 
+                            while (read_iter != work.reads[*dr_iter]->end()) 
                             {
-                                StartStopListIterator ss_iter = (*read_iter)->begin();
-                                while(ss_iter != (*read_iter)->end())
+                                mReadStore.get(*read_iter, read);
+                                StartStopListIterator ss_iter = read.begin();
+                                while(ss_iter != read.end())
                                 {
                                     int within_read_dec_pos = *ss_iter + dec_diff;
-                                    if(within_read_dec_pos > 0 && within_read_dec_pos < (int)(*read_iter)->getSeqLength())
+                                    if(within_read_dec_pos > 0 && within_read_dec_pos < (int)read.getSeqLength())
                                     {
-                                        char decision_char = (*read_iter)->getSeqCharAt(within_read_dec_pos);
+                                        char decision_char = read.getSeqCharAt(within_read_dec_pos);
                                         // it must be one of the collapsed options!
                                         if(forms_map.find(decision_char) != forms_map.end())
                                         {
-                                            (mDR2GIDMap[ coll_char_to_GID_map[ decision_char ] ])->push_back(*dr_iter);
+                                            (work.clusters[ coll_char_to_GID_map[ decision_char ] ])->push_back(*dr_iter);
                                             break_out = true;
                                             break;
                                         }
@@ -1044,11 +1396,11 @@ void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner&
                         {
                             // Something is wrong!
                             logWarn("\t\tNo reads fit the form: " << tmp_DR, 1);
-                            if(NULL != mReads[*dr_iter])
+                            if(NULL != work.reads[*dr_iter])
                             {
-                                clearReadList(mReads[*dr_iter]);
-                                delete mReads[*dr_iter];
-                                mReads[*dr_iter] = NULL;
+                                clearReadList(work.reads[*dr_iter]);
+                                delete work.reads[*dr_iter];
+                                work.reads[*dr_iter] = NULL;
                             }
                             break;
                         }
@@ -1060,38 +1412,35 @@ void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner&
                             std::map<char, ReadList *>::iterator fm_iter = forms_map.begin();
                             while(fm_iter != forms_map.end())
                             {
-                                StringToken st = mStringCheck.addString(tmp_DR);
-                                mReads[st] = new ReadList();
+                                StringToken st = work.strings.addString(tmp_DR);
+                                work.reads[st] = new ReadList();
                                 // make sure we know which readlist is which
-                                forms_map[fm_iter->first] = mReads[st];
+                                forms_map[fm_iter->first] = work.reads[st];
                                 // put the new dr_token into the right cluster
-                                (mDR2GIDMap[ coll_char_to_GID_map[ fm_iter->first ] ])->push_back(st);
+                                (work.clusters[ coll_char_to_GID_map[ fm_iter->first ] ])->push_back(st);
 
                                 // next!
                                 fm_iter++;
                             }
 
                             // put the correct reads on the correct readlist
-                            read_iter = mReads[*dr_iter]->begin();
-                            while (read_iter != mReads[*dr_iter]->end()) 
+                            read_iter = work.reads[*dr_iter]->begin();
+                            while (read_iter != work.reads[*dr_iter]->end()) 
                             {
-                                StartStopListIterator ss_iter = (*read_iter)->begin();
-                                while(ss_iter != (*read_iter)->end())
+                                mReadStore.get(*read_iter, read);
+                                StartStopListIterator ss_iter = read.begin();
+                                while(ss_iter != read.end())
                                 {
                                     int within_read_dec_pos = *ss_iter + dec_diff;
-                                    if(within_read_dec_pos > 0 && within_read_dec_pos < (int)(*read_iter)->getSeqLength())
+                                    if(within_read_dec_pos > 0 && within_read_dec_pos < (int)read.getSeqLength())
                                     {
-                                        char decision_char = (*read_iter)->getSeqCharAt(within_read_dec_pos);
+                                        char decision_char = read.getSeqCharAt(within_read_dec_pos);
 
                                         // needs to be a form we've seen before!
                                         if(forms_map.find(decision_char) != forms_map.end())
                                         {
                                             // push this readholder onto the correct list
                                             (forms_map[decision_char])->push_back(*read_iter);
-
-                                            // make the original pointer point to NULL so we don't delete twice
-                                            *read_iter = NULL;
-
                                             break;
                                         }
                                     }
@@ -1101,11 +1450,11 @@ void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner&
                             }
 
                             // nuke the old readlist
-                            if(NULL != mReads[*dr_iter])
+                            if(NULL != work.reads[*dr_iter])
                             {
-                                clearReadList(mReads[*dr_iter]);
-                                delete mReads[*dr_iter];
-                                mReads[*dr_iter] = NULL;
+                                clearReadList(work.reads[*dr_iter]);
+                                delete work.reads[*dr_iter];
+                                work.reads[*dr_iter] = NULL;
                             }                                
 
                             break;
@@ -1118,7 +1467,7 @@ void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner&
 
     // time to delete the old clustered DRs and the group from the DR2GID_map
     logInfo("\tRemoving original group "<< GID, 5);
-    cleanGroup(GID);
+    cleanGroup(work, GID);
 
     logInfo("\tCalling the parser recursively", 4);
 
@@ -1126,13 +1475,13 @@ void WorkHorse::splitGroupedDR(std::map<char, int>& collapsed_options, Aligner&
     std::map<char, int>::iterator cc_iter = coll_char_to_GID_map.begin();
     while(cc_iter != coll_char_to_GID_map.end())
     {
-        parseGroupedDRs(cc_iter->second, nextFreeGID);
+        parseGroupedDRs(work, cc_iter->second, nextFreeGID);
         cc_iter++;
     }
 }
 
 
-bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID) 
+bool WorkHorse::parseGroupedDRs(GroupWork& work, int GID, int * nextFreeGID) 
 {
 	
     //-----
@@ -1145,9 +1494,9 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
 //    if(outstream.good())
 //    {
 //        DR_ClusterIterator drc_iter;
-//        for (drc_iter = mDR2GIDMap[GID]->begin(); drc_iter != mDR2GIDMap[GID]->end(); drc_iter++) {
+//        for (drc_iter = work.clusters[GID]->begin(); drc_iter != work.clusters[GID]->end(); drc_iter++) {
 //        ReadListIterator read_iter;
-//            for (read_iter = mReads[*drc_iter]->begin(); read_iter != mReads[*drc_iter]->end(); read_iter++) {
+//            for (read_iter = work.reads[*drc_iter]->begin(); read_iter != work.reads[*drc_iter]->end(); read_iter++) {
 //                outstream << *(*read_iter)<<std::endl;
 //            }
 //        }
@@ -1158,17 +1507,17 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
     //++++++++++++++++++++++++++++++++++++++++++++++++
     // Find a Master DR for this group of DRs
     StringToken master_DR_token = -1;
-    if(!findMasterDR(GID, master_DR_token)) { return false; }
+    if(!findMasterDR(work, GID, master_DR_token)) { return false; }
     
     
     // now we have the n most abundant kmers and one DR which contains them all
     // time to rock and rrrroll!
-    Aligner dr_aligner((CRASS_DEF_CONS_ARRAY_RL_MULTIPLIER*mMaxReadLength), &mReads, &mStringCheck);
+    Aligner dr_aligner((CRASS_DEF_CONS_ARRAY_RL_MULTIPLIER*mMaxReadLength), &work.reads, &mReadStore, &work.strings);
     dr_aligner.setMasterDR(master_DR_token);
 
     //++++++++++++++++++++++++++++++++++++++++++++++++
     // Set up the master DR's array and insert this guy into the main array
-    populateCoverageArray(GID, dr_aligner );
+    populateCoverageArray(work, GID, dr_aligner );
     //++++++++++++++++++++++++++++++++++++++++++++++++
     // calculate consensus and diversity
 	// use these variables to identify and store possible
@@ -1176,11 +1525,11 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
 	int collapsed_pos = -1;
 	std::map<char, int> collapsed_options;            // holds the chars we need to split on
 	std::map<int, bool> refined_DR_ends;              // so we can update DR ends based on consensus 
-    std::string true_DR = calculateDRConsensus(GID, dr_aligner, *nextFreeGID, collapsed_pos, collapsed_options, refined_DR_ends);
+    std::string true_DR = calculateDRConsensus(work, GID, dr_aligner, *nextFreeGID, collapsed_pos, collapsed_options, refined_DR_ends);
     // check to make sure that the DR is not just some random long RE
     if((unsigned int)(true_DR.length()) > mOpts->highDRsize)
     {
-        cleanGroup(GID);
+        cleanGroup(work, GID);
         logInfo("Killed: {" << true_DR << "} cause' it was too long", 1);
         return false;
     }
@@ -1188,14 +1537,14 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
     if (collapsed_options.size() == 0) {
         if((unsigned int)(true_DR.length()) < mOpts->lowDRsize)
         {
-            cleanGroup(GID);
+            cleanGroup(work, GID);
             logInfo("Killed: {" << true_DR << "} cause' the consensus was too short... (" << true_DR.length() << " ," << collapsed_options.size() << ")", 1);
             return false;
         }
         // QC the DR again for low complexity
         if (isRepeatLowComplexity(true_DR)) 
         {
-            cleanGroup(GID);
+            cleanGroup(work, GID);
             logInfo("Killed: {" << true_DR << "} cause' the consensus was low complexity...", 1);
             return false;
         }
@@ -1204,7 +1553,7 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
         try {
             float max_frequency;
             if (drHasHighlyAbundantKmers(true_DR, max_frequency) ) {
-                cleanGroup(GID);
+                cleanGroup(work, GID);
                 logInfo("Killed: {" << true_DR << "} cause' the consensus contained highly abundant kmers: "<<max_frequency<<" > "<< CRASS_DEF_KMER_MAX_ABUNDANCE_CUTOFF, 1);
                 return false;
             }
@@ -1290,7 +1639,7 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
     
     if(collapsed_options.size() > 0)
     {
-        splitGroupedDR(collapsed_options, dr_aligner, collapsed_pos, GID, nextFreeGID);
+        splitGroupedDR(work, collapsed_options, dr_aligner, collapsed_pos, GID, nextFreeGID);
     }
     else
     {
@@ -1305,10 +1654,10 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
 
         logInfo("Found DR: " << laurenized_true_dr, 2);
         
-        mTrueDRs[GID] = laurenized_true_dr;
-        logInfo("group: "<< GID<< " associated:" << &mDR2GIDMap[GID], 5);
-        DR_ClusterIterator drc_iter = (mDR2GIDMap[GID])->begin();
-        while(drc_iter != (mDR2GIDMap[GID])->end())
+        work.trueDRs[GID] = laurenized_true_dr;
+        logInfo("group: "<< GID<< " associated:" << &work.clusters[GID], 5);
+        DR_ClusterIterator drc_iter = (work.clusters[GID])->begin();
+        while(drc_iter != (work.clusters[GID])->end())
         {
         	logInfo("\tRepeat: "<<*drc_iter, 5);
             if(dr_aligner.offsetFind(*drc_iter) == dr_aligner.offsetEnd())
@@ -1325,9 +1674,11 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
 				else 
 				{
 					// go through each read
-					ReadListIterator read_iter = mReads[*drc_iter]->begin();
-					while (read_iter != mReads[*drc_iter]->end()) 
+					ReadHolder read;
+					ReadListIterator read_iter = work.reads[*drc_iter]->begin();
+					while (read_iter != work.reads[*drc_iter]->end()) 
 					{
+						mReadStore.get(*read_iter, read);
                         //if ((dr_aligner.offset(*drc_iter) - dr_aligner.getDRZoneStart()) < 0) {
                         //   // std::stringstream ss;
                         //    std::cerr << "front offset is a negative number\ndr_aligner.offset="<<dr_aligner.offset(*drc_iter)
@@ -1344,13 +1695,14 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
                         //}
                         try {
                         //    std::cerr << "Alignment offset: "<< dr_aligner.offset(*drc_iter)<< " DR Zone Start: " <<dr_aligner.getDRZoneStart()<<std::endl;
-						    (*read_iter)->updateStartStops((dr_aligner.offset(*drc_iter) - dr_aligner.getDRZoneStart()), &true_DR, mOpts);
+						    read.updateStartStops((dr_aligner.offset(*drc_iter) - dr_aligner.getDRZoneStart()), &true_DR, mOpts);
                         } catch (crispr::exception &e) {
                             std::cerr <<dr_aligner.offset(*drc_iter) << " : "<<  dr_aligner.getDRZoneStart()<<std::endl;
                             logInfo("Dumping read set of group:", 1);
-                            for (drc_iter = (mDR2GIDMap[GID])->begin(); drc_iter != (mDR2GIDMap[GID])->end(); drc_iter++) {
-                                for (read_iter = mReads[*drc_iter]->begin(); read_iter != mReads[*drc_iter]->end(); read_iter++) {
-                                    logInfoNoPrefix( *(*read_iter), 1); 
+                            for (drc_iter = (work.clusters[GID])->begin(); drc_iter != (work.clusters[GID])->end(); drc_iter++) {
+                                for (read_iter = work.reads[*drc_iter]->begin(); read_iter != work.reads[*drc_iter]->end(); read_iter++) {
+                                    mReadStore.get(*read_iter, read);
+                                    logInfoNoPrefix(read, 1); 
                                 }
                             }
                             throw e;
@@ -1359,7 +1711,7 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
 						if (rev_comp) 
 						{
 							try {
-								(*read_iter)->reverseComplementSeq();
+								read.reverseComplementSeq();
 							} catch (crispr::exception& e) {
 								std::cerr<<e.what()<<std::endl;
 								throw crispr::exception(__FILE__,
@@ -1368,6 +1720,7 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
 								                        "Failed to reverse complement sequence");
 							}
 						}
+						mReadStore.update(*read_iter, read);
 						read_iter++;
 					}
 				}
@@ -1379,12 +1732,12 @@ bool WorkHorse::parseGroupedDRs(int GID, int * nextFreeGID)
 }
 
 
-void WorkHorse::cleanGroup(int GID)
+void WorkHorse::cleanGroup(GroupWork& work, int GID)
 {
-    if(NULL != mDR2GIDMap[GID])
+    if(NULL != work.clusters[GID])
     {
-        delete mDR2GIDMap[GID];
-        mDR2GIDMap[GID] = NULL;
+        delete work.clusters[GID];
+        work.clusters[GID] = NULL;
     }
 }
 
@@ -1395,26 +1748,22 @@ int WorkHorse::numberOfReadsInGroup(DR_Cluster * currentGroup)
     size_t number_of_reads_in_group = 0;
     while (grouped_drs_iter != currentGroup->end()) 
     {
-        number_of_reads_in_group += mReads[*grouped_drs_iter]->size();
+        ReadListIterator read_iter;
+        for (read_iter = mReads[*grouped_drs_iter]->begin(); read_iter != mReads[*grouped_drs_iter]->end(); ++read_iter) 
+        {
+            number_of_reads_in_group += mReadStore.multiplicity(*read_iter);
+        }
         ++grouped_drs_iter;
     }
     return (int)number_of_reads_in_group;
 }
 
-bool WorkHorse::clusterDRReads(StringToken DRToken, 
-                               int * nextFreeGID, 
-                               std::map<std::string, int> * k2GIDMap, 
-                               GroupKmerMap * groupKmerCountsMap)
+bool WorkHorse::clusterDRs(int& nextFreeGID, GroupIdList& clusteredGIDs)
 {
     //-----
-    // hash a DR!
+    // hash the DRs!
     //
 
-    std::string DR = mStringCheck.getString(DRToken);
-    int str_len = (int)DR.length();
-    int off = str_len - CRASS_DEF_KMER_SIZE;
-    int num_mers = off + 1;
-    
     //***************************************
     //***************************************
     //***************************************
@@ -1431,301 +1780,55 @@ bool WorkHorse::clusterDRReads(StringToken DRToken,
     //***************************************
     
     // STOLED FROM SaSSY!!!!
-    // First we cut kmers from the sequence then we use these to
-    // determine overlaps, finally we make edges
-    //
-    // When we cut kmers from a read it is like this...
+    // First we cut kmers from the sequences then we use these to
+    // determine overlaps. Any two DRs that share enough kmers go 
+    // in the same group, and so does anything they share with
     //
-    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-    // ------------------------------
-    // XXXXXXXXXXXXXXXXXXXXXXXXXX
-    // XXXXXXXXXXXXXXXXXXXXXXXXXX
-    // XXXXXXXXXXXXXXXXXXXXXXXXXX
-    // XXXXXXXXXXXXXXXXXXXXXXXXXX
-    // XXXXXXXXXXXXXXXXXXXXXXXXXX
-    //
-    // so we break the job into three parts
-    //
-    // XXXX|XXXXXXXXXXXXXXXXXXXXXX|XXXX
-    // ----|----------------------|----
-    // XXXX|XXXXXXXXXXXXXXXXXXXXXX|
-    //  XXX|XXXXXXXXXXXXXXXXXXXXXX|X
-    //   XX|XXXXXXXXXXXXXXXXXXXXXX|XX
-    //    X|XXXXXXXXXXXXXXXXXXXXXX|XXX
-    //     |XXXXXXXXXXXXXXXXXXXXXX|XXXX
-    //
-    // the first and last part may be a little slow but the middle part can fly through...
-    //
-    
-    // make a 2d array for the kmers!
-	char ** kmers = NULL;
-	int * kmer_offsets = NULL;
-	try {
-		kmers = new char*[num_mers];
-	} catch(std::exception& e) {
-		std::cerr<<"Attempting to alloc "<<num_mers<<std::endl;
-		throw crispr::exception(__FILE__, 
-		                        __LINE__, 
-		                        __PRETTY_FUNCTION__, 
-		                        e.what());
-	}
-	try {
-		for(int i = 0; i < num_mers; i++)
-		{
-			kmers[i] = new char [CRASS_DEF_KMER_SIZE+1];
-		}
-// use these offsets when we cut kmers, they are a component of the algorithm
-		kmer_offsets = new int[num_mers];              
-		for(int i = 0; i < num_mers; i++)
-		{
-			kmer_offsets[i] = i * -1; // Starts at [0, -1, -2, -3, -4, ...]
-		}
-	} catch(std::exception& e) {
-		std::cerr<<"Attempting to alloc "<<CRASS_DEF_KMER_SIZE+1<<std::endl;
-		throw crispr::exception(__FILE__, 
-		                        __LINE__, 
-		                        __PRETTY_FUNCTION__, 
-		                        e.what());
-	}
-    int pos_counter = 0;
-    
-    // a slow-ish first part
-    while(pos_counter < CRASS_DEF_KMER_SIZE)
+    std::vector<std::string> drs;
+    std::vector<StringToken> dr_tokens;
+    drs.reserve(mReads.size());
+    dr_tokens.reserve(mReads.size());
+    ReadMapIterator read_map_iter;
+    for (read_map_iter = mReads.begin(); read_map_iter != mReads.end(); ++read_map_iter) 
     {
-        for(int j = 0; j < num_mers; j++)
-        {
-            if(pos_counter >= j)
-            {
-                kmers[j][kmer_offsets[j]] = DR[pos_counter];
-            }
-            kmer_offsets[j]++;
-        }
-        pos_counter++;
+        dr_tokens.push_back(read_map_iter->first);
+        drs.push_back(mStringCheck.getString(read_map_iter->first));
     }
     
-    // this is the fast part of the loop
-    while(pos_counter < off)
-    {
-        for(int j = 0; j < num_mers; j++)
-        {
-            if(kmer_offsets[j] >= 0 && kmer_offsets[j] < CRASS_DEF_KMER_SIZE)
-            {
-                kmers[j][kmer_offsets[j]] = DR[pos_counter];
-            }
-            kmer_offsets[j]++;
-        }
-        pos_counter++;
-    }
-    
-    // an even slower ending
-    while(pos_counter < str_len)
-    {
-        for(int j = 0; j < num_mers; j++)
-        {
-            if(kmer_offsets[j] < CRASS_DEF_KMER_SIZE)
-            {
-                kmers[j][kmer_offsets[j]] = DR[pos_counter];
-            }
-            kmer_offsets[j]++;
-        }
-        pos_counter++;
-    }
+    DRClusterer clusterer(CRASS_DEF_KMER_SIZE, min_clust_membership_count, mOpts->numThreads);
+    std::vector<int> cluster_of;
+    clusterer.cluster(drs, cluster_of);
+    mStats.setCount("clustering_kmers", clusterer.numKmers());
+    mStats.setCount("clustering_index_bytes", clusterer.memoryUsage());
     
+    //-----
+    // the groups are numbered in the order of their first DR. A DR 
+    // always comes after the first DR of its cluster
     //
-    // Now the fun stuff begins:
-    //
-    Vecstr homeless_kmers;
-    std::map<int, int> group_count;
-    std::map<std::string, int> local_kmer_CountMap;
-    
-    int group = 0;
-    for(int i = 0; i < num_mers; ++i)
+    std::vector<int> group_of(drs.size(), 0);
+    for (size_t i = 0; i < drs.size(); i++) 
     {
-        // make it a string!
-        kmers[i][CRASS_DEF_KMER_SIZE] = '\0';
-        
-        std::string tmp_str(kmers[i]);
-        tmp_str = laurenize(tmp_str);
-        
-        // see if this guy has been counted LOCALLY
-        // use this list when we go to select N most abundant kmers
-        if(local_kmer_CountMap.find(tmp_str) == local_kmer_CountMap.end())
-        {
-        	// first time this kmer has been seen in this read
-            local_kmer_CountMap[tmp_str] = 1;
-        }
-        else
-        {
-            local_kmer_CountMap[tmp_str]++;
-        }
-        
-        // see if we've seen this kmer before GLOBALLY
-        std::map<std::string, int>::iterator k2g_iter = k2GIDMap->find(tmp_str);
-        if(k2g_iter == k2GIDMap->end())
+        int group;
+        if (cluster_of[i] == static_cast<int>(i)) 
         {
-            // first time we seen this one GLOBALLY
-            homeless_kmers.push_back(tmp_str);
-        }
-        else
+            group = nextFreeGID++;
+            
+            // we need to make a new entry in the group map
+            mGroupMap[group] = true;
+            mDR2GIDMap[group] = new DR_Cluster;
+            clusteredGIDs.push_back(group);
+        } 
+        else 
         {
-        	// we've seen this guy before.
-            // only do this if our guy doesn't belong to a group yet
-            if(0 == group)
-            {
-                // this kmer belongs to a group -> increment the local group count
-                std::map<int, int>::iterator this_group_iter = group_count.find(k2g_iter->second);
-                if(this_group_iter == group_count.end())
-                {
-                    group_count[k2g_iter->second] = 1;
-                }
-                else
-                {
-                    group_count[k2g_iter->second]++;
-                    // have we seen this guy enought times?
-                    if(min_clust_membership_count <= group_count[k2g_iter->second])
-                    {
-                        // we have found a group for this mofo!
-                        group = k2g_iter->second;
-                    }
-                }
-            }
+            group = group_of[cluster_of[i]];
         }
-    }
-    
-    if(0 == group)
-    {
-    	// we couldn't put our guy into a group
-        group = (*nextFreeGID)++;
-        
-        // we need to make a new entry in the group map
-        mGroupMap[group] = true;
-        mDR2GIDMap[group] = new DR_Cluster;
+        group_of[i] = group;
         
-        // we need a new kmer counter for this group
-        (*groupKmerCountsMap)[group] = new std::map<std::string, int>;
-    }
-    
-    // we need to record the group for this mofo!
-    mDR2GIDMap[group]->push_back(DRToken);
-    
-    // we need to assign all homeless kmers to the group!
-    Vecstr::iterator homeless_iter = homeless_kmers.begin();
-    while(homeless_iter != homeless_kmers.end())
-    {
-        (*k2GIDMap)[*homeless_iter] = group;
-        homeless_iter++;
-    }
-    
-    // we need to fix up the group counts
-    std::map<std::string, int>::iterator local_count_iter = local_kmer_CountMap.begin();
-    while(local_count_iter != local_kmer_CountMap.end())
-    {
-        (*(*groupKmerCountsMap)[group])[local_count_iter->first] += local_count_iter->second;
-        local_count_iter++;
+        // we need to record the group for this mofo!
+        mDR2GIDMap[group]->push_back(dr_tokens[i]);
     }
     
-    // clean up
-    delete [] kmer_offsets;
-    for(int i = 0; i < num_mers; i++)
-    {
-        delete [] kmers[i];
-    }
-    delete [] kmers;
-    
     return true;
-    
-}
-
-//**************************************
-// spacer graphs
-//**************************************
-int WorkHorse::makeSpacerGraphs(void)
-{
-	//-----
-	// build the spacer graphs
-	//
-    // go through the DR2GID_map and make all reads in each group into nodes
-    DR_ListIterator dr_iter = mDRs.begin();
-    while(dr_iter != mDRs.end())
-    {
-        if(NULL != dr_iter->second)
-        {
-        	logInfo("Making spacer graph for DR: " << dr_iter->first, 1);
-        	if((dr_iter->second)->buildSpacerGraph())
-        		return 1;
-        }
-        dr_iter++;
-    }
-    return 0;
-}
-
-int WorkHorse::cleanSpacerGraphs(void)
-{
-	//-----
-	// clean the spacer graphs
-	//
-    // go through the DR2GID_map and make all reads in each group into nodes
-#ifdef DEBUG
-    //renderSpacerGraphs("Spacer_Preclean_");
-#endif
-    DR_ListIterator dr_iter = mDRs.begin();
-    while(dr_iter != mDRs.end())
-    {
-        if(NULL != dr_iter->second)
-        {
-        	logInfo("Cleaning spacer graph for DR: " << dr_iter->first, 1);
-        	//(dr_iter->second)->printAllSpacers();
-        	if((dr_iter->second)->cleanSpacerGraph())
-        		return 1;
-        }
-        dr_iter++;
-    }
-    return 0;
-}
-
-int WorkHorse::generateFlankers(void)
-{
-	//-----
-	// Wrapper for graph cleaning
-	//
-	// create a spacer dictionary
-	logInfo("Detecting Flanker sequences", 1);
-	DR_Cluster_MapIterator drg_iter = mDR2GIDMap.begin();
-	while(drg_iter != mDR2GIDMap.end())
-	{
-		if(NULL != drg_iter->second)
-		{            
-            if (NULL != mDRs[mTrueDRs[drg_iter->first]])
-            {
-                logInfo("Assigning flankers for NodeManager "<<drg_iter->first, 3);
-                (mDRs[mTrueDRs[drg_iter->first]])->generateFlankers();
-		    }
-        }
-		drg_iter++;
-	}
-	return 0;
-}
-//**************************************
-// contig making
-//**************************************
-int WorkHorse::splitIntoContigs(void)
-{
-	//-----
-	// split all groups into contigs
-	//
-    DR_ListIterator dr_iter = mDRs.begin();
-    while(dr_iter != mDRs.end())
-    {
-        if(NULL != dr_iter->second)
-        {
-        	logInfo("Making spacer contigs for DR: " << dr_iter->first, 1);
-
-            if((dr_iter->second)->splitIntoContigs())
-        		return 1;
-        }
-        dr_iter++;
-    }
-    return 0;
 }
 
 //**************************************
@@ -1760,31 +1863,7 @@ int WorkHorse::renderDebugGraphs(std::string namePrefix)
         {            
             if (NULL != mDRs[mTrueDRs[drg_iter->first]])
             {
-                std::ofstream graph_file;
-                std::string graph_file_prefix = mOpts->output_fastq + namePrefix + to_string(drg_iter->first) + "_" + mTrueDRs[drg_iter->first];
-                std::string graph_file_name = graph_file_prefix + "_debug.gv";
-                graph_file.open(graph_file_name.c_str());
-                if (graph_file.good()) 
-                {
-                    mDRs[mTrueDRs[drg_iter->first]]->printDebugGraph(graph_file, mTrueDRs[drg_iter->first], false, false, false);
-#if RENDERING
-                    if (!mOpts->noRendering) 
-                    {
-                        // create a command string and call neato to make the image file
-                        std::cout<<"["<<PACKAGE_NAME<<"_imageRenderer]: Rendering group "<<drg_iter->first<<std::endl;
-                        std::string cmd = "neato -Teps " + graph_file_name + " > "+ graph_file_prefix + ".eps";
-                        if (system(cmd.c_str()))
-                        {
-                            logError("Problem running neato when rendering debug graphs");
-                        }
-                    }
-#endif
-                } 
-                else 
-                {
-                    logError("Unable to create graph output file "<<graph_file_name);
-                }
-                graph_file.close();
+                renderDebugGraph(drg_iter->first, mTrueDRs[drg_iter->first], mDRs[mTrueDRs[drg_iter->first]], namePrefix);
             }
         }
         drg_iter++;
@@ -1792,6 +1871,35 @@ int WorkHorse::renderDebugGraphs(std::string namePrefix)
     return 0;
 }
 
+void WorkHorse::renderDebugGraph(int GID, const std::string& trueDR, NodeManager * manager, std::string namePrefix)
+{
+    std::ofstream graph_file;
+    std::string graph_file_prefix = mOpts->output_fastq + namePrefix + to_string(GID) + "_" + trueDR;
+    std::string graph_file_name = graph_file_prefix + "_debug.gv";
+    graph_file.open(graph_file_name.c_str());
+    if (graph_file.good()) 
+    {
+        manager->printDebugGraph(graph_file, trueDR, false, false, false);
+#if RENDERING
+        if (!mOpts->noRendering) 
+        {
+            // create a command string and call neato to make the image file
+            std::cout<<"["<<PACKAGE_NAME<<"_imageRenderer]: Rendering group "<<GID<<std::endl;
+            std::string cmd = "neato -Teps " + graph_file_name + " > "+ graph_file_prefix + ".eps";
+            if (system(cmd.c_str()))
+            {
+                logError("Problem running neato when rendering debug graphs");
+            }
+        }
+#endif
+    } 
+    else 
+    {
+        logError("Unable to create graph output file "<<graph_file_name);
+    }
+    graph_file.close();
+}
+
 int WorkHorse::renderSpacerGraphs(void)
 {
 	//-----
@@ -1885,6 +1993,41 @@ int WorkHorse::renderSpacerGraphs(std::string namePrefix)
     return 0;
 }
 
+void WorkHorse::countGraphs(void)
+{
+    //-----
+    // How big the graphs of the CRISPRs that made it through are
+    //
+    long num_crisprs = 0;
+    long num_nodes = 0;
+    long num_spacers = 0;
+    long num_contigs = 0;
+    DR_ListIterator dr_iter;
+    for (dr_iter = mDRs.begin(); dr_iter != mDRs.end(); ++dr_iter) 
+    {
+        if (NULL != dr_iter->second) 
+        {
+            num_crisprs++;
+            num_nodes += dr_iter->second->numNodes();
+            num_spacers += dr_iter->second->numSpacers();
+            num_contigs += dr_iter->second->numContigs();
+        }
+    }
+    mStats.setCount("crisprs", num_crisprs);
+    mStats.setCount("nodes", num_nodes);
+    mStats.setCount("spacers", num_spacers);
+    mStats.setCount("contigs", num_contigs);
+}
+
+bool WorkHorse::writeStatsReport(void)
+{
+    std::string file_prefix = mOpts->output_fastq + PACKAGE_NAME + "." + mTimeStamp + ".stats";
+    logInfo("Writing stats report to: "<<file_prefix<<".json", 1);
+    bool json_ok = mStats.writeJson(file_prefix + ".json");
+    bool table_ok = mStats.writeTable(file_prefix + ".tsv", mOpts->delim);
+    return json_ok && table_ok;
+}
+
 int WorkHorse::checkFileOrError(const char * fileName)
 {
     // Test to see if the file is ok.
@@ -49,6 +49,7 @@
 #include "libcrispr.h"
 #include "NodeManager.h"
 #include "ReadHolder.h"
+#include "ReadStore.h"
 #include "StringCheck.h"
 #include "writer.h"
 #if SEARCH_SINGLETON
@@ -56,6 +57,8 @@
 #endif
 #include "Types.h"
 #include "Aligner.h"
+#include "PipelineStats.h"
+#include "DRClusterer.h"
 
 
 // typedefs
@@ -102,31 +105,96 @@ class WorkHorse {
         //**************************************
         int parseSeqFiles(Vecstr seqFiles);	// parse the raw read files
         
-        int buildGraph(void);									// build the basic graph structue
+        int recruitSpilledSingletons(Vecstr& seqFiles,                    // second pass for single pass mode
+                                     SingletonSpill * spill, 
+                                     Vecstr * nonRedundantSet, 
+                                     HeaderSet& readsFound, 
+                                     time_t& startTime);
         
-        int cleanGraph(void);									// clean the graph structue
+        //**************************************
+        // graphs, one NodeManager for each true DR
+        //**************************************
+        // everything one NodeManager goes through, from its reads to its
+        // contigs. The NodeManagers share nothing they write to, so each
+        // one is made by a task of its own. They are only put into mDRs
+        // once all of them are done
+        enum GRAPH_PHASE {
+            WH_BUILD_GRAPH,
+            WH_CLEAN_GRAPH,
+            WH_MAKE_SPACER_GRAPH,
+            WH_CLEAN_SPACER_GRAPH,
+            WH_SPLIT_INTO_CONTIGS,
+            WH_GENERATE_FLANKERS,
+            WH_NUM_GRAPH_PHASES
+        };
+
+        typedef struct {
+            WorkHorse * workHorse;
+            int GID;
+            DR_Cluster * cluster;                       // the group's DRs
+            std::string trueDR;
+            NodeManager * manager;
+            bool failed;
+            std::string errorMsg;
+            double wallSeconds[WH_NUM_GRAPH_PHASES];    // time this group spent in each phase
+            double cpuSeconds[WH_NUM_GRAPH_PHASES];
+            double phaseWallStart;                      // when the current phase started
+            double phaseCpuStart;
+        } GraphWork;
+
+        static void graphWorkTask(void * arg);
+        void endGraphPhase(GraphWork& work, GRAPH_PHASE phase);  // add the time since the last phase ended to this one
+
+        int makeGraphs(void);                               // make, clean and split the graphs of every group
+        void makeGraph(GraphWork& work);                    // ... and of one group
 
         void removeRedundantRepeats(Vecstr& repeatVector);
         
-        Vecstr * createNonRedundantSet(GroupKmerMap& groupKmerCountsMap, 
+        Vecstr * createNonRedundantSet(GroupIdList& clusteredGIDs, 
                                                          int& nextFreeGID);
 
         int removeLowConfidenceNodeManagers(void);
         
-        int findConsensusDRs(GroupKmerMap& groupKmerCountsMap, 
+        int findConsensusDRs(GroupIdList& clusteredGIDs, 
                              int& nextFreeGID);
     
-        bool clusterDRReads(StringToken DRToken, 
-                int * nextFreeGID, 
-                std::map<std::string, int> * k2GIDMap, 
-                GroupKmerMap * groupKmerCountsMap);  // cut kmers and hash
+        bool clusterDRs(int& nextFreeGID, 
+                GroupIdList& clusteredGIDs);  // cut kmers and hash
+        
+        // everything parseGroupedDRs changes while it works on one of the
+        // groups from clusterDRs. The DRs are given tokens of their own 
+        // and new groups are numbered on from the group's GID, so that the
+        // groups can be worked on side by side. They get their real 
+        // tokens and GIDs when the work is merged back in
+        typedef struct {
+            WorkHorse * workHorse;
+            int GID;                                    // the group being worked on
+            std::vector<StringToken> tokens;            // the real token of each of the group's DRs, in order
+            StringCheck strings;                        // the group's DRs then any made along the way
+            ReadMap reads;
+            DR_Cluster_Map clusters;
+            std::map<int, std::string> trueDRs;
+            int nextFreeGID;
+            bool failed;
+            std::string errorMsg;
+        } GroupWork;
+
+        static void groupWorkTask(void * arg);
+
+        GroupWork * makeGroupWork(int GID);
+
+        // swap the group's work into the real tokens and GIDs, newGIDs
+        // gets the groups that were given a true DR
+        void mergeGroupWork(GroupWork * work, int& nextFreeGID, std::vector<int>& newGIDs);
         
-        bool findMasterDR(int GID, 
+        bool findMasterDR(GroupWork& work,
+                int GID, 
                 StringToken&  masterDRToken);
         
-        bool populateCoverageArray( int GID, Aligner& drAligner );
+        bool populateCoverageArray(GroupWork& work, int GID, Aligner& drAligner );
         
-        std::string calculateDRConsensus(int GID, 
+        std::string calculateDRConsensus(GroupWork& work,
+                                         int GID, 
                                          Aligner& drAligner, 
                                          int& nextFreeGID,
                                          int& collapsedPos,
@@ -134,24 +202,14 @@ class WorkHorse {
                                          std::map<int, bool>& refinedDREnds
                                          );
         
-        void splitGroupedDR( std::map<char, int>& collaped_options, Aligner& dr_aligner, int collapsed_pos, int GID, int * nextFreeGID);
-        bool parseGroupedDRs( int GID, int * nextFreeGID);
-        void combineGroupsWithIdenticalDRs();
+        void splitGroupedDR(GroupWork& work, std::map<char, int>& collaped_options, Aligner& dr_aligner, int collapsed_pos, int GID, int * nextFreeGID);
+        bool parseGroupedDRs(GroupWork& work, int GID, int * nextFreeGID);
+        // trueDRGroups maps each true DR back to its group
+        void combineGroupsWithIdenticalDRs(std::map<std::string, int>& trueDRGroups, const std::vector<int>& newGIDs);
         
         int numberOfReadsInGroup(DR_Cluster * currentGroup);
         
-        void cleanGroup(int GID);
-        
-        //**************************************
-        // spacer graphs
-        //**************************************
-        int makeSpacerGraphs(void);
-        int cleanSpacerGraphs(void);
-        int generateFlankers(void);
-        //**************************************
-        // contig making
-        //**************************************
-        int splitIntoContigs(void);
+        void cleanGroup(GroupWork& work, int GID);
         
         //**************************************
         // file IO
@@ -166,11 +224,17 @@ class WorkHorse {
         
         int renderDebugGraphs(std::string namePrefix);
         
+        void renderDebugGraph(int GID, const std::string& trueDR, NodeManager * manager, std::string namePrefix);
+        
         int renderSpacerGraphs(void);							// render debug graphs
         
         int renderSpacerGraphs(std::string namePrefix);
         
         int checkFileOrError(const char * fileName);
+        
+        void countGraphs(void);                                 // add the sizes of the graphs to the stats
+        
+        bool writeStatsReport(void);                            // the stats report, if the user asked for one
     
         bool outputResults(void) { return outputResults(mOpts->output_fastq + "crass"); } // print all the assembly gossip to XML
         
@@ -184,6 +248,7 @@ class WorkHorse {
     // members
         DR_List mDRs;                               // list of nodemanagers, cannonical DRs, one nodemanager per direct repeat
         ReadMap mReads;                             // reads containing possible double DRs
+        ReadStore mReadStore;                       // the packed reads that mReads indexes into
         options * mOpts;                      // search options
         std::string mOutFileDir;                    // where to spew text to
         int mMaxReadLength;                       // the average seen read length
@@ -194,6 +259,7 @@ class WorkHorse {
         std::map<int, bool> mGroupMap;				// list of valid group IDs
         DR_Cluster_Map mDR2GIDMap;					// map a DR (StringToken) to a GID
         std::map<int, std::string> mTrueDRs;		// map GId to true DR strings
+        PipelineStats mStats;                       // timings and counts for each stage
 };
 
 #endif //WorkHorse_h
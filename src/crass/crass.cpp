@@ -111,6 +111,18 @@ void usage(void)
     std::cout<< "-o --outDir          <DIR>   Output directory [default: .]"<<std::endl;
     std::cout<< "-V --version                 Program and version information"<<std::endl;
     std::cout<< "-g --logToScreen             Print the logging information to screen rather than a file"<<std::endl;
+    std::cout<< "-t --threads         <INT>   Number of threads used to search the reads, cluster the"<<std::endl;
+    std::cout<< "                             repeats and build the graphs [Default: "<<CRASS_DEF_NUM_THREADS<<"]"<<std::endl;
+    std::cout<< "-p --singlePass              Keep possible singletons from the first search so that"<<std::endl;
+    std::cout<< "                             the input is not read twice in full"<<std::endl;
+    std::cout<< "-u --dedupReads              Store exact copies of a read once and count them, for"<<std::endl;
+    std::cout<< "                             amplicon or very deep datasets"<<std::endl;
+    std::cout<< "-M --maxMemory       <INT>   Megabytes of recruited reads to keep in memory, the rest"<<std::endl;
+    std::cout<< "                             are spilled to a temporary file in the output directory"<<std::endl;
+    std::cout<< "                             [Default: no limit]"<<std::endl;
+    std::cout<< "-R --statsReport             Write the time, memory use and counts for each stage to"<<std::endl;
+    std::cout<< "                             "<<PACKAGE_NAME<<".<timestamp>.stats.json and .tsv in the output directory"<<std::endl;
+    std::cout<< "   --outputDelim     <STR>   Separator used in the .tsv stats report [Default: tab]"<<std::endl;
     std::cout<<std::endl;
     std::cout<<"CRISPR Identification Options:"<<std::endl;
     std::cout<< "-d --minDR           <INT>   Minimim length of the direct repeat"<<std::endl; 
@@ -195,7 +207,7 @@ int processOptions(int argc, char *argv[], options *opts)
 {
     int c;
     int index;
-    while( (c = getopt_long(argc, argv, "a:b:c:d:D:ef:gGhk:K:l:Ln:o:rs:S:Vw:", long_options, &index)) != -1 ) 
+    while( (c = getopt_long(argc, argv, "a:b:c:d:D:ef:gGhk:K:l:LM:n:o:prRs:S:t:uVw:", long_options, &index)) != -1 ) 
     {
         switch(c) 
         {
@@ -343,6 +355,15 @@ int processOptions(int argc, char *argv[], options *opts)
                     exit(1);
                 }
                 break;
+            case 'p':
+                opts->singlePass = true;
+                break;
+            case 'M':
+                from_string<size_t>(opts->maxMemory, optarg, std::dec);
+                break;
+            case 'R':
+                opts->reportStats = true;
+                break;
             case 'r': 
 #ifdef RENDERING 
                 opts->noRendering = true; 
@@ -359,6 +380,17 @@ int processOptions(int argc, char *argv[], options *opts)
             case 'S': 
                 from_string<unsigned int>(opts->highSpacerSize, optarg, std::dec);
                 break;
+            case 't':
+                from_string<unsigned int>(opts->numThreads, optarg, std::dec);
+                if (opts->numThreads < 1) 
+                {
+                    std::cerr<<PACKAGE_NAME<<" [WARNING]: The number of threads cannot be "<<opts->numThreads<<" changing to "<<CRASS_DEF_NUM_THREADS<<std::endl;
+                    opts->numThreads = CRASS_DEF_NUM_THREADS;
+                }
+                break;
+            case 'u':
+                opts->dedupReads = true;
+                break;
             case 'V': 
                 versionInfo(); 
                 exit(1); 
@@ -373,6 +405,7 @@ int processOptions(int argc, char *argv[], options *opts)
                 }
                 break;        
             case 0:
+                if (strcmp("outputDelim", long_options[index].name) == 0) opts->delim = optarg;
 #ifdef SEARCH_SINGLETON
                 if (strcmp("searchChecker", long_options[index].name) == 0) opts->searchChecker = optarg;
 #endif
@@ -429,13 +462,13 @@ int main(int argc, char *argv[])
     /* application of default options */
     options opts;
     opts.logLevel              = CRASS_DEF_DEFAULT_LOGGING;              // level of verbosity allowed in the log file
-    opts.reportStats           = CRASS_DEF_STATS_REPORT;                 // print a starts report currently not used
+    opts.reportStats           = CRASS_DEF_STATS_REPORT;                 // write a report of the time and counts for each stage
     opts.lowDRsize             = CRASS_DEF_MIN_DR_SIZE;                  // the lower size limit for a direct repeat
     opts.highDRsize            = CRASS_DEF_MAX_DR_SIZE;                  // the upper size limit for a direct repeat
     opts.lowSpacerSize         = CRASS_DEF_MIN_SPACER_SIZE;              // the lower limit for a spacer
     opts.highSpacerSize        = CRASS_DEF_MAX_SPACER_SIZE;              // the upper size limit for a spacer
     opts.output_fastq          = CRASS_DEF_OUTPUT_DIR;                   // the output directory for the output files
-    opts.delim                 = CRASS_DEF_STATS_REPORT_DELIM;           // delimiter used in stats report currently not used
+    opts.delim                 = CRASS_DEF_STATS_REPORT_DELIM;           // delimiter used in the tabular stats report
     opts.kmer_clust_size       = CRASS_DEF_K_CLUST_MIN;                  // number of kmers needed to be shared to add to a cluser
     opts.searchWindowLength    = CRASS_DEF_OPTIMAL_SEARCH_WINDOW_LENGTH; // option 'w'used in long read search only
     opts.minNumRepeats         = CRASS_DEF_DEFAULT_MIN_NUM_REPEATS;      // option 'n'used in long read search only
@@ -458,6 +491,10 @@ int main(int argc, char *argv[])
     opts.layoutAlgorithm       = "unset";
 #endif
     opts.covCutoff             = CRASS_DEF_COVCUTOFF;
+    opts.numThreads            = CRASS_DEF_NUM_THREADS;                  // number of threads used by the search, clustering and graph building
+    opts.singlePass            = CRASS_DEF_SINGLE_PASS;                  // keep possible singletons from the first search in a spill file
+    opts.maxMemory             = CRASS_DEF_MAX_MEMORY;                   // megabytes of recruited reads kept in memory, 0 for no limit
+    opts.dedupReads            = CRASS_DEF_DEDUP_READS;                  // store exact copies of a read once
 
     int opt_idx = processOptions(argc, argv, &opts);
 
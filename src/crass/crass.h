@@ -73,13 +73,19 @@ static struct option long_options [] = {
     {"graphNodeLen",required_argument,NULL,'K'},
     {"logLevel", required_argument, NULL, 'l'},
     {"longDescription",no_argument,NULL,'L'},
+    {"maxMemory", required_argument, NULL, 'M'},
     {"minNumRepeats", required_argument, NULL, 'n'},
     {"outDir", required_argument, NULL, 'o'},
+    {"outputDelim", required_argument, NULL, 0},
+    {"singlePass", no_argument, NULL, 'p'},
+    {"statsReport", no_argument, NULL, 'R'},
 #ifdef RENDERING
     {"noRendering",no_argument,NULL,'r'},
 #endif
     {"minSpacer", required_argument, NULL, 's'},
     {"maxSpacer", required_argument, NULL, 'S'},
+    {"threads", required_argument, NULL, 't'},
+    {"dedupReads", no_argument, NULL, 'u'},
     {"version", no_argument, NULL, 'V'},
     {"windowLength", required_argument, NULL, 'w'},
     {"spacerScalling",required_argument,NULL,'x'},
@@ -81,6 +81,24 @@
 #define CRASS_DEF_PARTIAL_SIM_CUT_OFF           (0.85)              // The similarity needed to exted into partial matches
 #define CRASS_DEF_MIN_PARTIAL_LENGTH            (4)                 // The mininum length allowed for a partial direct repeat at the beginning or end of a read 
 #define CRASS_DEF_MAX_SING_PATTERNS				(5000)				// the maximum number of patterns we'll search for in a single hit
+// --------------------------------------------------------------------
+ // THREADING
+// --------------------------------------------------------------------
+#define CRASS_DEF_NUM_THREADS                   (1)                   // number of search threads, 1 means search in the calling thread
+#define CRASS_DEF_READ_BATCH_SIZE               (4096)                // number of reads handed to a search thread at a time
+#define CRASS_DEF_BATCHES_PER_THREAD            (4)                   // how many batches each search thread can have queued up
+#define CRASS_DEF_INPUT_CHUNK_SIZE              (1 << 20)             // bytes of decompressed input handed to the parser at a time
+#define CRASS_DEF_INPUT_READ_AHEAD              (4)                   // how many chunks can be decompressed ahead of the parser
+// --------------------------------------------------------------------
+ // SINGLE PASS MODE
+// --------------------------------------------------------------------
+#define CRASS_DEF_SINGLE_PASS                   false                 // keep possible singletons during the first search instead of reading everything twice
+#define CRASS_DEF_SPILL_KMER_SIZE               (11)                  // a read is kept if it shares a kmer this long with a known direct repeat
+// --------------------------------------------------------------------
+ // MEMORY BUDGET
+// --------------------------------------------------------------------
+#define CRASS_DEF_MAX_MEMORY                    (0)                   // megabytes of recruited reads kept in memory, 0 for no limit
+#define CRASS_DEF_DEDUP_READS                   false                 // store exact copies of a read once and count them
 // --------------------------------------------------------------------
  // HARD CODED PARAMS FOR DR FILTERING
 // --------------------------------------------------------------------
@@ -139,13 +157,13 @@
 
 typedef struct {
     int                 logLevel;                                           // level of verbosity allowed in the log file
-    bool                reportStats;                                        // print a starts report currently not used
+    bool                reportStats;                                        // write a report of the time and counts for each stage
     unsigned int        lowDRsize;                                          // the lower size limit for a direct repeat
     unsigned int        highDRsize;                                         // the upper size limit for a direct repeat
     unsigned int        lowSpacerSize;                                      // the lower limit for a spacer
     unsigned int        highSpacerSize;                                     // the upper size limit for a spacer
     std::string         output_fastq;                                       // the output directory for the output files
-    std::string         delim;                                              // delimiter used in stats report currently not used
+    std::string         delim;                                              // delimiter used in the tabular stats report
     int                 kmer_clust_size;                                    // number of kmers needed to be shared to add to a cluser
     unsigned int        searchWindowLength;                                 // option 'w'used in long read search only
     unsigned int        minNumRepeats;                                      // option 'n'used in long read search only
@@ -166,6 +184,10 @@ typedef struct {
     bool                noRendering;                                        // Even if RENDERING preprocessor macro is set do not produce any rendered images
 #endif
     int                 covCutoff;                                          // The lower bounds of acceptable numbers of reads that a group can have
+    unsigned int        numThreads;                                         // number of threads used by the search, clustering and graph building
+    bool                singlePass;                                         // keep possible singletons from the first search in a spill file
+    size_t              maxMemory;                                          // megabytes of recruited reads kept in memory before the rest are spilled to disk, 0 for no limit
+    bool                dedupReads;                                         // store exact copies of a read once with a count of how many there were
 
 } options;
 
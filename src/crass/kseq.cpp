@@ -35,11 +35,22 @@
 #include <zlib.h>
 #include "kseq.h"
 
+static int ks_gzread(void *f, char *buf, int len)
+{
+	return gzread((gzFile)f, buf, len);
+}
+
 kstream_t *ks_init(gzFile f)
+{
+	return ks_init_reader((void*)f, ks_gzread);
+}
+
+kstream_t *ks_init_reader(void *f, ks_reader_t read)
 {
 	kstream_t *ks = (kstream_t*)calloc(1, sizeof(kstream_t));
 	ks->f = f;
-	ks->buf = (char*)malloc(4096);
+	ks->read = read;
+	ks->buf = (char*)malloc(KS_BUFSIZE);
 	return ks;
 }
 
@@ -59,8 +70,8 @@ int ks_getc(kstream_t *ks)
 	if (ks->begin >= ks->end)
 	{
 		ks->begin = 0;
-		ks->end = gzread(ks->f, ks->buf, 4096);
-		if (ks->end < 4096)
+		ks->end = ks->read(ks->f, ks->buf, KS_BUFSIZE);
+		if (ks->end < KS_BUFSIZE)
 			ks->is_eof = 1;
 		if (ks->end == 0)
 			return -1;
@@ -84,8 +95,8 @@ int ks_getuntil(kstream_t *ks, int delimiter, kstring_t *str, int *dret)
 			if (!ks->is_eof)
 			{
 				ks->begin = 0;
-				ks->end = gzread(ks->f, ks->buf, 4096);
-				if (ks->end < 4096)
+				ks->end = ks->read(ks->f, ks->buf, KS_BUFSIZE);
+				if (ks->end < KS_BUFSIZE)
 					ks->is_eof = 1;
 				if (ks->end == 0)
 					break;
@@ -150,6 +161,13 @@ kseq_t *kseq_init(gzFile fd)
 	return s;
 }
 
+kseq_t *kseq_init_reader(void *f, ks_reader_t read)
+{
+	kseq_t *s = (kseq_t*)calloc(1, sizeof(kseq_t));
+	s->f = ks_init_reader(f, read);
+	return s;
+}
+
 void kseq_rewind(kseq_t *ks)
 {
 	ks->last_char = 0;
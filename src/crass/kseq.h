@@ -37,11 +37,18 @@
 #include <stdlib.h>
 #include <zlib.h>
 
+/* bytes asked of the reader at a time */
+#define KS_BUFSIZE 65536
+
+/* anything that behaves like gzread */
+typedef int (*ks_reader_t)(void *f, char *buf, int len);
+
 typedef struct //__kstream_t
 {
 	char *buf;
 	int begin, end, is_eof;
-	gzFile f;
+	void *f;
+	ks_reader_t read;
 } kstream_t;
 
 typedef struct //__kstring_t
@@ -59,6 +66,8 @@ typedef struct
 
 kstream_t *ks_init(gzFile f);
 
+kstream_t *ks_init_reader(void *f, ks_reader_t read);
+
 void ks_destroy(kstream_t *ks);
 
 int ks_getc(kstream_t *ks);
@@ -67,6 +76,8 @@ int ks_getuntil(kstream_t *ks, int delimiter, kstring_t *str, int *dret);
 
 kseq_t *kseq_init(gzFile fd);
 
+kseq_t *kseq_init_reader(void *f, ks_reader_t read);
+
 void kseq_rewind(kseq_t *ks);
 
 void kseq_destroy(kseq_t *ks);
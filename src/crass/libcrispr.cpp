@@ -48,6 +48,7 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <exception>
+#include <deque>
 #include "StlExt.h"
 #include "Exception.h"
 
@@ -58,6 +59,8 @@
 #include "PatternMatcher.h"
 #include "SeqUtils.h"
 #include "kseq.h"
+#include "InputStream.h"
+#include "ThreadPool.h"
 #include "config.h"
 
 extern "C" {
@@ -65,13 +68,330 @@ extern "C" {
 #include "../aho-corasick/acism.h"
 }
 
+// a chunk of reads that gets processed by one thread
+typedef struct _read_batch {
+    std::vector<ReadHolder> reads;      // holders are kept when a batch is recycled, only the first numReads are in use
+    size_t numReads;
+    void * context;                     // whatever the task needs, must only be read from
+    std::vector<char> isCrispr;         // search: true if searchCore passed
+    SearchCounters counters;            // search: how far the reads in this batch got
+    ReadMap localReads;                 // singletons: reads recruited from this batch
+    ReadStore localStore;               // singletons: the packed reads indexed by localReads
+    StringCheck localStringCheck;       // singletons: tokens for the reads above
+    bool done;                          // set by the thread pool
+    bool failed;
+    std::string errorMsg;
+} ReadBatch;
+
+// called on the reading thread for each batch in the order they were read
+typedef void (*ReadBatchMerge)(ReadBatch * batch, void * mergeContext);
+
+static void deleteReadBatch(ReadBatch * batch)
+{
+    // if a merge failed there may still be recruited reads in here
+    ReadMapIterator map_iter;
+    for (map_iter = batch->localReads.begin(); map_iter != batch->localReads.end(); ++map_iter) 
+    {
+        delete map_iter->second;
+    }
+    delete batch;
+}
+
+template <class T>
+static void clearReadBatches(T& batches)
+{
+    typename T::iterator batch_iter;
+    for (batch_iter = batches.begin(); batch_iter != batches.end(); ++batch_iter) 
+    {
+        deleteReadBatch(*batch_iter);
+    }
+    batches.clear();
+}
+
+static int processFileInBatches(const char * inputFastq,
+                                unsigned int numThreads,
+                                ThreadPoolTask task,
+                                void * taskContext,
+                                ReadBatchMerge merge,
+                                void * mergeContext,
+                                const char * stageName,
+                                time_t& time_start,
+                                int& read_counter,
+                                long skipReads,
+                                long maxReads)
+{
+    //-----
+    // The calling thread parses the file into batches and hands them 
+    // to a pool of worker threads. Finished batches are merged back
+    // in file order so the result is the same as a single threaded run
+    //
+    InputStream input(inputFastq, numThreads);
+    kseq_t * seq = kseq_init_reader(&input, InputStream::readStream);
+
+    int l, log_counter, max_read_length;
+    log_counter = max_read_length = 0;
+    time_t time_current;
+
+    ThreadPool pool(numThreads);
+    std::deque<ReadBatch *> in_flight;
+    // merged batches get used again so that their read holders
+    // don't have to allocate for every read
+    std::vector<ReadBatch *> spare_batches;
+    size_t max_in_flight = CRASS_DEF_BATCHES_PER_THREAD * numThreads;
+    bool more_reads = true;
+    long reads_taken = 0;
+
+    // reads at the start of the file that have already been dealt with
+    while (skipReads > 0 && kseq_read(seq) >= 0) 
+    {
+        skipReads--;
+    }
+
+    try {
+        while (more_reads) 
+        {
+            ReadBatch * batch;
+            if (spare_batches.empty()) 
+            {
+                batch = new ReadBatch;
+                // reserve so that the read holders never get copied around
+                batch->reads.reserve(CRASS_DEF_READ_BATCH_SIZE);
+            } 
+            else 
+            {
+                batch = spare_batches.back();
+                spare_batches.pop_back();
+            }
+            batch->context = taskContext;
+            batch->numReads = 0;
+            batch->done = false;
+            batch->failed = false;
+            batch->errorMsg.clear();
+            
+            while (batch->numReads < CRASS_DEF_READ_BATCH_SIZE) 
+            {
+                if ((maxReads >= 0 && reads_taken >= maxReads) || (l = kseq_read(seq)) < 0) 
+                {
+                    more_reads = false;
+                    break;
+                }
+                reads_taken++;
+                max_read_length = (l > max_read_length) ? l : max_read_length;
+                if (log_counter == CRASS_DEF_READ_COUNTER_LOGGER) 
+                {
+                    time(&time_current);
+                    double diff = difftime(time_current, time_start);
+                    std::cout<<"\r["<<PACKAGE_NAME<<"_"<<stageName<<"]: "
+                             << "Processed "<<read_counter<<" ...";
+                    std::cout<<diff<<" sec"<<std::flush;
+                    log_counter = 0;
+                }
+                if (batch->numReads == batch->reads.size()) 
+                {
+                    batch->reads.resize(batch->numReads + 1);
+                }
+                ReadHolder& tmp_holder = batch->reads[batch->numReads];
+                tmp_holder.reuse();
+                tmp_holder.setSequence(seq->seq.s);
+                tmp_holder.setHeader(seq->name.s);
+                if (seq->comment.s) 
+                {
+                    tmp_holder.setComment(seq->comment.s);
+                }
+                if (seq->qual.s) 
+                {
+                    tmp_holder.setQual(seq->qual.s);
+                }
+                batch->numReads++;
+                log_counter++;
+                read_counter++;
+            }
+
+            if (batch->numReads == 0) 
+            {
+                spare_batches.push_back(batch);
+            } 
+            else 
+            {
+                in_flight.push_back(batch);
+                pool.submit(task, batch, &(batch->done));
+            }
+
+            // merge whatever is at the front of the queue, only blocking when 
+            // the queue is full or when there is nothing left to read
+            while (! in_flight.empty() && 
+                   (pool.isDone(&(in_flight.front()->done)) || in_flight.size() >= max_in_flight || ! more_reads)) 
+            {
+                ReadBatch * finished = in_flight.front();
+                pool.waitFor(&(finished->done));
+                in_flight.pop_front();
+                try {
+                    merge(finished, mergeContext);
+                } catch (crispr::exception& e) {
+                    deleteReadBatch(finished);
+                    throw;
+                }
+                finished->localStringCheck.clear();
+                finished->localStore.clear();
+                spare_batches.push_back(finished);
+            }
+        }
+    } catch (crispr::exception& e) {
+        pool.waitAll();
+        clearReadBatches(in_flight);
+        clearReadBatches(spare_batches);
+        kseq_destroy(seq);
+        throw;
+    }
+
+    clearReadBatches(spare_batches);
+    kseq_destroy(seq); // destroy seq
+
+    return max_read_length;
+}
+
+static void searchBatch(void * arg)
+{
+    //-----
+    // Run searchCore over every read in a batch. Runs on a worker 
+    // thread so nothing shared can be touched in here
+    //
+    ReadBatch * batch = static_cast<ReadBatch *>(arg);
+    const options * opts = static_cast<const options *>(batch->context);
+    batch->isCrispr.assign(batch->numReads, 0);
+    clearSearchCounters(batch->counters);
+    RepeatSeeder seeder;
+    try {
+        for (size_t i = 0; i < batch->numReads; i++) 
+        {
+            batch->isCrispr[i] = searchCore(batch->reads[i], *opts, seeder, &(batch->counters));
+        }
+    } catch (crispr::exception& e) {
+        batch->failed = true;
+        batch->errorMsg = e.what();
+    } catch (std::exception& e) {
+        batch->failed = true;
+        batch->errorMsg = e.what();
+    }
+}
+
+// where the hits from searchBatch end up
+typedef struct _search_merge_context {
+    ReadMap * mReads;
+    ReadStore * mReadStore;
+    StringCheck * mStringCheck;
+    lookupTable * patternsHash;
+    HeaderSet * readsFound;
+    SingletonSpill * spill;
+    SearchCounters * counters;
+} SearchMergeContext;
+
+static void mergeSearchBatch(ReadBatch * batch, void * mergeContext)
+{
+    //-----
+    // Add the hits from a finished batch exactly as the 
+    // single threaded search would have
+    //
+    SearchMergeContext * ctx = static_cast<SearchMergeContext *>(mergeContext);
+    try {
+        if (batch->failed) 
+        {
+            throw crispr::exception(__FILE__, 
+                                    __LINE__, 
+                                    __PRETTY_FUNCTION__,
+                                    batch->errorMsg.c_str());
+        }
+        if (ctx->counters != NULL) 
+        {
+            addSearchCounters(*(ctx->counters), batch->counters);
+        }
+        for (size_t i = 0; i < batch->numReads; i++) 
+        {
+            ReadHolder& tmp_holder = batch->reads[i];
+            if (ctx->spill != NULL) 
+            {
+                ctx->spill->nextRead();
+            }
+            if (batch->isCrispr[i]) 
+            {
+                StringToken last_token = ctx->mStringCheck->mNextFreeToken;
+                (*(ctx->patternsHash))[tmp_holder.repeatStringAt(0)] = true;
+                ctx->readsFound->insert(tmp_holder.getHeader());
+                addReadHolder(ctx->mReads, ctx->mReadStore, ctx->mStringCheck, tmp_holder);
+                if (ctx->spill != NULL && ctx->mStringCheck->mNextFreeToken != last_token) 
+                {
+                    ctx->spill->addRepeat(ctx->mStringCheck->getString(ctx->mStringCheck->mNextFreeToken));
+                }
+            }
+            else if (ctx->spill != NULL) 
+            {
+                ctx->spill->spillIfShared(tmp_holder);
+            }
+        }
+    } catch (crispr::exception& e) {
+        std::cerr<<e.what()<<std::endl;
+        throw crispr::exception(__FILE__, 
+                                __LINE__, 
+                                __PRETTY_FUNCTION__,
+                                "Fatal error in search algorithm!");
+    }
+}
+
+static int threadedSearchFile(const char *inputFastq, 
+                              const options& opts, 
+                              ReadMap * mReads, 
+                              ReadStore * mReadStore, 
+                              StringCheck * mStringCheck, 
+                              lookupTable& patternsHash, 
+                              HeaderSet& readsFound,
+                              time_t& time_start,
+                              int& read_counter,
+                              SingletonSpill * spill,
+                              SearchCounters * counters
+                              )
+{
+    SearchMergeContext merge_context;
+    merge_context.mReads = mReads;
+    merge_context.mReadStore = mReadStore;
+    merge_context.mStringCheck = mStringCheck;
+    merge_context.patternsHash = &patternsHash;
+    merge_context.readsFound = &readsFound;
+    merge_context.spill = spill;
+    merge_context.counters = counters;
+
+    int max_read_length = processFileInBatches(inputFastq, 
+                                               opts.numThreads, 
+                                               searchBatch, 
+                                               const_cast<options *>(&opts), 
+                                               mergeSearchBatch, 
+                                               &merge_context, 
+                                               "patternFinder", 
+                                               time_start, 
+                                               read_counter,
+                                               0,
+                                               -1);
+
+    logInfo("finished processing file:"<<inputFastq, 1);    
+    time_t time_current;
+    time(&time_current);
+    double diff = difftime(time_current, time_start);
+    std::cout<<"\r["<<PACKAGE_NAME<<"_patternFinder]: "<< "Processed "<<read_counter<<" ...";
+    std::cout<<diff<<" sec"<<std::flush;
+    logInfo("So far " << mReads->size()<<" direct repeat variants have been found from " << read_counter << " reads", 2);
+
+    return max_read_length;
+}
+
 int searchFile(const char *inputFastq, 
                       const options& opts, 
                       ReadMap * mReads, 
+                      ReadStore * mReadStore, 
                       StringCheck * mStringCheck, 
                       lookupTable& patternsHash, 
-                      lookupTable& readsFound,
-                      time_t& time_start
+                      HeaderSet& readsFound,
+                      time_t& time_start,
+                      SingletonSpill * spill,
+                      SearchCounters * counters
                       )
 
 {
@@ -81,17 +401,39 @@ int searchFile(const char *inputFastq,
 	// this funciton may use the boyer moore algorithm
     // or the CRT search algorithm
     //
-    gzFile fp = getFileHandle(inputFastq);
+    static int read_counter = 0;
+#ifndef SEARCH_SINGLETON
+    // the search checker changes the log level for each read 
+    // so it can only be used in a single thread
+    if (opts.numThreads > 1) 
+    {
+        return threadedSearchFile(inputFastq, 
+                                  opts, 
+                                  mReads, 
+                                  mReadStore, 
+                                  mStringCheck, 
+                                  patternsHash, 
+                                  readsFound, 
+                                  time_start,
+                                  read_counter,
+                                  spill,
+                                  counters);
+    }
+#endif
+    InputStream input(inputFastq, opts.numThreads);
     kseq_t * seq;
 
     // initialize seq
-    seq = kseq_init(fp);
+    seq = kseq_init_reader(&input, InputStream::readStream);
     
     int l, log_counter, max_read_length;
     log_counter = max_read_length = 0;
-    static int read_counter = 0;
     time_t time_current;
     
+    // one holder for every read, it only gets copied if the read is a hit
+    ReadHolder tmp_holder;
+    RepeatSeeder seeder;
+
     // read sequence  
     while ( (l = kseq_read(seq)) >= 0 ) 
     {
@@ -109,7 +451,7 @@ int searchFile(const char *inputFastq,
         }
         try {
             // grab a readholder
-            ReadHolder tmp_holder;
+            tmp_holder.reuse();
             tmp_holder.setSequence(seq->seq.s);tmp_holder.setHeader( seq->name.s);
 #if SEARCH_SINGLETON
             SearchCheckerList::iterator debug_iter = debugger->find(seq->name.s);
@@ -131,17 +473,29 @@ int searchFile(const char *inputFastq,
             }
             
 
-            bool crispr_read = searchCore(tmp_holder, opts );
+            if (spill != NULL) 
+            {
+                spill->nextRead();
+            }
+
+            bool crispr_read = searchCore(tmp_holder, opts, seeder, counters);
             if(crispr_read) {
-                addReadHolder(mReads, mStringCheck, tmp_holder);
+                StringToken last_token = mStringCheck->mNextFreeToken;
                 patternsHash[tmp_holder.repeatStringAt(0)] = true;
-                readsFound[tmp_holder.getHeader()] = true;
+                readsFound.insert(tmp_holder.getHeader());
+                addReadHolder(mReads, mReadStore, mStringCheck, tmp_holder);
+                if (spill != NULL && mStringCheck->mNextFreeToken != last_token) 
+                {
+                    // a new direct repeat, reads that share its kmers are worth keeping
+                    spill->addRepeat(mStringCheck->getString(mStringCheck->mNextFreeToken));
+                }
+            } else if (spill != NULL) {
+                spill->spillIfShared(tmp_holder);
             }
 
         } catch (crispr::exception& e) {
             std::cerr<<e.what()<<std::endl;
             kseq_destroy(seq);
-            gzclose(fp);
             throw crispr::exception(__FILE__, 
                                     __LINE__, 
                                     __PRETTY_FUNCTION__,
@@ -152,7 +506,6 @@ int searchFile(const char *inputFastq,
     }
     
     kseq_destroy(seq); // destroy seq
-    gzclose(fp);
     
     logInfo("finished processing file:"<<inputFastq, 1);    
     time(&time_current);
@@ -171,13 +524,27 @@ int scanRight(ReadHolder&  tmp_holder,
               std::string& pattern, 
               unsigned int minSpacerLength, 
               unsigned int scanRange)
+{
+    return scanRight(tmp_holder, 
+                     pattern.data(), 
+                     static_cast<unsigned int>(pattern.length()), 
+                     minSpacerLength, 
+                     scanRange);
+}
+
+int scanRight(ReadHolder&  tmp_holder, 
+              const char * pattern, 
+              unsigned int pattern_length, 
+              unsigned int minSpacerLength, 
+              unsigned int scanRange)
 {
 #ifdef DEBUG
     logInfo("Scanning Right for more repeats:", 9);
 #endif
     unsigned int start_stops_size = tmp_holder.getStartStopListSize();
     
-    unsigned int pattern_length = static_cast<unsigned int>(pattern.length());
+    // the search works on windows of the read in place
+    const char * read = tmp_holder.getSeq().data();
     
     // final start index
     unsigned int last_repeat_index = tmp_holder.getRepeatAt(start_stops_size - 2);
@@ -234,12 +601,10 @@ int scanRight(ReadHolder&  tmp_holder,
         }
         /******************** end range checks ********************/
         
-        std::string text = tmp_holder.substr(begin_search, (end_search - begin_search));
-        
         #ifdef DEBUG
-        logInfo(pattern<<" : "<<text, 9);
+        logInfo(std::string(pattern, pattern_length)<<" : "<<std::string(read + begin_search, end_search - begin_search), 9);
         #endif
-        position = PatternMatcher::bmpSearch(text, pattern);
+        position = PatternMatcher::exactSearch(read + begin_search, end_search - begin_search, pattern, pattern_length);
         
         
         if (position >= 0)
@@ -263,17 +628,21 @@ int scanRight(ReadHolder&  tmp_holder,
 }
 
 int searchCore(ReadHolder& tmpHolder, 
-                   const options& opts)
+                   const options& opts,
+                   RepeatSeeder& seeder,
+                   SearchCounters * counters)
 {
     //-----
     // Code lifted from CRT, ported by Connor and hacked by Mike.
     //
     
 
-    std::string read = tmpHolder.getSeq();
+    // the windows below all point into the holder's sequence, 
+    // none of them get copied out
+    const char * read = tmpHolder.getSeq().data();
     
     // get the length of this sequence
-    unsigned int seq_length = static_cast<unsigned int>(read.length());
+    unsigned int seq_length = static_cast<unsigned int>(tmpHolder.getSeqLength());
     
 
     //the mumber of bases that can be skipped while we still guarantee that the entire search
@@ -286,12 +655,41 @@ int searchCore(ReadHolder& tmpHolder,
 
     int searchEnd = seq_length - opts.lowDRsize - opts.lowSpacerSize - opts.searchWindowLength - 1;
     
+    if (counters != NULL) 
+    {
+        counters->reads++;
+    }
     if (searchEnd < 0) 
     {
         logWarn("Read "<<tmpHolder.getHeader()<<" is too short. With current parameters, the minimum length must be "<<opts.lowDRsize + opts.lowSpacerSize + opts.searchWindowLength + 1<<"bp (read is "<< seq_length << "bp)", 3);
         return false;
     }
     
+    // almost every read has no repeat at all so throw those out before 
+    // doing the full search. This can't lose a read, anything that fails 
+    // here would not have had a hit in the loop below
+    if (! seeder.mayRepeat(read, 
+                           seq_length, 
+                           opts.searchWindowLength, 
+                           skips, 
+                           static_cast<unsigned int>(searchEnd), 
+                           opts.lowDRsize + opts.lowSpacerSize, 
+                           opts.highDRsize + opts.highSpacerSize)) 
+    {
+        if (counters != NULL) 
+        {
+            counters->prefilterRejects++;
+        }
+        return false;
+    }
+    
+    // for the counters, has this read got past the first two tests yet
+    bool passed_kmers = false;
+    bool passed_length = false;
+    
+    // every window is looked up in here rather than searched for
+    seeder.index(read, seq_length, opts.searchWindowLength);
+
     for (unsigned int j = 0; j <= static_cast<unsigned int>(searchEnd); j = j + skips)
     {
                     
@@ -308,35 +706,10 @@ int searchCore(ReadHolder& tmpHolder,
             endSearch = beginSearch;
         }
         
-        std::string text;
-        std::string pattern;
-        try {
-            text = read.substr(beginSearch, (endSearch - beginSearch));
-
-        } catch (std::exception& e) {
-            throw crispr::substring_exception(e.what(), 
-                                              text.c_str(), 
-                                              beginSearch, 
-                                              (endSearch - beginSearch), 
-                                              __FILE__, 
-                                              __LINE__, 
-                                              __PRETTY_FUNCTION__);
-        }
-        try {
-            pattern = read.substr(j, opts.searchWindowLength);
-        } catch (std::exception& e) {
-            throw crispr::substring_exception(e.what(), 
-                                              read.c_str(), 
-                                              j, 
-                                              opts.searchWindowLength, 
-                                              __FILE__, 
-                                              __LINE__, 
-                                              __PRETTY_FUNCTION__);
-        }
+        const char * pattern = read + j;
 
         //if pattern is found, add it to candidate list and scan right for additional similarly spaced repeats
-        int pattern_in_text_index = -1;
-            pattern_in_text_index = PatternMatcher::bmpSearch(text, pattern);
+        int pattern_in_text_index = seeder.firstRepeat(j, beginSearch, endSearch);
 
         if (pattern_in_text_index >= 0)
         {
@@ -344,7 +717,7 @@ int searchCore(ReadHolder& tmpHolder,
             unsigned int found_pattern_start_index = beginSearch + static_cast<unsigned int>(pattern_in_text_index);
             
             tmpHolder.startStopsAdd(found_pattern_start_index, found_pattern_start_index + opts.searchWindowLength - 1);
-            scanRight(tmpHolder, pattern, opts.lowSpacerSize, 24);
+            scanRight(tmpHolder, pattern, opts.searchWindowLength, opts.lowSpacerSize, 24);
         }
 
         if ( (tmpHolder.numRepeats() >= opts.minNumRepeats) ) //tmp_holder->numRepeats is half the size of the StartStopList
@@ -353,6 +726,7 @@ int searchCore(ReadHolder& tmpHolder,
             logInfo(tmpHolder.getHeader(), 8);
             logInfo("\tPassed test 1. At least "<<opts.minNumRepeats<< " ("<<tmpHolder.numRepeats()<<") repeated kmers found", 8);
 #endif
+            passed_kmers = true;
 
             unsigned int actual_repeat_length = extendPreRepeat(tmpHolder, opts.searchWindowLength, opts.lowSpacerSize);
 
@@ -362,6 +736,7 @@ int searchCore(ReadHolder& tmpHolder,
 
                 logInfo("\tPassed test 2. The repeat length is "<<opts.lowDRsize<<" >= "<< actual_repeat_length <<" <= "<<opts.highDRsize, 8);
 #endif
+                passed_length = true;
                 
                 // drop partials
                 //tmpHolder.dropPartials();
@@ -378,6 +753,12 @@ int searchCore(ReadHolder& tmpHolder,
                     logInfo(tmpHolder.getSeq(), 9);
                     logInfo("-------------------", 7)
 #endif                            
+                    if (counters != NULL) 
+                    {
+                        counters->repeatedKmers++;
+                        counters->repeatLength++;
+                        counters->passedQc++;
+                    }
                     return true;
                 }
             }
@@ -391,16 +772,41 @@ int searchCore(ReadHolder& tmpHolder,
         }
         tmpHolder.clearStartStops();
     }
+    if (counters != NULL) 
+    {
+        counters->repeatedKmers += passed_kmers;
+        counters->repeatLength += passed_length;
+    }
     return false;
 }
 
+void clearSearchCounters(SearchCounters& counters)
+{
+    counters.reads = 0;
+    counters.prefilterRejects = 0;
+    counters.repeatedKmers = 0;
+    counters.repeatLength = 0;
+    counters.passedQc = 0;
+}
+
+void addSearchCounters(SearchCounters& total, const SearchCounters& counters)
+{
+    total.reads += counters.reads;
+    total.prefilterRejects += counters.prefilterRejects;
+    total.repeatedKmers += counters.repeatedKmers;
+    total.repeatLength += counters.repeatLength;
+    total.passedQc += counters.passedQc;
+}
+
 
 
 typedef struct _multisearch_payload {
     ReadMap * mReads;
+    ReadStore * mReadStore;
     StringCheck * mStringCheck;
     kseq_t * read;
-    lookupTable *readsFound;
+    ReadHolder * holder;                // reused for every read that gets recruited
+    HeaderSet *readsFound;
     MEMREF * pattv;
 } MultisearchPayload;
 
@@ -408,7 +814,7 @@ typedef struct _multisearch_payload {
 static int on_match(int strnum, int textpos, MultisearchPayload *payload)
 {
     //if (matchfp) fprintf(matchfp, "%9d %7d '%.*s'\n", textpos, strnum, (int)pattv[strnum].len, pattv[strnum].ptr);
-    if (payload->readsFound->find(payload->read->name.s) == payload->readsFound->end())
+    if (! payload->readsFound->contains(payload->read->name.s, payload->read->name.l))
     {
 
 #ifdef DEBUG
@@ -422,7 +828,8 @@ static int on_match(int strnum, int textpos, MultisearchPayload *payload)
         {
             DR_end = static_cast<unsigned int>(payload->read->seq.l) - 1;
         }
-        ReadHolder tmp_holder;
+        ReadHolder& tmp_holder = *(payload->holder);
+        tmp_holder.reuse();
         tmp_holder.setSequence(payload->read->seq.s);
         tmp_holder.setHeader( payload->read->name.s);
         if (payload->read->comment.s) 
@@ -435,20 +842,144 @@ static int on_match(int strnum, int textpos, MultisearchPayload *payload)
         }
         //logInfo("textpos: "<<textpos<<" DR_end: "<<DR_end<<" start: "<<DR_end << " len: "<< payload->pattv[strnum].len, 1)
         tmp_holder.startStopsAdd(DR_end - (payload->pattv[strnum].len - 1), DR_end);
-        addReadHolder(payload->mReads, payload->mStringCheck, tmp_holder);
+        addReadHolder(payload->mReads, payload->mReadStore, payload->mStringCheck, tmp_holder);
     }
 
     return 1;
 }
 
+// the read only state shared by all of the singleton workers
+typedef struct _singleton_context {
+    ACISM * psp;
+    MEMREF * pattv;
+    HeaderSet * readsFound;
+} SingletonContext;
+
+typedef struct _batch_search_payload {
+    ReadBatch * batch;
+    ReadHolder * read;
+    unsigned int readLength;
+    MEMREF * pattv;
+    HeaderSet * readsFound;
+} BatchSearchPayload;
+
+static int on_batch_match(int strnum, int textpos, BatchSearchPayload *payload)
+{
+    //-----
+    // Same as on_match but the read comes from a batch and is
+    // recruited into the batch's own read map
+    //
+    if (! payload->readsFound->contains(payload->read->getHeader()))
+    {
+        unsigned int DR_end = static_cast<unsigned int>(textpos - 1);
+        if(DR_end >= payload->readLength)
+        {
+            DR_end = payload->readLength - 1;
+        }
+        // the scan stops at the first match so the read can be used as is
+        payload->read->startStopsAdd(DR_end - (payload->pattv[strnum].len - 1), DR_end);
+        addReadHolder(&(payload->batch->localReads), &(payload->batch->localStore), &(payload->batch->localStringCheck), *(payload->read));
+    }
+    return 1;
+}
+
+static void singletonBatch(void * arg)
+{
+    //-----
+    // Scan every read in a batch with the shared automaton. Nothing 
+    // outside of the batch gets written to, readsFound is not changed
+    // during this pass so it can be read from all the threads at once
+    //
+    ReadBatch * batch = static_cast<ReadBatch *>(arg);
+    SingletonContext * ctx = static_cast<SingletonContext *>(batch->context);
+
+    BatchSearchPayload payload;
+    payload.batch = batch;
+    payload.pattv = ctx->pattv;
+    payload.readsFound = ctx->readsFound;
+    try {
+        for (size_t i = 0; i < batch->numReads; i++) 
+        {
+            const std::string& read_seq = batch->reads[i].getSeq();
+            payload.read = &(batch->reads[i]);
+            payload.readLength = static_cast<unsigned int>(read_seq.length());
+            MEMREF tmp = {read_seq.c_str(), read_seq.length()};
+            (void)acism_scan(ctx->psp, tmp, (ACISM_ACTION*)on_batch_match, &payload);
+        }
+    } catch (crispr::exception& e) {
+        batch->failed = true;
+        batch->errorMsg = e.what();
+    } catch (std::exception& e) {
+        batch->failed = true;
+        batch->errorMsg = e.what();
+    }
+}
+
+// where the reads recruited by singletonBatch end up
+typedef struct _singleton_merge_context {
+    ReadMap * mReads;
+    ReadStore * mReadStore;
+    StringCheck * mStringCheck;
+} SingletonMergeContext;
+
+static void mergeSingletonBatch(ReadBatch * batch, void * mergeContext)
+{
+    //-----
+    // Local tokens are handed out in the order the DRs were first seen
+    // in the batch, so walking them in order hands out global tokens in 
+    // the same order as a single threaded scan would
+    //
+    SingletonMergeContext * ctx = static_cast<SingletonMergeContext *>(mergeContext);
+    if (batch->failed) 
+    {
+        throw crispr::exception(__FILE__, 
+                                __LINE__, 
+                                __PRETTY_FUNCTION__,
+                                batch->errorMsg.c_str());
+    }
+    StringCheck& local_check = batch->localStringCheck;
+    for (StringToken local_token = local_check.firstToken(); local_token <= local_check.mNextFreeToken; local_token++) 
+    {
+        std::string dr_lowlexi = local_check.getString(local_token);
+        StringToken st = ctx->mStringCheck->getToken(dr_lowlexi);
+        if(0 == st)
+        {
+            st = ctx->mStringCheck->addString(dr_lowlexi);
+            (*(ctx->mReads))[st] = new ReadList();
+        }
+        ReadList * local_list = batch->localReads[local_token];
+        ReadList * global_list = (*(ctx->mReads))[st];
+        ReadListIterator list_iter;
+        for (list_iter = local_list->begin(); list_iter != local_list->end(); ++list_iter) 
+        {
+            bool duplicate;
+            ReadIndex index = ctx->mReadStore->add(batch->localStore, *list_iter, &duplicate);
+            if (! duplicate) 
+            {
+                global_list->push_back(index);
+            }
+        }
+        delete local_list;
+    }
+    batch->localReads.clear();
+}
+
 void findSingletons(const char *inputFastq, 
                     const options &opts, 
                     std::vector<std::string> * nonRedundantPatterns, 
-                    lookupTable &readsFound, 
+                    HeaderSet &readsFound, 
                     ReadMap * mReads, 
+                    ReadStore * mReadStore, 
                     StringCheck * mStringCheck,
-                    time_t& startTime)
+                    time_t& startTime,
+                    long skipReads,
+                    long maxReads)
 {
+    //-----
+    // Recruit reads that contain one of the known direct repeats. The first
+    // skipReads reads are passed over and at most maxReads are looked at
+    // (-1 for all of them), which is used for reading back a spill file
+    //
     std::string conc;
     std::vector<std::string>::iterator iter;
     for( iter = nonRedundantPatterns->begin(); iter != nonRedundantPatterns->end(); ++iter) {
@@ -468,24 +999,77 @@ void findSingletons(const char *inputFastq,
 
     ACISM *psp = acism_create(pattv, npatts);
 
-    gzFile fp = getFileHandle(inputFastq);
+    static int read_counter = 0;
+    time_t time_current;
+
+#ifndef SEARCH_SINGLETON
+    if (opts.numThreads > 1) 
+    {
+        SingletonContext task_context;
+        task_context.psp = psp;
+        task_context.pattv = pattv;
+        task_context.readsFound = &readsFound;
+
+        SingletonMergeContext merge_context;
+        merge_context.mReads = mReads;
+        merge_context.mReadStore = mReadStore;
+        merge_context.mStringCheck = mStringCheck;
+
+        try {
+            processFileInBatches(inputFastq, 
+                                 opts.numThreads, 
+                                 singletonBatch, 
+                                 &task_context, 
+                                 mergeSingletonBatch, 
+                                 &merge_context, 
+                                 "singletonFinder", 
+                                 startTime, 
+                                 read_counter,
+                                 skipReads,
+                                 maxReads);
+        } catch (crispr::exception& e) {
+            acism_destroy(psp);
+            free(pattv);
+            delete[] concstr;
+            throw;
+        }
+        acism_destroy(psp);
+        free(pattv);
+        delete[] concstr;
+
+        time(&time_current);
+        double diff = difftime(time_current, startTime);
+        std::cout<<"\r["<<PACKAGE_NAME<<"_singletonFinder]: "<<"Processed "<<read_counter<<" ...";
+        std::cout<<diff<<" sec"<<std::flush;
+        return;
+    }
+#endif
+
+    InputStream input(inputFastq, opts.numThreads);
     kseq_t *seq;
-    seq = kseq_init(fp);
+    seq = kseq_init_reader(&input, InputStream::readStream);
 
     int l;
     int log_counter = 0;
-    static int read_counter = 0;
-
-    time_t time_current;
 
+    ReadHolder recruit_holder;
     MultisearchPayload payload;
     payload.mReads = mReads;
+    payload.mReadStore = mReadStore;
     payload.mStringCheck = mStringCheck;
+    payload.holder = &recruit_holder;
     payload.pattv = pattv;
     payload.readsFound = &readsFound;
+
+    while (skipReads > 0 && kseq_read(seq) >= 0) 
+    {
+        skipReads--;
+    }
     
-    while ( (l = kseq_read(seq)) >= 0 ) 
+    long reads_taken = 0;
+    while ( (maxReads < 0 || reads_taken < maxReads) && (l = kseq_read(seq)) >= 0 ) 
     {
+        reads_taken++;
         // seq is a read what we love
         // search it for the patterns until found
         if (log_counter == CRASS_DEF_READ_COUNTER_LOGGER) 
@@ -506,8 +1090,9 @@ void findSingletons(const char *inputFastq,
         read_counter++;
     }
 
-    gzclose(fp);
     kseq_destroy(seq); // destroy seq
+    acism_destroy(psp);
+    free(pattv);
     delete[] concstr;
 
     time(&time_current);
@@ -865,6 +1450,19 @@ bool testRepeatSpacerLengthDiff(int difference)
 #endif
     return true;
 }
+static float compareSimilarity(std::string& s1, std::string& s2, float threshold)
+{
+    try {
+        return PatternMatcher::getStringSimilarity(s1, s2, threshold);
+    } catch (std::exception& e) {
+        std::cerr<<"Failed to compare similarity between: "<<s1<<" : "<<s2<<std::endl;
+        throw crispr::exception(__FILE__,
+                                __LINE__,
+                                __PRETTY_FUNCTION__,
+                                e.what());
+    }
+}
+
 //need at least two elements
 bool qcFoundRepeats(ReadHolder& tmp_holder, int minSpacerLength, int maxSpacerLength)
 {
@@ -922,26 +1520,9 @@ bool qcFoundRepeats(ReadHolder& tmp_holder, int minSpacerLength, int maxSpacerLe
         {
 
             num_compared++;
-            try {
-            	ave_repeat_to_spacer_difference += PatternMatcher::getStringSimilarity(repeat, *spacer_iter);
-            } catch (std::exception& e) {
-                std::cerr<<"Failed to compare similarity between: "<<repeat<<" : "<<*spacer_iter<<std::endl;
-                throw crispr::exception(__FILE__,
-                                        __LINE__,
-                                        __PRETTY_FUNCTION__,
-                                        e.what());
-            }
-            float ss_diff = 0;
-            try {
-            	ss_diff += PatternMatcher::getStringSimilarity(*spacer_iter, *(spacer_iter + 1));
-			} catch (std::exception& e) {
-                std::cerr<<"Failed to compare similarity between: "<<*spacer_iter<<" : "<<*(spacer_iter+1)<<std::endl;
-                throw crispr::exception(__FILE__,
-                                        __LINE__,
-                                        __PRETTY_FUNCTION__,
-                                        e.what());
-			}
-            ave_spacer_to_spacer_difference += ss_diff;
+            // only need the exact similarity when it could push the average over the limit
+            ave_repeat_to_spacer_difference += compareSimilarity(repeat, *spacer_iter, CRASS_DEF_SPACER_OR_REPEAT_MAX_SIMILARITY);
+            ave_spacer_to_spacer_difference += compareSimilarity(*spacer_iter, *(spacer_iter + 1), CRASS_DEF_SPACER_OR_REPEAT_MAX_SIMILARITY);
 
             //MI std::cout << ss_diff << " : " << *spacer_iter << " : " << *(spacer_iter + 1) << std::endl;
             ave_spacer_to_spacer_len_difference += (static_cast<float>(spacer_iter->size()) - static_cast<float>((spacer_iter + 1)->size()));
@@ -978,6 +1559,25 @@ bool qcFoundRepeats(ReadHolder& tmp_holder, int minSpacerLength, int maxSpacerLe
             // we can keep going!
             ave_spacer_to_spacer_difference /= static_cast<float>(num_compared);
             ave_repeat_to_spacer_difference /= static_cast<float>(num_compared);
+            
+            //-----
+            // The similarities above are only exact when they are over the limit,
+            // the rest are upper bounds. So an average that still passes would
+            // have passed anyway but one that fails has to be worked out properly
+            //
+            if (ave_spacer_to_spacer_difference > CRASS_DEF_SPACER_OR_REPEAT_MAX_SIMILARITY || 
+                ave_repeat_to_spacer_difference > CRASS_DEF_SPACER_OR_REPEAT_MAX_SIMILARITY) 
+            {
+                ave_spacer_to_spacer_difference = 0.0;
+                ave_repeat_to_spacer_difference = 0.0;
+                for (spacer_iter = spacer_vec.begin(); spacer_iter != spacer_vec.end() - 1; spacer_iter++) 
+                {
+                    ave_repeat_to_spacer_difference += compareSimilarity(repeat, *spacer_iter, -1.0);
+                    ave_spacer_to_spacer_difference += compareSimilarity(*spacer_iter, *(spacer_iter + 1), -1.0);
+                }
+                ave_spacer_to_spacer_difference /= static_cast<float>(num_compared);
+                ave_repeat_to_spacer_difference /= static_cast<float>(num_compared);
+            }
             ave_spacer_to_spacer_len_difference = abs(ave_spacer_to_spacer_len_difference /= static_cast<float>(num_compared));
             ave_repeat_to_spacer_len_difference = abs(ave_repeat_to_spacer_len_difference /= static_cast<float>(num_compared));
             
@@ -1012,7 +1612,7 @@ bool qcFoundRepeats(ReadHolder& tmp_holder, int minSpacerLength, int maxSpacerLe
         {
             return false;
         }
-        float similarity = PatternMatcher::getStringSimilarity(repeat, spacer);
+        float similarity = PatternMatcher::getStringSimilarity(repeat, spacer, CRASS_DEF_SPACER_OR_REPEAT_MAX_SIMILARITY);
         if(! testSpacerRepeatSimilarity(similarity))
         {
             return false;
@@ -1117,14 +1717,17 @@ bool drHasHighlyAbundantKmers(std::string& directRepeat, float& maxFrequency)
 }
 
 void addReadHolder(ReadMap * mReads, 
+                   ReadStore * mReadStore, 
                    StringCheck * mStringCheck, 
                    ReadHolder& tmpReadholder)
 {
-
-    ReadHolder * candidate = new ReadHolder(tmpReadholder);
+    //-----
+    // the read is turned around into its low lexi form and packed
+    // straight into the store, no copy of it is made on the way
+    //
     std::string dr_lowlexi;
 	try {
-		dr_lowlexi = candidate->DRLowLexi();
+		dr_lowlexi = tmpReadholder.DRLowLexi();
 	} catch(crispr::exception& e) {
 		std::cerr<<e.what()<<std::endl;
 		throw crispr::exception(__FILE__,
@@ -1158,6 +1761,12 @@ void addReadHolder(ReadMap * mReads,
     }
 #endif
 
-    (*mReads)[st]->push_back(candidate);
+    // a copy of a read we already have only adds to its count
+    bool duplicate;
+    ReadIndex index = mReadStore->add(tmpReadholder, &duplicate);
+    if (! duplicate) 
+    {
+        (*mReads)[st]->push_back(index);
+    }
 }
 
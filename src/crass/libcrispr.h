@@ -51,8 +51,11 @@
 #include "PatternMatcher.h"
 #include "kseq.h"
 #include "ReadHolder.h"
+#include "HeaderSet.h"
+#include "RepeatSeeder.h"
 #include "SeqUtils.h"
 #include "StringCheck.h"
+#include "SingletonSpill.h"
 #include "Types.h"
 #if SEARCH_SINGLETON
 #include "SearchChecker.h"
@@ -71,31 +74,60 @@ enum side{rightSide, leftSide};
 //**************************************
 // search functions
 //**************************************
+
+// how far the reads got through the tests in searchCore
+typedef struct _search_counters {
+    long reads;                         // reads that were searched
+    long prefilterRejects;              // thrown out by RepeatSeeder::mayRepeat without a full search
+    long repeatedKmers;                 // had at least minNumRepeats repeated kmers
+    long repeatLength;                  // and could be extended to a repeat of the right length
+    long passedQc;                      // and passed qcFoundRepeats, these are the hits
+} SearchCounters;
+
+void clearSearchCounters(SearchCounters& counters);
+
+void addSearchCounters(SearchCounters& total, const SearchCounters& counters);
+
 int searchFile(const char *inputFile, 
                       const options &opts, 
                       ReadMap * mReads, 
+                      ReadStore * mReadStore, 
                       StringCheck * mStringCheck, 
                       lookupTable& patternsHash, 
-                      lookupTable& readsFound,
-                      time_t& startTime);
+                      HeaderSet& readsFound,
+                      time_t& startTime,
+                      SingletonSpill * spill = NULL,
+                      SearchCounters * counters = NULL);
 
+// the seeder's tables are reused between reads, so keep one per thread
 int searchCore(ReadHolder& seq, 
-                   const options &opts
+                   const options &opts,
+                   RepeatSeeder& seeder,
+                   SearchCounters * counters = NULL
                    );
 
 void findSingletons(const char *inputFastq, 
                     const options &opts, 
                     std::vector<std::string> * nonRedundantPatterns, 
-                    lookupTable &readsFound, 
+                    HeaderSet &readsFound, 
                     ReadMap * mReads, 
+                    ReadStore * mReadStore, 
                     StringCheck * mStringCheck,
-                    time_t& startTime);
+                    time_t& startTime,
+                    long skipReads = 0,
+                    long maxReads = -1);
 
 int scanRight(ReadHolder& tmp_holder, 
               std::string& pattern, 
               unsigned int minSpacerLength, 
               unsigned int scanRange);
 
+int scanRight(ReadHolder& tmp_holder, 
+              const char * pattern, 
+              unsigned int patternLength, 
+              unsigned int minSpacerLength, 
+              unsigned int scanRange);
+
 unsigned int extendPreRepeat(ReadHolder& tmp_holder, 
                              int searchWindowLength,
                              int minSpacerLength);
@@ -120,7 +152,10 @@ bool drHasHighlyAbundantKmers(std::string& directRepeat, float& max_count);
 
 bool drHasHighlyAbundantKmers(std::string& directRepeat);
 
+// packs the read into the store under its low lexi repeat, the holder
+// is left turned around into that form
 void addReadHolder(ReadMap * mReads, 
+                   ReadStore * mReadStore, 
                    StringCheck * mStringCheck, 
                    ReadHolder& tmp_holder);
 
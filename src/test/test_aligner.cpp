@@ -0,0 +1,157 @@
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <sys/time.h>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "Aligner.h"
+#include "LoggerSimp.h"
+#include "ReadHolder.h"
+#include "ReadStore.h"
+#include "StringCheck.h"
+#include "SeqUtils.h"
+
+static void setUpLogger(void) {
+    static bool logger_ready = false;
+    if (! logger_ready) {
+        intialiseGlobalLogger("", 0);
+        logger_ready = true;
+    }
+}
+
+// a group of DRs, each with reads holding two copies of it
+class TestGroup {
+    public:
+        TestGroup(void) : TG_Aligner(NULL) {}
+        ~TestGroup(void) {
+            delete TG_Aligner;
+            ReadMapIterator read_iter;
+            for (read_iter = TG_Reads.begin(); read_iter != TG_Reads.end(); ++read_iter) {
+                delete read_iter->second;
+            }
+        }
+
+        StringToken addDR(const std::string& dr, int numReads) {
+            StringToken token = TG_Strings.addString(dr);
+            TG_Reads[token] = new ReadList();
+            for (int i = 0; i < numReads; i++) {
+                std::string spacer = randomSeq(30);
+                ReadHolder read(randomSeq(20) + dr + spacer + dr + randomSeq(20), "read");
+                read.startStopsAdd(20, 20 + dr.length() - 1);
+                read.startStopsAdd(50 + dr.length(), 50 + 2 * dr.length() - 1);
+                read.setRepeatLength(static_cast<int>(dr.length()));
+                read.setDRLowLexi(true);
+                TG_Reads[token]->push_back(TG_Store.add(read));
+            }
+            return token;
+        }
+
+        Aligner& aligner(StringToken master, int length = CRASS_DEF_MIN_CONS_ARRAY_LEN) {
+            delete TG_Aligner;
+            TG_Aligner = new Aligner(length, &TG_Reads, &TG_Store, &TG_Strings);
+            TG_Aligner->setMasterDR(master);
+            return *TG_Aligner;
+        }
+
+        std::string dr(StringToken token) {
+            return TG_Strings.getString(token);
+        }
+
+    private:
+        StringCheck TG_Strings;
+        ReadMap TG_Reads;
+        ReadStore TG_Store;
+        Aligner * TG_Aligner;
+};
+
+TEST_CASE("slaves are placed against the master", "[aligner]") {
+    setUpLogger();
+    std::string master = randomSeq(32);
+    TestGroup group;
+    StringToken master_token = group.addDR(master, 3);
+    StringToken shifted_token = group.addDR(master.substr(2), 3);
+    StringToken reversed_token = group.addDR(reverseComplement(master.substr(0, 30)), 3);
+    StringToken reversed_before = reversed_token;
+
+    Aligner& aligner = group.aligner(master_token);
+    aligner.alignSlave(shifted_token);
+    aligner.alignSlave(reversed_token);
+    REQUIRE(aligner.offset(shifted_token) == aligner.offset(master_token) + 2);
+
+    // the reversed slave is turned round and given a new token
+    REQUIRE(reversed_token != reversed_before);
+    REQUIRE(group.dr(reversed_token) == master.substr(0, 30));
+    REQUIRE(aligner.offset(reversed_token) == aligner.offset(master_token));
+}
+
+TEST_CASE("the coverage array only holds where reads were placed", "[aligner]") {
+    setUpLogger();
+    std::string master = randomSeq(32);
+    TestGroup group;
+    StringToken master_token = group.addDR(master, 3);
+    StringToken shifted_token = group.addDR(master.substr(2), 3);
+
+    // as long as a 100Mb read would make it, far too big to hold
+    Aligner& aligner = group.aligner(master_token, 400000000);
+    aligner.alignSlave(shifted_token);
+    aligner.generateConsensus();
+    int master_start = aligner.offset(master_token);
+    for (int i = 0; i < static_cast<int>(master.length()); i++) {
+        REQUIRE(aligner.consensusAt(master_start + i) == master[i]);
+    }
+    // each read holds the DR twice and is placed at both
+    REQUIRE(aligner.coverageAt(master_start, master[0]) == 6);
+    REQUIRE(aligner.depthAt(master_start + 2) == 12);
+    REQUIRE(aligner.depthAt(0) == 0);
+    REQUIRE(aligner.consensusAt(0) == 'N');
+    REQUIRE(aligner.conservationAt(0) == 0.0f);
+}
+
+TEST_CASE("a tied position goes to the first base", "[aligner]") {
+    setUpLogger();
+    std::string master = randomSeq(32);
+    master[10] = 'G';
+    std::string variant = master;
+    variant[10] = 'C';
+    TestGroup group;
+    StringToken master_token = group.addDR(master, 3);
+    StringToken variant_token = group.addDR(variant, 3);
+
+    Aligner& aligner = group.aligner(master_token);
+    aligner.alignSlave(variant_token);
+    aligner.generateConsensus();
+    int master_start = aligner.offset(master_token);
+    REQUIRE(aligner.offset(variant_token) == master_start);
+    REQUIRE(aligner.consensusAt(master_start + 10) == 'C');
+    REQUIRE(aligner.depthAt(master_start + 10) == 12);
+    REQUIRE(aligner.conservationAt(master_start + 10) == 0.5f);
+    REQUIRE(aligner.conservationAt(master_start + 11) == 1.0f);
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("aligning 1k to 10k slaves against a master", "[.][benchmark]") {
+    setUpLogger();
+    for (int num_slaves = 1000; num_slaves <= 10000; num_slaves *= 10) {
+        std::string master = randomSeq(36);
+        TestGroup group;
+        StringToken master_token = group.addDR(master, 3);
+        std::vector<StringToken> slaves;
+        for (int i = 0; i < num_slaves; i++) {
+            // a base or two off and trimmed, half of them the other way round
+            std::string slave = master.substr(i % 3, 32);
+            slave[rand() % slave.length()] = "ACGT"[rand() % 4];
+            slave[rand() % slave.length()] = "ACGT"[rand() % 4];
+            slaves.push_back(group.addDR((i % 2) ? reverseComplement(slave) : slave, 1));
+        }
+        Aligner& aligner = group.aligner(master_token);
+        struct timeval before;
+        gettimeofday(&before, NULL);
+        for (size_t i = 0; i < slaves.size(); i++) {
+            aligner.alignSlave(slaves[i]);
+        }
+        double secs = secondsSince(before);
+        std::cout<<std::endl<<num_slaves<<" slaves: "<<secs<<" sec, "<<num_slaves / secs<<" alignments/sec"<<std::endl;
+    }
+}
@@ -0,0 +1,133 @@
+#include <vector>
+#include <iostream>
+#include <sys/time.h>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "CrisprNode.h"
+
+static std::vector<StringToken> edgeIds(CrisprNode& node, EDGE_TYPE type) {
+    std::vector<StringToken> ids;
+    edgeList * edges = node.getEdges(type);
+    for (edgeListIterator edge_iter = edges->begin(); edge_iter != edges->end(); ++edge_iter) {
+        ids.push_back(edge_iter->id);
+    }
+    return ids;
+}
+
+TEST_CASE("edges are kept once each in id order", "[crisprnode]") {
+    CrisprNode root(1);
+    CrisprNode a(7), b(3), c(5);
+    REQUIRE(root.addEdge(&a, CN_EDGE_FORWARD));
+    REQUIRE(root.addEdge(&b, CN_EDGE_FORWARD));
+    REQUIRE(root.addEdge(&c, CN_EDGE_FORWARD));
+    REQUIRE_FALSE(root.addEdge(&b, CN_EDGE_FORWARD));
+    REQUIRE(root.addEdge(&b, CN_EDGE_JUMPING_F));
+    REQUIRE(root.getRank(CN_EDGE_FORWARD) == 3);
+    REQUIRE(root.getRank(CN_EDGE_JUMPING_F) == 1);
+    REQUIRE(root.getTotalRank() == 4);
+
+    std::vector<StringToken> ids = edgeIds(root, CN_EDGE_FORWARD);
+    REQUIRE(ids.size() == 3);
+    REQUIRE(ids[0] == 3);
+    REQUIRE(ids[1] == 5);
+    REQUIRE(ids[2] == 7);
+    edgeList * edges = root.getEdges(CN_EDGE_FORWARD);
+    REQUIRE(edges->begin()->node == &b);
+    REQUIRE(edges->begin()->attached);
+
+    REQUIRE(root.findEdge(edges, 5)->node == &c);
+    REQUIRE(root.findEdge(edges, 6)->id == 7);
+    REQUIRE(root.findEdge(edges, 8) == edges->end());
+}
+
+TEST_CASE("detaching a node updates its partners", "[crisprnode]") {
+    // first -F-> second -JF-> third, the way a read lays them down
+    CrisprNode first(1), second(2), third(3);
+    first.addEdge(&second, CN_EDGE_FORWARD);
+    second.addEdge(&first, CN_EDGE_BACKWARD);
+    second.addEdge(&third, CN_EDGE_JUMPING_F);
+    third.addEdge(&second, CN_EDGE_JUMPING_B);
+
+    third.detachNode();
+    REQUIRE_FALSE(third.isAttached());
+    REQUIRE_FALSE(third.getEdges(CN_EDGE_JUMPING_B)->begin()->attached);
+    REQUIRE(second.getRank(CN_EDGE_JUMPING_B) == -1);
+
+    // the partner is given an edge of the same type back to us, switched off
+    std::vector<StringToken> ids = edgeIds(second, CN_EDGE_JUMPING_B);
+    REQUIRE(ids.size() == 1);
+    REQUIRE(ids[0] == 3);
+    REQUIRE_FALSE(second.getEdges(CN_EDGE_JUMPING_B)->begin()->attached);
+    REQUIRE(second.getEdges(CN_EDGE_JUMPING_F)->begin()->attached);
+
+    third.reattachNode();
+    REQUIRE(third.isAttached());
+    REQUIRE(third.getEdges(CN_EDGE_JUMPING_B)->begin()->attached);
+    REQUIRE(second.getEdges(CN_EDGE_JUMPING_B)->begin()->attached);
+    REQUIRE(second.getRank(CN_EDGE_JUMPING_B) == 0);
+    REQUIRE(edgeIds(second, CN_EDGE_JUMPING_B).size() == 1);
+
+    // losing the last edge detaches the partner as well
+    CrisprNode lonely(4), cap(5);
+    cap.addEdge(&lonely, CN_EDGE_FORWARD);
+    lonely.addEdge(&cap, CN_EDGE_FORWARD);
+    cap.detachNode();
+    REQUIRE(lonely.getTotalRank() == 0);
+    REQUIRE_FALSE(lonely.isAttached());
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("walking the edges of 200k nodes", "[.][benchmark]") {
+    // spacers laid end to end with a few forks, like a busy group
+    const int num_nodes = 200000;
+    std::vector<CrisprNode *> nodes;
+    nodes.reserve(num_nodes);
+    for (int i = 0; i < num_nodes; i++) {
+        nodes.push_back(new CrisprNode(i + 1));
+    }
+    struct timeval before;
+    gettimeofday(&before, NULL);
+    for (int i = 0; i + 1 < num_nodes; i++) {
+        EDGE_TYPE out = (i % 2) ? CN_EDGE_JUMPING_F : CN_EDGE_FORWARD;
+        EDGE_TYPE in = (i % 2) ? CN_EDGE_JUMPING_B : CN_EDGE_BACKWARD;
+        nodes[i]->addEdge(nodes[i + 1], out);
+        nodes[i + 1]->addEdge(nodes[i], in);
+        if (i % 2 && i + 3 < num_nodes) {
+            nodes[i]->addEdge(nodes[i + 3], out);
+            nodes[i + 3]->addEdge(nodes[i], in);
+        }
+    }
+    double build_secs = secondsSince(before);
+
+    // what cleaning does over and over: look at every edge of every node
+    gettimeofday(&before, NULL);
+    long attached_edges = 0;
+    for (int pass = 0; pass < 20; pass++) {
+        for (int i = 0; i < num_nodes; i++) {
+            for (int type = CN_EDGE_BACKWARD; type < CN_EDGE_ERROR; type++) {
+                edgeList * edges = nodes[i]->getEdges(static_cast<EDGE_TYPE>(type));
+                for (edgeListIterator edge_iter = edges->begin(); edge_iter != edges->end(); ++edge_iter) {
+                    attached_edges += edge_iter->attached && (edge_iter->node)->isAttached();
+                }
+            }
+        }
+    }
+    double walk_secs = secondsSince(before);
+
+    gettimeofday(&before, NULL);
+    for (int i = 0; i < num_nodes; i += 3) {
+        nodes[i]->detachNode();
+    }
+    for (int i = 0; i < num_nodes; i += 3) {
+        nodes[i]->reattachNode();
+    }
+    double detach_secs = secondsSince(before);
+    REQUIRE(attached_edges > 0);
+
+    std::cout<<std::endl<<num_nodes<<" nodes: build "<<build_secs<<" sec, 20 walks "<<walk_secs
+             <<" sec, detach and reattach a third "<<detach_secs<<" sec"<<std::endl;
+    for (int i = 0; i < num_nodes; i++) {
+        delete nodes[i];
+    }
+}
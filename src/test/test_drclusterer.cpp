@@ -0,0 +1,177 @@
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sys/time.h>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "DRClusterer.h"
+#include "SeqUtils.h"
+
+// a few hundred repeats, each with variants a base or two off
+static std::vector<std::string> makeVariants(int numRepeats, int numVariants) {
+    std::vector<std::string> repeats;
+    for (int i = 0; i < numRepeats; i++) {
+        repeats.push_back(randomSeq(32 + i % 8));
+    }
+    std::vector<std::string> variants;
+    for (int i = 0; i < numVariants; i++) {
+        std::string variant = repeats[i % repeats.size()];
+        variant[rand() % variant.length()] = "ACGT"[rand() % 4];
+        variant[rand() % variant.length()] = "ACGT"[rand() % 4];
+        variants.push_back((i % 2) ? reverseComplement(variant) : variant);
+    }
+    return variants;
+}
+
+// variants of a single repeat, up to three bases off and trimmed at
+// either end, as a run dominated by one CRISPR gives
+static std::vector<std::string> makeOneRepeatVariants(int numVariants) {
+    std::string repeat = randomSeq(36);
+    std::vector<std::string> variants;
+    for (int i = 0; i < numVariants; i++) {
+        std::string variant = repeat.substr(rand() % 4);
+        variant = variant.substr(0, variant.length() - rand() % 4);
+        for (int j = 0; j < 3; j++) {
+            variant[rand() % variant.length()] = "ACGT"[rand() % 4];
+        }
+        variants.push_back((i % 2) ? reverseComplement(variant) : variant);
+    }
+    std::sort(variants.begin(), variants.end());
+    variants.erase(std::unique(variants.begin(), variants.end()), variants.end());
+    return variants;
+}
+
+TEST_CASE("DRs sharing enough kmers are clustered", "[drclusterer]") {
+    std::string x = randomSeq(80);
+    std::vector<std::string> drs;
+    drs.push_back(x.substr(0, 40));
+    drs.push_back(randomSeq(35));
+    // 20 bases, 10 kmers, shared with the first
+    drs.push_back(reverseComplement(x.substr(20, 40)));
+    // only shares with the one before
+    drs.push_back(x.substr(40, 40));
+    // 15 bases, 5 kmers, shared with the first
+    drs.push_back(randomSeq(25) + x.substr(0, 15));
+    drs.push_back("ACGT");
+
+    DRClusterer clusterer(11, 6, 2);
+    std::vector<int> cluster_of;
+    clusterer.cluster(drs, cluster_of);
+    REQUIRE(cluster_of.size() == drs.size());
+    REQUIRE(cluster_of[0] == 0);
+    REQUIRE(cluster_of[1] == 1);
+    REQUIRE(cluster_of[2] == 0);
+    REQUIRE(cluster_of[3] == 0);
+    REQUIRE(cluster_of[4] == 4);
+    REQUIRE(cluster_of[5] == 5);
+
+    DRClusterer looser(11, 5, 1);
+    looser.cluster(drs, cluster_of);
+    REQUIRE(cluster_of[4] == 0);
+}
+
+TEST_CASE("DRs are still clustered through kmers held by hundreds of DRs", "[drclusterer]") {
+    // every DR holds the 5 kmers of core, which aren't enough on their own
+    std::string core = randomSeq(15);
+    std::string shared = randomSeq(5) + core;
+    std::vector<std::string> drs;
+    drs.push_back(randomSeq(10) + shared + randomSeq(10));
+    drs.push_back(core);
+    // shares 10 kmers with the first, half of them the common ones. It
+    // sits where the first DR won't sample it
+    drs.push_back(randomSeq(8) + shared + randomSeq(12));
+    for (int i = 0; i < 300; i++) {
+        drs.push_back(core);
+    }
+
+    DRClusterer clusterer(11, 6, 2);
+    std::vector<int> cluster_of;
+    clusterer.cluster(drs, cluster_of);
+    REQUIRE(cluster_of[2] == 0);
+    for (size_t i = 1; i < drs.size(); i++) {
+        if (i != 2) {
+            REQUIRE(cluster_of[i] == static_cast<int>(i));
+        }
+    }
+}
+
+// the clusters as sets of DRs, whatever they are numbered
+static std::vector<std::vector<std::string> > clusterSets(const std::vector<std::string>& drs, const std::vector<int>& clusterOf) {
+    std::map<int, std::vector<std::string> > by_cluster;
+    for (size_t i = 0; i < drs.size(); i++) {
+        by_cluster[clusterOf[i]].push_back(drs[i]);
+    }
+    std::vector<std::vector<std::string> > sets;
+    std::map<int, std::vector<std::string> >::iterator cluster_iter;
+    for (cluster_iter = by_cluster.begin(); cluster_iter != by_cluster.end(); ++cluster_iter) {
+        std::sort(cluster_iter->second.begin(), cluster_iter->second.end());
+        sets.push_back(cluster_iter->second);
+    }
+    std::sort(sets.begin(), sets.end());
+    return sets;
+}
+
+TEST_CASE("clusters do not depend on DR order or threads", "[drclusterer]") {
+    std::vector<std::string> drs = makeVariants(50, 2000);
+    std::sort(drs.begin(), drs.end());
+    drs.erase(std::unique(drs.begin(), drs.end()), drs.end());
+
+    DRClusterer clusterer(11, 6, 1);
+    std::vector<int> cluster_of;
+    clusterer.cluster(drs, cluster_of);
+    std::vector<std::vector<std::string> > expected = clusterSets(drs, cluster_of);
+    REQUIRE(expected.size() >= 50);
+    REQUIRE(expected.size() < drs.size());
+    // every cluster is numbered by its first DR
+    for (size_t i = 0; i < drs.size(); i++) {
+        REQUIRE(cluster_of[i] <= static_cast<int>(i));
+        REQUIRE(cluster_of[cluster_of[i]] == cluster_of[i]);
+    }
+
+    std::reverse(drs.begin(), drs.end());
+    DRClusterer threaded(11, 6, 4);
+    threaded.cluster(drs, cluster_of);
+    REQUIRE(clusterSets(drs, cluster_of) == expected);
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("clustering 200k DR variants", "[.][benchmark]") {
+    std::vector<std::string> drs = makeVariants(2000, 200000);
+    std::sort(drs.begin(), drs.end());
+    drs.erase(std::unique(drs.begin(), drs.end()), drs.end());
+    std::vector<int> cluster_of;
+    for (unsigned int num_threads = 1; num_threads <= 4; num_threads *= 2) {
+        DRClusterer clusterer(11, 6, num_threads);
+        struct timeval before;
+        gettimeofday(&before, NULL);
+        clusterer.cluster(drs, cluster_of);
+        double secs = secondsSince(before);
+        size_t num_clusters = 0;
+        for (size_t i = 0; i < drs.size(); i++) {
+            num_clusters += (cluster_of[i] == static_cast<int>(i));
+        }
+        std::cout<<std::endl<<drs.size()<<" variants into "<<num_clusters<<" clusters with "<<num_threads<<" threads: "
+                 <<secs<<" sec, index "<<clusterer.memoryUsage() / (1024 * 1024)<<" MB"<<std::endl;
+    }
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("clustering 100k variants of a single repeat", "[.][benchmark]") {
+    std::vector<std::string> drs = makeOneRepeatVariants(150000);
+    REQUIRE(drs.size() >= 100000);
+    std::vector<int> cluster_of;
+    DRClusterer clusterer(11, 6, 1);
+    struct timeval before;
+    gettimeofday(&before, NULL);
+    clusterer.cluster(drs, cluster_of);
+    double secs = secondsSince(before);
+    size_t num_clusters = 0;
+    for (size_t i = 0; i < drs.size(); i++) {
+        num_clusters += (cluster_of[i] == static_cast<int>(i));
+    }
+    std::cout<<std::endl<<drs.size()<<" variants of one repeat into "<<num_clusters<<" clusters: "<<secs<<" sec"<<std::endl;
+}
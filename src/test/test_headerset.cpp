@@ -0,0 +1,109 @@
+#include <string>
+#include <map>
+#include <iostream>
+#include <cstdio>
+#include <sys/time.h>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "HeaderSet.h"
+
+static std::string readHeader(long i) {
+    char header[64];
+    sprintf(header, "HWI-ST1234:8:%ld:%ld:%ld#0/1", 1101 + i % 64, (i * 7919) % 20000, i);
+    return header;
+}
+
+TEST_CASE("headers that went in are found", "[headerset]") {
+    HeaderSet found;
+    REQUIRE(found.size() == 0);
+    REQUIRE_FALSE(found.contains("read_1"));
+
+    REQUIRE(found.insert("read_1"));
+    REQUIRE(found.insert(std::string("")));
+    REQUIRE_FALSE(found.insert("read_1"));
+    REQUIRE(found.size() == 2);
+
+    REQUIRE(found.contains("read_1"));
+    REQUIRE(found.contains(""));
+    REQUIRE_FALSE(found.contains("read_2"));
+
+    // straight out of a buffer that holds more than the header
+    const char * buffer = "read_1 some comment";
+    REQUIRE(found.contains(buffer, 6));
+    REQUIRE_FALSE(found.contains(buffer, 5));
+
+    found.clear();
+    REQUIRE(found.size() == 0);
+    REQUIRE_FALSE(found.contains("read_1"));
+}
+
+TEST_CASE("header set keeps every header as it grows", "[headerset]") {
+    HeaderSet found;
+    const long num_headers = 200000;
+    for (long i = 0; i < num_headers; i += 2) {
+        REQUIRE(found.insert(readHeader(i)));
+    }
+    REQUIRE(found.size() == static_cast<size_t>(num_headers / 2));
+    for (long i = 0; i < num_headers; i++) {
+        REQUIRE(found.contains(readHeader(i)) == (i % 2 == 0));
+    }
+}
+
+TEST_CASE("header sets with the same headers are equal", "[headerset]") {
+    HeaderSet lhs, rhs;
+    for (long i = 0; i < 5000; i++) {
+        lhs.insert(readHeader(i));
+    }
+    // the other way round, so the tables are laid out differently
+    for (long i = 4999; i >= 0; i--) {
+        rhs.insert(readHeader(i));
+    }
+    REQUIRE(lhs == rhs);
+    rhs.insert("one more");
+    REQUIRE_FALSE(lhs == rhs);
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("5M found read headers", "[.][benchmark]") {
+    const long num_headers = 5000000;
+    HeaderSet found;
+    struct timeval before;
+    gettimeofday(&before, NULL);
+    for (long i = 0; i < num_headers; i++) {
+        found.insert(readHeader(i));
+    }
+    double add_secs = secondsSince(before);
+    // half of the lookups miss, like the singleton scan
+    gettimeofday(&before, NULL);
+    long hits = 0;
+    for (long i = num_headers / 2; i < num_headers + num_headers / 2; i++) {
+        hits += found.contains(readHeader(i));
+    }
+    double get_secs = secondsSince(before);
+    REQUIRE(hits == num_headers / 2);
+    std::cout<<std::endl<<num_headers<<" headers: HeaderSet "<<found.memoryUsage() / (1024 * 1024)<<" MB, add "
+             <<add_secs<<" sec, lookup "<<get_secs<<" sec"<<std::endl;
+    found.clear();
+
+    // what readsFound used to be, each node holds the header plus about
+    // 80 bytes of node, string and malloc bookkeeping
+    std::map<std::string, bool> found_map;
+    size_t map_bytes = 0;
+    gettimeofday(&before, NULL);
+    for (long i = 0; i < num_headers; i++) {
+        std::string header = readHeader(i);
+        map_bytes += header.capacity() + 1 + 80;
+        found_map[header] = true;
+    }
+    add_secs = secondsSince(before);
+    gettimeofday(&before, NULL);
+    hits = 0;
+    for (long i = num_headers / 2; i < num_headers + num_headers / 2; i++) {
+        hits += found_map.find(readHeader(i)) != found_map.end();
+    }
+    get_secs = secondsSince(before);
+    REQUIRE(hits == num_headers / 2);
+    std::cout<<num_headers<<" headers: std::map about "<<map_bytes / (1024 * 1024)<<" MB, add "
+             <<add_secs<<" sec, lookup "<<get_secs<<" sec"<<std::endl;
+}
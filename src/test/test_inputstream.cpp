@@ -0,0 +1,136 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <zlib.h>
+
+#include "catch.hpp"
+#include "InputStream.h"
+#include "Exception.h"
+#include "kseq.h"
+
+// enough reads to go over a few input chunks
+static std::string makeFastq(int numReads) {
+    std::string fastq;
+    const char bases[] = "ACGT";
+    for (int i = 0; i < numReads; i++) {
+        int length = 50 + rand() % 200;
+        fastq += "@read_" + std::string(1, 'a' + i % 26) + " comment\n";
+        std::string seq;
+        for (int j = 0; j < length; j++) {
+            seq += bases[rand() % 4];
+        }
+        fastq += seq + "\n+\n" + std::string(length, 'I') + "\n";
+    }
+    return fastq;
+}
+
+static void writeGzip(const std::string& fileName, const std::string& data) {
+    gzFile fp = gzopen(fileName.c_str(), "wb");
+    gzwrite(fp, data.data(), static_cast<unsigned int>(data.size()));
+    gzclose(fp);
+}
+
+static void putLittleEndian(std::string& out, unsigned long value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+// the same layout bgzip writes, a BC subfield then a raw deflate stream
+static std::string bgzfBlock(const std::string& data) {
+    std::vector<unsigned char> deflated(compressBound(static_cast<uLong>(data.size())) + 64);
+    z_stream stream = z_stream();
+    deflateInit2(&stream, 6, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = &deflated[0];
+    stream.avail_out = static_cast<uInt>(deflated.size());
+    deflate(&stream, Z_FINISH);
+    std::string block("\x1f\x8b\x08\x04\0\0\0\0\0\xff\x06\0BC\x02\0", 16);
+    putLittleEndian(block, 18 + stream.total_out + 8 - 1, 2);
+    block.append(reinterpret_cast<char *>(&deflated[0]), stream.total_out);
+    putLittleEndian(block, crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(data.data()), static_cast<uInt>(data.size())), 4);
+    putLittleEndian(block, data.size(), 4);
+    deflateEnd(&stream);
+    return block;
+}
+
+static void writeBgzf(const std::string& fileName, const std::string& data) {
+    FILE * fp = fopen(fileName.c_str(), "wb");
+    for (size_t i = 0; i < data.size(); i += 65280) {
+        std::string block = bgzfBlock(data.substr(i, 65280));
+        fwrite(block.data(), 1, block.size(), fp);
+    }
+    std::string eof = bgzfBlock("");
+    fwrite(eof.data(), 1, eof.size(), fp);
+    fclose(fp);
+}
+
+static std::vector<std::string> readWithKseq(kseq_t * seq) {
+    std::vector<std::string> records;
+    while (kseq_read(seq) >= 0) {
+        records.push_back(std::string(seq->name.s) + " " + seq->comment.s + " " + seq->seq.s + " " + seq->qual.s);
+    }
+    return records;
+}
+
+static std::vector<std::string> readWithGzread(const std::string& fileName) {
+    gzFile fp = gzopen(fileName.c_str(), "r");
+    kseq_t * seq = kseq_init(fp);
+    std::vector<std::string> records = readWithKseq(seq);
+    kseq_destroy(seq);
+    gzclose(fp);
+    return records;
+}
+
+static std::vector<std::string> readWithStream(const std::string& fileName, unsigned int numThreads, bool expectBgzf) {
+    InputStream input(fileName.c_str(), numThreads);
+    REQUIRE(input.isBgzf() == expectBgzf);
+    kseq_t * seq = kseq_init_reader(&input, InputStream::readStream);
+    std::vector<std::string> records = readWithKseq(seq);
+    kseq_destroy(seq);
+    return records;
+}
+
+TEST_CASE("the input stream gives kseq the same records as gzread", "[inputstream]") {
+    srand(11);
+    std::string fastq = makeFastq(20000);
+    std::string plain_file = "test_inputstream.fq";
+    std::string gzip_file = "test_inputstream.fq.gz";
+    std::string bgzf_file = "test_inputstream.fq.bgz";
+    FILE * fp = fopen(plain_file.c_str(), "wb");
+    fwrite(fastq.data(), 1, fastq.size(), fp);
+    fclose(fp);
+    writeGzip(gzip_file, fastq);
+    writeBgzf(bgzf_file, fastq);
+
+    std::vector<std::string> expected = readWithGzread(plain_file);
+    REQUIRE(expected.size() == 20000);
+    REQUIRE(readWithGzread(bgzf_file) == expected);
+    for (unsigned int threads = 1; threads <= 3; threads += 2) {
+        REQUIRE(readWithStream(plain_file, threads, false) == expected);
+        REQUIRE(readWithStream(gzip_file, threads, false) == expected);
+        REQUIRE(readWithStream(bgzf_file, threads, true) == expected);
+    }
+
+    SECTION("when the parser stops early") {
+        InputStream input(bgzf_file.c_str(), 2);
+        char buffer[1000];
+        REQUIRE(input.read(buffer, 1000) == 1000);
+        REQUIRE(std::string(buffer, 1000) == fastq.substr(0, 1000));
+    }
+    SECTION("when a BGZF block is corrupt") {
+        std::string corrupt = bgzfBlock(fastq.substr(0, 60000));
+        corrupt[corrupt.size() / 2] ^= 0x55;
+        fp = fopen(bgzf_file.c_str(), "wb");
+        fwrite(corrupt.data(), 1, corrupt.size(), fp);
+        fclose(fp);
+        InputStream input(bgzf_file.c_str());
+        std::vector<char> buffer(65536);
+        REQUIRE_THROWS_AS(input.read(&buffer[0], 65536), crispr::runtime_exception&);
+    }
+    remove(plain_file.c_str());
+    remove(gzip_file.c_str());
+    remove(bgzf_file.c_str());
+}
@@ -0,0 +1,125 @@
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+#include <iostream>
+#include <sys/time.h>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "KmerGroupTable.h"
+#include "SeqUtils.h"
+#include "Exception.h"
+
+TEST_CASE("kmer codes are the same when the laurenized kmers are", "[kmergrouptable]") {
+    KmerGroupTable table(11);
+    std::map<std::string, KmerCode> code_for_kmer;
+    std::map<KmerCode, std::string> kmer_for_code;
+    std::vector<KmerCode> kmers;
+    for (int i = 0; i < 2000; i++) {
+        std::string seq;
+        if (i % 10 == 0) {
+            // the odd ones that have to be looked up by string
+            seq = randomSeq(30, "ACGTNa", 6);
+        } else {
+            // a short alphabet so the same kmers keep turning up
+            seq = randomSeq(30, "AT", 2);
+            if (i % 3 == 0) {
+                seq = reverseComplement(seq);
+            }
+        }
+        table.cutKmers(seq, kmers);
+        REQUIRE(kmers.size() == 20);
+        for (size_t j = 0; j < kmers.size(); j++) {
+            std::string kmer = laurenize(seq.substr(j, 11));
+            if (code_for_kmer.find(kmer) == code_for_kmer.end()) {
+                code_for_kmer[kmer] = kmers[j];
+            }
+            if (kmer_for_code.find(kmers[j]) == kmer_for_code.end()) {
+                kmer_for_code[kmers[j]] = kmer;
+            }
+            REQUIRE(code_for_kmer[kmer] == kmers[j]);
+            REQUIRE(kmer_for_code[kmers[j]] == kmer);
+        }
+    }
+
+    table.cutKmers("ACGTACGTAC", kmers);
+    REQUIRE(kmers.empty());
+    REQUIRE_THROWS_AS(KmerGroupTable(16), crispr::exception&);
+}
+
+TEST_CASE("kmers keep their group as the table grows", "[kmergrouptable]") {
+    KmerGroupTable table(11);
+    REQUIRE(table.getGroup(12345) == 0);
+    for (KmerCode kmer = 0; kmer < 100000; kmer++) {
+        table.setGroup(kmer * 41, kmer % 7 + 1);
+    }
+    REQUIRE(table.size() == 100000);
+    table.setGroup(41, 99);
+    REQUIRE(table.size() == 100000);
+    REQUIRE(table.getGroup(41) == 99);
+    for (KmerCode kmer = 2; kmer < 100000; kmer++) {
+        REQUIRE(table.getGroup(kmer * 41) == static_cast<int>(kmer % 7 + 1));
+        REQUIRE(table.getGroup(kmer * 41 + 1) == 0);
+    }
+    table.clear();
+    REQUIRE(table.size() == 0);
+    REQUIRE(table.getGroup(41) == 0);
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("grouping the kmers of 300k DR variants", "[.][benchmark]") {
+    // variants of a few hundred repeats, each a base or two off
+    const int num_variants = 300000;
+    std::vector<std::string> repeats;
+    for (int i = 0; i < 500; i++) {
+        repeats.push_back(randomSeq(32 + i % 8));
+    }
+    std::vector<std::string> variants;
+    variants.reserve(num_variants);
+    for (int i = 0; i < num_variants; i++) {
+        std::string variant = repeats[i % repeats.size()];
+        variant[rand() % variant.length()] = "ACGT"[rand() % 4];
+        variant[rand() % variant.length()] = "ACGT"[rand() % 4];
+        variants.push_back((i % 2) ? reverseComplement(variant) : variant);
+    }
+
+    KmerGroupTable table(11);
+    std::vector<KmerCode> kmers;
+    long grouped = 0;
+    struct timeval before;
+    gettimeofday(&before, NULL);
+    for (int i = 0; i < num_variants; i++) {
+        table.cutKmers(variants[i], kmers);
+        for (size_t j = 0; j < kmers.size(); j++) {
+            if (table.getGroup(kmers[j]) == 0) {
+                table.setGroup(kmers[j], i % repeats.size() + 1);
+            } else {
+                grouped++;
+            }
+        }
+    }
+    double table_secs = secondsSince(before);
+
+    // the way clusterDRReads used to do it
+    std::map<std::string, int> kmer_map;
+    long map_grouped = 0;
+    gettimeofday(&before, NULL);
+    for (int i = 0; i < num_variants; i++) {
+        int num_mers = static_cast<int>(variants[i].length()) - 11 + 1;
+        for (int j = 0; j < num_mers; j++) {
+            std::string kmer = laurenize(variants[i].substr(j, 11));
+            if (kmer_map.find(kmer) == kmer_map.end()) {
+                kmer_map[kmer] = i % repeats.size() + 1;
+            } else {
+                map_grouped++;
+            }
+        }
+    }
+    double map_secs = secondsSince(before);
+    REQUIRE(grouped == map_grouped);
+    REQUIRE(table.size() == kmer_map.size());
+
+    std::cout<<std::endl<<num_variants<<" variants, "<<table.size()<<" kmers: KmerGroupTable "<<table_secs
+             <<" sec ("<<table.memoryUsage() / 1024<<" KB), std::map "<<map_secs<<" sec"<<std::endl;
+}
@@ -0,0 +1,153 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sys/time.h>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "PatternMatcher.h"
+
+TEST_CASE("exact search gives the same answers as Boyer-Moore", "[patternmatcher]") {
+    srand(7);
+    for (int round = 0; round < 50; round++) {
+        std::string text = randomSeq(1 + rand() % 300, (round % 2) ? "ACGT" : "ACGTN", (round % 2) ? 4 : 5);
+        for (size_t k = 1; k <= 12; k++) {
+            // patterns from the text itself so that there are plenty of hits
+            for (size_t j = 0; j + k <= text.size(); j += 3) {
+                const char * pattern = text.data() + j;
+                for (size_t begin = 0; begin < text.size(); begin += 11) {
+                    size_t size = text.size() - begin;
+                    int expected = PatternMatcher::bmpSearch(text.data() + begin, size, pattern, k);
+                    REQUIRE(PatternMatcher::exactSearch(text.data() + begin, size, pattern, k) == expected);
+                    REQUIRE(PatternMatcher::exactSearchScalar(text.data() + begin, size, pattern, k) == expected);
+                }
+            }
+        }
+    }
+    SECTION("edge cases") {
+        REQUIRE(PatternMatcher::exactSearch("ACGT", 0, "A", 1) == -1);
+        REQUIRE(PatternMatcher::exactSearch("ACGT", 4, "A", 0) == -1);
+        REQUIRE(PatternMatcher::exactSearch("ACG", 3, "ACGT", 4) == -1);
+        REQUIRE(PatternMatcher::exactSearch("ACGT", 4, "ACGT", 4) == 0);
+        std::string long_text = std::string(100, 'A') + "CGTTGCA";
+        REQUIRE(PatternMatcher::exactSearch(long_text.data(), long_text.size(), "TTGCA", 5) == 102);
+    }
+    SECTION("bytes outside of ascii") {
+        std::string text = "ACGT\xc3\xa9" "ACGTTGCA\xff";
+        REQUIRE(PatternMatcher::bmpSearch(text, "TTGCA") == 9);
+        REQUIRE(PatternMatcher::bmpSearch(text, "\xa9" "A") == 5);
+        REQUIRE(PatternMatcher::bmpSearch(text, "\xff") == 14);
+    }
+}
+
+// the full matrix edit distance that PatternMatcher used to have
+static int matrixEditDistance(const std::string& source, const std::string& target) {
+    int n = (int)source.length();
+    int m = (int)target.length();
+    if (n == 0) return m;
+    if (m == 0) return n;
+    std::vector< std::vector<int> > matrix(n + 1, std::vector<int>(m + 1));
+    for (int i = 0; i <= n; i++) matrix[i][0] = i;
+    for (int j = 0; j <= m; j++) matrix[0][j] = j;
+    for (int i = 1; i <= n; i++) {
+        for (int j = 1; j <= m; j++) {
+            int cost = (source[i-1] == target[j-1]) ? 0 : 1;
+            int cell = std::min(matrix[i-1][j] + 1, std::min(matrix[i][j-1] + 1, matrix[i-1][j-1] + cost));
+            if (i > 2 && j > 2) {
+                int trans = matrix[i-2][j-2] + 1;
+                if (source[i-2] != target[j-1]) trans++;
+                if (source[i-1] != target[j-2]) trans++;
+                if (cell > trans) cell = trans;
+            }
+            matrix[i][j] = cell;
+        }
+    }
+    return matrix[n][m];
+}
+
+TEST_CASE("bounded edit distance agrees with the full matrix", "[patternmatcher]") {
+    srand(13);
+    for (int round = 0; round < 300; round++) {
+        // mostly similar pairs so that the band matters
+        std::string a = randomSeq(rand() % 50);
+        std::string b = a;
+        int edits = rand() % 12;
+        for (int e = 0; e < edits && ! b.empty(); e++) {
+            size_t pos = rand() % b.size();
+            switch (rand() % 4) {
+                case 0: b[pos] = "ACGT"[rand() % 4]; break;
+                case 1: b.erase(pos, 1); break;
+                case 2: b.insert(pos, 1, "ACGT"[rand() % 4]); break;
+                default: if (pos + 1 < b.size()) std::swap(b[pos], b[pos + 1]); break;
+            }
+        }
+        if (round % 5 == 0) {
+            b = randomSeq(rand() % 50);
+        }
+        int expected = matrixEditDistance(a, b);
+        REQUIRE(PatternMatcher::levenstheinDistance(a, b) == expected);
+        for (int max_distance = 0; max_distance <= 55; max_distance++) {
+            int bounded = PatternMatcher::boundedEditDistance(a.data(), a.size(), b.data(), b.size(), max_distance);
+            REQUIRE(bounded == std::min(expected, max_distance + 1));
+        }
+
+        float exact = PatternMatcher::getStringSimilarity(a, b);
+        float thresholds[] = {0.0f, 0.5f, 0.82f, 0.95f};
+        for (int t = 0; t < 4; t++) {
+            float bounded = PatternMatcher::getStringSimilarity(a, b, thresholds[t]);
+            if (exact > thresholds[t]) {
+                REQUIRE(bounded == exact);
+            } else {
+                REQUIRE(bounded <= thresholds[t]);
+                REQUIRE(bounded >= exact);
+            }
+        }
+    }
+    SECTION("strings longer than the stack rows") {
+        std::string a = randomSeq(400);
+        std::string b = a.substr(3) + "ACG";
+        REQUIRE(PatternMatcher::levenstheinDistance(a, b) == matrixEditDistance(a, b));
+        REQUIRE(PatternMatcher::boundedEditDistance(a.data(), a.size(), b.data(), b.size(), 4) == 5);
+    }
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("exact search against Boyer-Moore on short reads", "[.][benchmark]") {
+    srand(11);
+    unsigned int read_lengths[] = {100, 150, 250};
+    unsigned int window = 8;
+    std::cout<<std::endl<<"exact search kernel: "<<PatternMatcher::exactSearchKernel()<<std::endl;
+    for (int l = 0; l < 3; l++) {
+        std::vector<std::string> reads;
+        for (int i = 0; i < 2000; i++) {
+            reads.push_back(randomSeq(read_lengths[l]));
+        }
+        // look for every window further along the read, like searchCore does
+        long bmp_hits = 0, exact_hits = 0;
+        struct timeval before;
+        gettimeofday(&before, NULL);
+        for (int rounds = 0; rounds < 10; rounds++) {
+            for (size_t i = 0; i < reads.size(); i++) {
+                const char * read = reads[i].data();
+                for (unsigned int j = 0; j + 2 * window < read_lengths[l]; j++) {
+                    bmp_hits += PatternMatcher::bmpSearch(read + j + window, read_lengths[l] - j - window, read + j, window) >= 0;
+                }
+            }
+        }
+        double bmp_secs = secondsSince(before);
+        gettimeofday(&before, NULL);
+        for (int rounds = 0; rounds < 10; rounds++) {
+            for (size_t i = 0; i < reads.size(); i++) {
+                const char * read = reads[i].data();
+                for (unsigned int j = 0; j + 2 * window < read_lengths[l]; j++) {
+                    exact_hits += PatternMatcher::exactSearch(read + j + window, read_lengths[l] - j - window, read + j, window) >= 0;
+                }
+            }
+        }
+        double exact_secs = secondsSince(before);
+        REQUIRE(bmp_hits == exact_hits);
+        std::cout<<read_lengths[l]<<"bp reads: Boyer-Moore "<<bmp_secs<<" sec, exact search "<<exact_secs<<" sec"<<std::endl;
+    }
+}
@@ -0,0 +1,407 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "ReadHolder.h"
+#include "ReadStore.h"
+#include "Exception.h"
+#include "ThreadPool.h"
+
+static void requireSameRead(ReadHolder& lhs, ReadHolder& rhs) {
+    REQUIRE(lhs.getSeq() == rhs.getSeq());
+    REQUIRE(lhs.getHeader() == rhs.getHeader());
+    REQUIRE(lhs.getComment() == rhs.getComment());
+    REQUIRE(lhs.getStartStopList() == rhs.getStartStopList());
+    REQUIRE(lhs.getIsFasta() == rhs.getIsFasta());
+    REQUIRE(lhs.getRepeatLength() == rhs.getRepeatLength());
+}
+
+TEST_CASE("reads come back out of the store the way they went in", "[readstore]") {
+    ReadStore store;
+
+    // every length up to a few whole bytes so the odd bases get packed too
+    std::vector<ReadHolder> reads;
+    for (int length = 0; length < 13; length++) {
+        char header[32];
+        sprintf(header, "read_%d", length);
+        ReadHolder read(randomSeq(length), header);
+        reads.push_back(read);
+    }
+    ReadHolder odd("ACGTNNacgtRYACGT", "odd_bases", "a comment", "");
+    odd.startStopsAdd(2, 5);
+    odd.startStopsAdd(9, 12);
+    odd.setRepeatLength(4);
+    reads.push_back(odd);
+
+    std::vector<ReadIndex> indexes;
+    for (size_t i = 0; i < reads.size(); i++) {
+        indexes.push_back(store.add(reads[i]));
+    }
+    REQUIRE(store.size() == reads.size());
+
+    ReadHolder out;
+    for (size_t i = 0; i < reads.size(); i++) {
+        store.get(indexes[i], out);
+        requireSameRead(reads[i], out);
+        REQUIRE(store.getHeader(indexes[i]) == reads[i].getHeader());
+    }
+}
+
+TEST_CASE("start stops past 65535 are kept", "[readstore]") {
+    ReadStore store;
+    ReadHolder read(randomSeq(70000), "long_read");
+    read.startStopsAdd(10, 40);
+    read.startStopsAdd(69000, 69030);
+    ReadIndex index = store.add(read);
+
+    ReadHolder out;
+    store.get(index, out);
+    requireSameRead(read, out);
+}
+
+TEST_CASE("updated reads replace the stored copy", "[readstore]") {
+    ReadStore store;
+    ReadHolder first(randomSeq(100), "first");
+    first.startStopsAdd(10, 40);
+    ReadHolder second(randomSeq(100), "second");
+    second.startStopsAdd(20, 50);
+    ReadIndex first_index = store.add(first);
+    ReadIndex second_index = store.add(second);
+
+    // the same size, written over the old one
+    ReadHolder out;
+    store.get(first_index, out);
+    out.reverseComplementSeq();
+    ReadHolder expected(out);
+    size_t before = store.memoryUsage();
+    store.update(first_index, out);
+    REQUIRE(store.memoryUsage() == before);
+    store.get(first_index, out);
+    requireSameRead(expected, out);
+
+    // bigger, so it has to move
+    out.startStopsAdd(70, 90);
+    out.setSequence(out.getSeq() + "NNNN");
+    expected = out;
+    store.update(first_index, out);
+    store.get(first_index, out);
+    requireSameRead(expected, out);
+
+    // the neighbour is left alone
+    store.get(second_index, out);
+    requireSameRead(second, out);
+}
+
+// each part reverse complements its own reads, every fourth one also
+// grows so it has to move, and reads the others as it goes
+typedef struct {
+    ReadStore * store;
+    std::vector<ReadIndex> * indices;
+    size_t part;
+    size_t numParts;
+    bool mangled;
+} UpdateTask;
+
+static void updateTask(void * arg) {
+    UpdateTask * task = static_cast<UpdateTask *>(arg);
+    ReadHolder read;
+    ReadHolder other;
+    task->mangled = false;
+    for (size_t i = task->part; i < task->indices->size(); i += task->numParts) {
+        (task->store)->get((*task->indices)[i], read);
+        read.reverseComplementSeq();
+        if (i % 4 == 0) {
+            read.startStopsAdd(170, 190);
+            read.setSequence(read.getSeq() + "NNNN");
+        }
+        (task->store)->update((*task->indices)[i], read);
+        (task->store)->get((*task->indices)[(i + 1) % task->indices->size()], other);
+        if (other.getSeqLength() < 200) {
+            task->mangled = true;
+        }
+    }
+}
+
+TEST_CASE("reads can be updated from several threads at once", "[readstore]") {
+    ReadStore store;
+    std::vector<ReadHolder> expected;
+    std::vector<ReadIndex> indices;
+    for (int i = 0; i < 20000; i++) {
+        ReadHolder read(randomSeq(200), "read");
+        read.startStopsAdd(10, 40);
+        read.setRepeatLength(30);
+        indices.push_back(store.add(read));
+        read.reverseComplementSeq();
+        if (i % 4 == 0) {
+            read.startStopsAdd(170, 190);
+            read.setSequence(read.getSeq() + "NNNN");
+        }
+        expected.push_back(read);
+    }
+
+    std::vector<UpdateTask> tasks(4);
+    {
+        ThreadPool pool(4);
+        for (size_t i = 0; i < tasks.size(); i++) {
+            tasks[i].store = &store;
+            tasks[i].indices = &indices;
+            tasks[i].part = i;
+            tasks[i].numParts = tasks.size();
+            pool.submit(updateTask, &tasks[i]);
+        }
+        pool.waitAll();
+    }
+    for (size_t i = 0; i < tasks.size(); i++) {
+        REQUIRE_FALSE(tasks[i].mangled);
+    }
+    ReadHolder out;
+    for (size_t i = 0; i < indices.size(); i++) {
+        store.get(indices[i], out);
+        requireSameRead(expected[i], out);
+    }
+}
+
+TEST_CASE("reads can be copied between stores", "[readstore]") {
+    ReadStore local;
+    ReadStore global;
+    ReadHolder filler(randomSeq(50), "filler");
+    global.add(filler);
+
+    ReadHolder read("ACGTTGCANACGT", "copied");
+    read.startStopsAdd(1, 4);
+    ReadIndex local_index = local.add(read);
+    ReadIndex global_index = global.add(local, local_index);
+    local.clear();
+    REQUIRE(local.size() == 0);
+
+    ReadHolder out;
+    global.get(global_index, out);
+    requireSameRead(read, out);
+}
+
+// a read the way the search leaves it, with a 30 base repeat at start
+static ReadHolder foundRead(const std::string& seq, const char * header, unsigned int start) {
+    ReadHolder read(seq, header);
+    read.startStopsAdd(start, start + 29);
+    read.setRepeatLength(30);
+    read.setDRLowLexi(true);
+    return read;
+}
+
+TEST_CASE("copies of a read are folded into the first one", "[readstore]") {
+    ReadStore store;
+    ReadHolder before = foundRead(randomSeq(40), "before", 0);
+    store.add(before);
+    store.setDeduplicate(true);
+
+    std::string seq = randomSeq(60) + "N" + randomSeq(20);
+    ReadHolder read = foundRead(seq, "first", 5);
+    bool duplicate = true;
+    ReadIndex index = store.add(read, &duplicate);
+    REQUIRE_FALSE(duplicate);
+
+    ReadHolder copy = foundRead(seq, "second", 5);
+    REQUIRE(store.add(copy, &duplicate) == index);
+    REQUIRE(duplicate);
+    // reads stored before dedup was turned on are found too
+    ReadHolder again = foundRead(before.getSeq(), "again", 0);
+    REQUIRE(store.add(again, &duplicate) == 0);
+    REQUIRE(duplicate);
+
+    // the same bases with the repeat somewhere else are a different read
+    ReadHolder moved = foundRead(seq, "moved", 6);
+    REQUIRE(store.add(moved, &duplicate) != index);
+    REQUIRE_FALSE(duplicate);
+    REQUIRE(store.size() == 3);
+
+    // copies from another store bring their own copies with them
+    ReadStore local;
+    ReadHolder third = foundRead(seq, "third", 5);
+    ReadIndex local_index = local.add(third);
+    ReadHolder fourth = foundRead(seq, "fourth", 5);
+    local.setDeduplicate(true);
+    REQUIRE(local.add(fourth) == local_index);
+    REQUIRE(store.add(local, local_index, &duplicate) == index);
+    REQUIRE(duplicate);
+
+    REQUIRE(store.multiplicity(index) == 4);
+    REQUIRE(store.multiplicity(0) == 2);
+    REQUIRE(store.numDuplicates() == 4);
+    std::vector<std::string> headers;
+    store.getDuplicateHeaders(index, headers);
+    REQUIRE(headers.size() == 3);
+    REQUIRE(headers[0] == "second");
+    REQUIRE(headers[1] == "third");
+    REQUIRE(headers[2] == "fourth");
+
+    ReadHolder out;
+    store.get(index, out);
+    requireSameRead(read, out);
+
+    // reads cannot be changed while they can still be looked up
+    REQUIRE_THROWS_AS(store.update(index, out), crispr::exception&);
+    store.setDeduplicate(false);
+    out.reverseComplementSeq();
+    store.update(index, out);
+    REQUIRE(store.multiplicity(index) == 4);
+    REQUIRE(store.add(copy, &duplicate) != index);
+    REQUIRE_FALSE(duplicate);
+}
+
+TEST_CASE("squeezed reads are refused", "[readstore]") {
+    ReadStore store;
+    ReadHolder read("AAAACCCGT", "squeezed");
+    read.encode();
+    REQUIRE_THROWS_AS(store.add(read), crispr::exception&);
+}
+
+TEST_CASE("reads over the memory limit are spilled and read back", "[readstore]") {
+    ReadStore store;
+    store.setMemoryLimit(1 << 18, "test_readstore.spill");
+    // the spill file is gone as soon as it is opened
+    REQUIRE(access("test_readstore.spill", F_OK) != 0);
+
+    std::vector<ReadHolder> reads;
+    std::vector<ReadIndex> indexes;
+    for (int i = 0; i < 20000; i++) {
+        char header[32];
+        sprintf(header, "spilled_%d", i);
+        ReadHolder read(randomSeq(150) + "N", header);
+        read.startStopsAdd(10, 39);
+        reads.push_back(read);
+        indexes.push_back(store.add(read));
+    }
+    REQUIRE(store.spilledBytes() > 0);
+    // the records saying where each read is stay in memory
+    REQUIRE(store.memoryUsage() < (1 << 18) + reads.size() * 100);
+
+    ReadHolder out;
+    for (size_t i = 0; i < reads.size(); i++) {
+        store.get(indexes[i], out);
+        requireSameRead(reads[i], out);
+    }
+
+    // updating a read that is out on disk
+    store.get(indexes[0], out);
+    out.reverseComplementSeq();
+    ReadHolder expected(out);
+    store.update(indexes[0], out);
+    store.get(indexes[0], out);
+    requireSameRead(expected, out);
+
+    store.clear();
+    REQUIRE(store.spilledBytes() == 0);
+    ReadIndex index = store.add(reads[1]);
+    store.get(index, out);
+    requireSameRead(reads[1], out);
+}
+
+// how many regions are mapped into the process
+static int mappedRegions(void) {
+    int regions = 0;
+    FILE * maps = fopen("/proc/self/maps", "r");
+    if (maps != NULL) {
+        int c;
+        while ((c = fgetc(maps)) != EOF) {
+            if (c == '\n') {
+                regions++;
+            }
+        }
+        fclose(maps);
+    }
+    return regions;
+}
+
+TEST_CASE("a big spill does not take a mapping for every block", "[readstore]") {
+    ReadStore store;
+    // small enough that every block is as small as they get
+    store.setMemoryLimit(1 << 16, "test_readstore.spill");
+
+    int before = mappedRegions();
+    std::vector<ReadIndex> indexes;
+    for (int i = 0; i < 300000; i++) {
+        char header[32];
+        sprintf(header, "spilled_%d", i);
+        ReadHolder read(randomSeq(150), header);
+        indexes.push_back(store.add(read));
+    }
+    // a few hundred blocks are out on disk
+    REQUIRE(store.spilledBytes() > 200 * (1 << 16));
+    REQUIRE(mappedRegions() - before < 20);
+
+    ReadHolder out;
+    store.get(indexes.front(), out);
+    REQUIRE(out.getHeader() == "spilled_0");
+    store.get(indexes.back(), out);
+    REQUIRE(out.getHeader() == "spilled_299999");
+}
+
+// resident memory, in bytes
+static size_t residentBytes(void) {
+    long pages = 0, resident = 0;
+    FILE * statm = fopen("/proc/self/statm", "r");
+    if (statm != NULL) {
+        if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(statm);
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("memory used by 1M reads", "[.][benchmark]") {
+    const int num_reads = 1000000;
+    std::vector<ReadHolder> source;
+    source.reserve(1000);
+    for (int i = 0; i < 1000; i++) {
+        char header[64];
+        sprintf(header, "HWI-ST1234:8:%d:%d:%d#0/1", 1101 + i % 64, (i * 7919) % 20000, i);
+        ReadHolder read(randomSeq(150), header);
+        read.startStopsAdd(10, 39);
+        read.startStopsAdd(76, 105);
+        source.push_back(read);
+    }
+
+    // the store goes first, its blocks are handed back to the system 
+    // when it is cleared so the holders start from the same place
+    std::vector<ReadIndex> indexes;
+    indexes.reserve(num_reads);
+    std::vector<ReadHolder *> holders;
+    holders.reserve(num_reads);
+    ReadStore store;
+    size_t before = residentBytes();
+    struct timeval start;
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < num_reads; i++) {
+        indexes.push_back(store.add(source[i % 1000]));
+    }
+    double add_secs = secondsSince(start);
+    size_t store_bytes = residentBytes() - before;
+
+    ReadHolder out;
+    gettimeofday(&start, NULL);
+    for (int i = 0; i < num_reads; i++) {
+        store.get(indexes[i], out);
+    }
+    double get_secs = secondsSince(start);
+    REQUIRE(store.memoryUsage() <= store_bytes + (1 << 22));
+    store.clear();
+
+    before = residentBytes();
+    for (int i = 0; i < num_reads; i++) {
+        holders.push_back(new ReadHolder(source[i % 1000]));
+    }
+    size_t holder_bytes = residentBytes() - before;
+    for (int i = 0; i < num_reads; i++) {
+        delete holders[i];
+    }
+
+    std::cout<<std::endl<<num_reads<<" reads of 150bp: ReadHolder* "<<holder_bytes / (1024 * 1024)<<" MB, ReadStore "
+             <<store_bytes / (1024 * 1024)<<" MB (add "<<add_secs<<" sec, get "<<get_secs<<" sec)"<<std::endl;
+}
@@ -0,0 +1,105 @@
+#include <string>
+#include <cstdlib>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "RepeatSeeder.h"
+#include "PatternMatcher.h"
+
+static void compareWithBmpSearch(const std::string& read, unsigned int kmerLength, RepeatSeeder& seeder) {
+    seeder.index(read.data(), static_cast<unsigned int>(read.size()), kmerLength);
+    for (unsigned int j = 0; j + kmerLength <= read.size(); j++) {
+        for (unsigned int begin = j + 1; begin < read.size(); begin += 7) {
+            for (unsigned int end = begin; end <= read.size(); end += 5) {
+                int expected = PatternMatcher::bmpSearch(read.data() + begin, end - begin, read.data() + j, kmerLength);
+                REQUIRE(seeder.firstRepeat(j, begin, end) == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("seeds match the Boyer-Moore search", "[repeatseeder]") {
+    RepeatSeeder seeder;
+    srand(42);
+    SECTION("on a read with a repeat in it") {
+        std::string read = "CATCGACTGTTTCAATCCACGCGCCCACGCGGGGCGCGACACGATCGATTTAGCGGCATCAGCTGTTTCAATCCACGCGCCCACGCGGGGCGCGACAGCATC";
+        for (unsigned int k = 6; k <= 9; k++) {
+            compareWithBmpSearch(read, k, seeder);
+        }
+    }
+    SECTION("on low complexity reads") {
+        compareWithBmpSearch(std::string(80, 'A'), 8, seeder);
+        compareWithBmpSearch(randomSeq(80, "AC", 2), 6, seeder);
+    }
+    SECTION("on reads with bases that are not ACGT") {
+        for (int i = 0; i < 5; i++) {
+            compareWithBmpSearch(randomSeq(90, "ACGTNacgt", 9), 6, seeder);
+            compareWithBmpSearch(randomSeq(90, "ACNNN", 5), 7, seeder);
+        }
+    }
+    SECTION("when a read is shorter than the kmer") {
+        seeder.index("ACGT", 4, 8);
+        REQUIRE(seeder.firstRepeat(0, 1, 4) == -1);
+    }
+}
+
+// mirrors the window loop in searchCore
+static bool anyWindowRepeats(const std::string& read, unsigned int kmerLength, unsigned int step, 
+                             unsigned int lastWindow, unsigned int minGap, unsigned int maxGap, RepeatSeeder& seeder) {
+    unsigned int length = static_cast<unsigned int>(read.size());
+    seeder.index(read.data(), length, kmerLength);
+    for (unsigned int j = 0; j <= lastWindow; j += step) {
+        unsigned int begin = j + minGap;
+        unsigned int end = j + maxGap + kmerLength;
+        if (end >= length) {
+            end = length - 1;
+        }
+        if (end < begin) {
+            end = begin;
+        }
+        if (seeder.firstRepeat(j, begin, end) >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int checkPrefilter(const std::string& read, unsigned int kmerLength, unsigned int step, 
+                          unsigned int minGap, unsigned int maxGap, RepeatSeeder& seeder) {
+    unsigned int length = static_cast<unsigned int>(read.size());
+    unsigned int last_window = length - minGap - kmerLength - 1;
+    bool may_repeat = seeder.mayRepeat(read.data(), length, kmerLength, step, last_window, minGap, maxGap);
+    if (! may_repeat) {
+        REQUIRE_FALSE(anyWindowRepeats(read, kmerLength, step, last_window, minGap, maxGap, seeder));
+    }
+    return may_repeat ? 0 : 1;
+}
+
+TEST_CASE("the prefilter never throws out a read the seeds would find", "[repeatseeder]") {
+    RepeatSeeder seeder;
+    srand(7);
+    SECTION("on a read with a repeat in it") {
+        std::string read = "CATCGACTGTTTCAATCCACGCGCCCACGCGGGGCGCGACACGATCGATTTAGCGGCATCAGCTGTTTCAATCCACGCGCCCACGCGGGGCGCGACAGCATC";
+        REQUIRE(seeder.mayRepeat(read.data(), static_cast<unsigned int>(read.size()), 8, 8, 40, 49, 122));
+        REQUIRE(anyWindowRepeats(read, 8, 8, 40, 49, 122, seeder));
+    }
+    SECTION("on random reads") {
+        int rejected = 0;
+        for (int i = 0; i < 2000; i++) {
+            rejected += checkPrefilter(randomSeq(100 + rand() % 150), 6 + rand() % 4, 1 + rand() % 8, 30 + rand() % 30, 90 + rand() % 40, seeder);
+        }
+        // most random reads have nothing in them
+        REQUIRE(rejected > 1000);
+    }
+    SECTION("on low complexity reads") {
+        for (int i = 0; i < 500; i++) {
+            checkPrefilter(randomSeq(150, "AC", 2), 6 + rand() % 4, 1 + rand() % 8, 30 + rand() % 30, 90 + rand() % 40, seeder);
+            checkPrefilter(randomSeq(150, "ACGG", 4), 6 + rand() % 4, 1 + rand() % 8, 30 + rand() % 30, 90 + rand() % 40, seeder);
+        }
+    }
+    SECTION("on reads with bases that are not ACGT") {
+        for (int i = 0; i < 500; i++) {
+            checkPrefilter(randomSeq(150, "ACGTACGTACGTACGTNacgt", 21), 6 + rand() % 4, 1 + rand() % 8, 30 + rand() % 30, 90 + rand() % 40, seeder);
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <new>
+#include <zlib.h>
+
+#include "catch.hpp"
+#include "libcrispr.h"
+#include "LoggerSimp.h"
+#include "ReadHolder.h"
+#include "RepeatSeeder.h"
+#include "ReadStore.h"
+#include "StringCheck.h"
+#include "kseq.h"
+
+#ifndef CRASS_TEST_DATA_DIR
+#define CRASS_TEST_DATA_DIR "../../test"
+#endif
+
+#if __cplusplus >= 201103L
+#define CRASS_TEST_NEW_THROW
+#else
+#define CRASS_TEST_NEW_THROW throw(std::bad_alloc)
+#endif
+
+// every allocation made by the test binary goes through here so 
+// that the benchmark below can count them
+static long allocation_count = 0;
+
+void * operator new(size_t size) CRASS_TEST_NEW_THROW {
+    __sync_fetch_and_add(&allocation_count, 1);
+    void * p = malloc(size ? size : 1);
+    if (p == NULL) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void * p) throw() {
+    free(p);
+}
+
+typedef struct {
+    std::string seq;
+    std::string name;
+} BenchmarkRecord;
+
+static void loadRecords(const char * fileName, std::vector<BenchmarkRecord>& records) {
+    gzFile fp = gzopen(fileName, "r");
+    REQUIRE(fp != NULL);
+    kseq_t * seq = kseq_init(fp);
+    while (kseq_read(seq) >= 0) {
+        BenchmarkRecord record;
+        record.seq = seq->seq.s;
+        record.name = seq->name.s;
+        records.push_back(record);
+    }
+    kseq_destroy(seq);
+    gzclose(fp);
+}
+
+static void setAllocationOptions(options& opts) {
+    static bool logger_ready = false;
+    if (! logger_ready) {
+        intialiseGlobalLogger("", 0);
+        logger_ready = true;
+    }
+    opts.logLevel = 0;
+    opts.lowDRsize = CRASS_DEF_MIN_DR_SIZE;
+    opts.highDRsize = CRASS_DEF_MAX_DR_SIZE;
+    opts.lowSpacerSize = CRASS_DEF_MIN_SPACER_SIZE;
+    opts.highSpacerSize = CRASS_DEF_MAX_SPACER_SIZE;
+    opts.searchWindowLength = CRASS_DEF_OPTIMAL_SEARCH_WINDOW_LENGTH;
+    opts.minNumRepeats = CRASS_DEF_DEFAULT_MIN_NUM_REPEATS;
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("allocations made per read by the search", "[.][benchmark]") {
+    std::vector<BenchmarkRecord> records;
+    loadRecords(CRASS_TEST_DATA_DIR "/CN_gDC.fa.gz", records);
+    options opts;
+    setAllocationOptions(opts);
+
+    // a fresh holder for every read
+    RepeatSeeder fresh_seeder;
+    long before = allocation_count;
+    int fresh_hits = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+        ReadHolder tmp_holder;
+        tmp_holder.setSequence(records[i].seq.c_str());
+        tmp_holder.setHeader(records[i].name.c_str());
+        fresh_hits += searchCore(tmp_holder, opts, fresh_seeder);
+    }
+    long fresh_allocations = allocation_count - before;
+
+    // one holder and seeder reused for every read, as searchFile does
+    before = allocation_count;
+    int reused_hits = 0;
+    ReadHolder tmp_holder;
+    RepeatSeeder seeder;
+    for (size_t i = 0; i < records.size(); i++) {
+        tmp_holder.reuse();
+        tmp_holder.setSequence(records[i].seq.c_str());
+        tmp_holder.setHeader(records[i].name.c_str());
+        reused_hits += searchCore(tmp_holder, opts, seeder);
+    }
+    long reused_allocations = allocation_count - before;
+
+    REQUIRE(fresh_hits == reused_hits);
+    std::cout<<std::endl<<"reads: "<<records.size()<<" hits: "<<fresh_hits<<std::endl;
+    std::cout<<"new holder per read: "<<(double)fresh_allocations / records.size()<<" allocations/read"<<std::endl;
+    std::cout<<"reused holder:       "<<(double)reused_allocations / records.size()<<" allocations/read"<<std::endl;
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("allocations made per recruited read", "[.][benchmark]") {
+    std::vector<BenchmarkRecord> records;
+    loadRecords(CRASS_TEST_DATA_DIR "/CN_gDC.fa.gz", records);
+    options opts;
+    setAllocationOptions(opts);
+
+    ReadMap reads;
+    ReadStore store;
+    StringCheck string_check;
+    ReadHolder tmp_holder;
+    RepeatSeeder seeder;
+    long recruit_allocations = 0;
+    int recruited = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+        tmp_holder.reuse();
+        tmp_holder.setSequence(records[i].seq.c_str());
+        tmp_holder.setHeader(records[i].name.c_str());
+        if (searchCore(tmp_holder, opts, seeder)) {
+            long before = allocation_count;
+            addReadHolder(&reads, &store, &string_check, tmp_holder);
+            recruit_allocations += allocation_count - before;
+            recruited++;
+        }
+    }
+    REQUIRE(recruited > 0);
+    REQUIRE(store.size() == static_cast<size_t>(recruited));
+    std::cout<<std::endl<<"recruited: "<<recruited<<" "<<(double)recruit_allocations / recruited<<" allocations/read"<<std::endl;
+
+    ReadMapIterator map_iter;
+    for (map_iter = reads.begin(); map_iter != reads.end(); ++map_iter) {
+        delete map_iter->second;
+    }
+}
@@ -0,0 +1,236 @@
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <sys/time.h>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "libcrispr.h"
+#include "LoggerSimp.h"
+#include "ReadHolder.h"
+#include "ReadStore.h"
+#include "StringCheck.h"
+#include "ThreadPool.h"
+
+#ifndef CRASS_TEST_DATA_DIR
+#define CRASS_TEST_DATA_DIR "../../test"
+#endif
+
+static void setSearchOptions(options& opts, unsigned int threads) {
+    static bool logger_ready = false;
+    if (! logger_ready) {
+        intialiseGlobalLogger("", 0);
+        logger_ready = true;
+    }
+    opts.logLevel = 0;
+    opts.lowDRsize = CRASS_DEF_MIN_DR_SIZE;
+    opts.highDRsize = CRASS_DEF_MAX_DR_SIZE;
+    opts.lowSpacerSize = CRASS_DEF_MIN_SPACER_SIZE;
+    opts.highSpacerSize = CRASS_DEF_MAX_SPACER_SIZE;
+    opts.kmer_clust_size = CRASS_DEF_K_CLUST_MIN;
+    opts.searchWindowLength = CRASS_DEF_OPTIMAL_SEARCH_WINDOW_LENGTH;
+    opts.minNumRepeats = CRASS_DEF_DEFAULT_MIN_NUM_REPEATS;
+    opts.covCutoff = CRASS_DEF_COVCUTOFF;
+    opts.numThreads = threads;
+}
+
+static void clearReadMap(ReadMap& reads) {
+    ReadMapIterator map_iter;
+    for (map_iter = reads.begin(); map_iter != reads.end(); ++map_iter) {
+        delete map_iter->second;
+    }
+    reads.clear();
+}
+
+static void compareReadMaps(ReadMap& lhs, ReadStore& lhsStore, ReadMap& rhs, ReadStore& rhsStore) {
+    REQUIRE(lhs.size() == rhs.size());
+    ReadMapIterator lhs_iter = lhs.begin();
+    ReadMapIterator rhs_iter = rhs.begin();
+    for ( ; lhs_iter != lhs.end(); ++lhs_iter, ++rhs_iter) {
+        // tokens are handed out in read order so they must match up too
+        REQUIRE(lhs_iter->first == rhs_iter->first);
+        REQUIRE(lhs_iter->second->size() == rhs_iter->second->size());
+        for (size_t i = 0; i < lhs_iter->second->size(); i++) {
+            ReadHolder lhs_read, rhs_read;
+            lhsStore.get(lhs_iter->second->at(i), lhs_read);
+            rhsStore.get(rhs_iter->second->at(i), rhs_read);
+            REQUIRE(lhs_read.getHeader() == rhs_read.getHeader());
+            REQUIRE(lhs_read.getStartStopList() == rhs_read.getStartStopList());
+        }
+    }
+}
+
+TEST_CASE("threaded search gives the same result as the serial search", "[libcrispr]") {
+    std::string input = std::string(CRASS_TEST_DATA_DIR) + "/CN_gDC.fa.gz";
+    time_t start;
+    time(&start);
+
+    options serial_opts;
+    setSearchOptions(serial_opts, 1);
+    ReadMap serial_reads;
+    ReadStore serial_store;
+    StringCheck serial_check;
+    lookupTable serial_patterns;
+    HeaderSet serial_found;
+    searchFile(input.c_str(), serial_opts, &serial_reads, &serial_store, &serial_check, serial_patterns, serial_found, start);
+
+    options threaded_opts;
+    setSearchOptions(threaded_opts, 4);
+    ReadMap threaded_reads;
+    ReadStore threaded_store;
+    StringCheck threaded_check;
+    lookupTable threaded_patterns;
+    HeaderSet threaded_found;
+    searchFile(input.c_str(), threaded_opts, &threaded_reads, &threaded_store, &threaded_check, threaded_patterns, threaded_found, start);
+
+    REQUIRE(serial_reads.size() > 0);
+    REQUIRE(serial_reads.size() == threaded_reads.size());
+    REQUIRE(serial_patterns == threaded_patterns);
+    REQUIRE(serial_found == threaded_found);
+
+    compareReadMaps(serial_reads, serial_store, threaded_reads, threaded_store);
+    clearReadMap(serial_reads);
+    clearReadMap(threaded_reads);
+}
+
+TEST_CASE("threaded singleton scan gives the same result as the serial scan", "[libcrispr]") {
+    std::string input = std::string(CRASS_TEST_DATA_DIR) + "/Ill100.fx.gz";
+    time_t start;
+    time(&start);
+
+    options opts;
+    setSearchOptions(opts, 1);
+    ReadMap found_reads;
+    ReadStore found_store;
+    StringCheck found_check;
+    lookupTable patterns;
+    HeaderSet found;
+    searchFile(input.c_str(), opts, &found_reads, &found_store, &found_check, patterns, found, start);
+    clearReadMap(found_reads);
+
+    std::vector<std::string> non_redundant;
+    lookupTable::iterator pattern_iter;
+    for (pattern_iter = patterns.begin(); pattern_iter != patterns.end(); ++pattern_iter) {
+        non_redundant.push_back(pattern_iter->first);
+    }
+    REQUIRE(non_redundant.size() > 0);
+
+    ReadMap serial_reads;
+    ReadStore serial_store;
+    StringCheck serial_check;
+    findSingletons(input.c_str(), opts, &non_redundant, found, &serial_reads, &serial_store, &serial_check, start);
+
+    options threaded_opts;
+    setSearchOptions(threaded_opts, 4);
+    ReadMap threaded_reads;
+    ReadStore threaded_store;
+    StringCheck threaded_check;
+    findSingletons(input.c_str(), threaded_opts, &non_redundant, found, &threaded_reads, &threaded_store, &threaded_check, start);
+
+    REQUIRE(serial_reads.size() > 0);
+    compareReadMaps(serial_reads, serial_store, threaded_reads, threaded_store);
+    clearReadMap(serial_reads);
+    clearReadMap(threaded_reads);
+}
+
+static int loggedNumber(int i) {
+    logInfo("inner " << i, 0);
+    return i;
+}
+
+static void logTask(void * arg) {
+    int first = *static_cast<int *>(arg);
+    for (int i = first; i < first + 100; i++) {
+        // the message logs one of its own while the logger is held
+        logInfo("outer " << loggedNumber(i), 0);
+    }
+}
+
+// true if the line is one whole message from logTask, and ticks it off
+static bool wholeMessage(const std::string& line, std::vector<int>& outers, std::vector<int>& inners) {
+    size_t prefix = line.find("\tI   ");
+    if (prefix == std::string::npos) {
+        return false;
+    }
+    std::string message = line.substr(prefix + 5);
+    char kind[8];
+    int number;
+    if (sscanf(message.c_str(), "%7s %d", kind, &number) != 2 || number < 0 || number >= 400) {
+        return false;
+    }
+    std::stringstream expected;
+    expected << kind << " " << number;
+    if (expected.str() != message) {
+        return false;
+    }
+    if (std::string(kind) == "outer") {
+        outers[number]++;
+    } else if (std::string(kind) == "inner") {
+        inners[number]++;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+TEST_CASE("the logger can be used from several threads at once", "[logger]") {
+    options opts;
+    setSearchOptions(opts, 4);
+    std::iostream * log_handle = logger->mGlobalHandle;
+    std::stringstream captured;
+    logger->mGlobalHandle = &captured;
+    int firsts[4] = {0, 100, 200, 300};
+    {
+        ThreadPool pool(4);
+        for (int i = 0; i < 4; i++) {
+            pool.submit(logTask, &firsts[i]);
+        }
+        pool.waitAll();
+    }
+    logger->mGlobalHandle = log_handle;
+    // no message is written into the middle of another
+    std::vector<int> outers(400, 0);
+    std::vector<int> inners(400, 0);
+    std::string line;
+    int lines = 0;
+    while (std::getline(captured, line)) {
+        INFO(line);
+        REQUIRE(wholeMessage(line, outers, inners));
+        lines++;
+    }
+    REQUIRE(lines == 800);
+    REQUIRE(std::count(outers.begin(), outers.end(), 1) == 400);
+    REQUIRE(std::count(inners.begin(), inners.end(), 1) == 400);
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("search throughput at different thread counts", "[.][benchmark]") {
+    std::string input = std::string(CRASS_TEST_DATA_DIR) + "/CN_gDC.fa.gz";
+    unsigned int thread_counts[] = {1, 2, 4, 8};
+    for (int t = 0; t < 4; t++) {
+        options opts;
+        setSearchOptions(opts, thread_counts[t]);
+        ReadMap reads;
+        ReadStore store;
+        StringCheck string_check;
+        lookupTable patterns;
+        HeaderSet found;
+        time_t start;
+        time(&start);
+
+        struct timeval before;
+        gettimeofday(&before, NULL);
+        int rounds = 5;
+        for (int i = 0; i < rounds; i++) {
+            searchFile(input.c_str(), opts, &reads, &store, &string_check, patterns, found, start);
+        }
+        double secs = secondsSince(before);
+        // CN_gDC.fa.gz holds 4740 reads
+        std::cout<<std::endl<<"threads: "<<thread_counts[t]<<" reads/sec: "<<(4740 * rounds) / secs<<std::endl;
+        clearReadMap(reads);
+        store.clear();
+    }
+}
@@ -0,0 +1,61 @@
+#include <string>
+#include <fstream>
+
+#include "catch.hpp"
+#include "SingletonSpill.h"
+#include "ReadHolder.h"
+
+TEST_CASE("spilling reads that share a kmer with a known repeat", "[singletonspill]") {
+    std::string spill_file = "test_singletonspill.spill";
+    SingletonSpill spill(spill_file);
+    std::string repeat = "GTTTCAATCCACGCGCCCACGCGGGGCGCGAC";
+
+    spill.startFile();
+    spill.nextRead();
+    ReadHolder unrelated("ACGATCGATTTAGCGGCATCAGCTACGACTAGCATCAGCAGCGACTACGATCGA", "read_1");
+    REQUIRE_FALSE(spill.spillIfShared(unrelated));
+
+    // the second read is where the repeat was found
+    spill.nextRead();
+    spill.addRepeat(repeat);
+    REQUIRE(spill.lastFileToRescan() == 0);
+    REQUIRE(spill.readsToRescan() == 2);
+    REQUIRE(spill.spilledReadsToSkip() == 0);
+
+    SECTION("a read containing part of the repeat is kept") {
+        spill.nextRead();
+        ReadHolder partial("TTGACCAGTAGCATCGACTAGCATCGACGTTTCAATCCACG", "read_3");
+        REQUIRE(spill.spillIfShared(partial));
+        REQUIRE(spill.numSpilled() == 1);
+    }
+    SECTION("a read containing the reverse complement is kept") {
+        spill.nextRead();
+        ReadHolder reversed("ACGATCGATCGATCGAGTCGCGCCCCGCGTGGGCG", "read_3");
+        REQUIRE(spill.spillIfShared(reversed));
+    }
+    SECTION("a read that does not share a kmer is not kept") {
+        spill.nextRead();
+        REQUIRE_FALSE(spill.spillIfShared(unrelated));
+        REQUIRE(spill.numSpilled() == 0);
+    }
+    SECTION("finding the same repeat again does not move the rescan point") {
+        spill.nextRead();
+        ReadHolder partial("TTGACCAGTAGCATCGACTAGCATCGACGTTTCAATCCACG", "read_3");
+        spill.spillIfShared(partial);
+        spill.nextRead();
+        spill.addRepeat(repeat);
+        REQUIRE(spill.readsToRescan() == 2);
+        REQUIRE(spill.spilledReadsToSkip() == 0);
+    }
+    SECTION("a new repeat in a later file moves the rescan point") {
+        spill.nextRead();
+        ReadHolder partial("TTGACCAGTAGCATCGACTAGCATCGACGTTTCAATCCACG", "read_3");
+        spill.spillIfShared(partial);
+        spill.startFile();
+        spill.nextRead();
+        spill.addRepeat("CTTTTAATCGCACCTATTTGGAATTGAAAC");
+        REQUIRE(spill.lastFileToRescan() == 1);
+        REQUIRE(spill.readsToRescan() == 1);
+        REQUIRE(spill.spilledReadsToSkip() == 1);
+    }
+}
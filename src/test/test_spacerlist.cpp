@@ -0,0 +1,48 @@
+#include <vector>
+
+#include "catch.hpp"
+#include "SpacerList.h"
+
+TEST_CASE("spacer keys do not depend on which end comes first", "[spacerlist]") {
+    REQUIRE(makeSpacerKey(3, 70000) == makeSpacerKey(70000, 3));
+    // these collided when the key was squeezed into 32 bits
+    REQUIRE(makeSpacerKey(431, 1000) != makeSpacerKey(1, 5033704));
+    REQUIRE(makeSpacerKey(1, 2) < makeSpacerKey(1, 3));
+    REQUIRE(makeSpacerKey(1, 100000) < makeSpacerKey(2, 3));
+}
+
+TEST_CASE("spacers are found by key and walked in key order", "[spacerlist]") {
+    SpacerList spacers;
+    REQUIRE(spacers.size() == 0);
+    REQUIRE(spacers.find(makeSpacerKey(2, 3)) == NULL);
+
+    std::vector<SpacerInstance *> made;
+    for (StringToken i = 1000; i > 0; i--) {
+        SpacerInstance * spacer = new SpacerInstance(i);
+        made.push_back(spacer);
+        spacers.insert(makeSpacerKey(i, i * 1000 + 7), spacer);
+    }
+    REQUIRE(spacers.size() == 1000);
+    REQUIRE(spacers.find(makeSpacerKey(17, 17007)) == made[1000 - 17]);
+    REQUIRE(spacers.find(makeSpacerKey(17007, 17)) == made[1000 - 17]);
+    REQUIRE(spacers.find(makeSpacerKey(17, 17008)) == NULL);
+
+    SpacerKey last_key = 0;
+    StringToken expected = 1;
+    for (SpacerList::iterator sp_iter = spacers.begin(); sp_iter != spacers.end(); ++sp_iter) {
+        REQUIRE(sp_iter->first > last_key);
+        REQUIRE((sp_iter->second)->getID() == expected);
+        last_key = sp_iter->first;
+        expected++;
+    }
+
+    // still found after being sorted
+    REQUIRE(spacers.find(makeSpacerKey(999, 999007)) == made[1]);
+
+    spacers.clear();
+    REQUIRE(spacers.size() == 0);
+    REQUIRE(spacers.find(makeSpacerKey(17, 17007)) == NULL);
+    for (size_t i = 0; i < made.size(); i++) {
+        delete made[i];
+    }
+}
@@ -0,0 +1,107 @@
+#include <string>
+#include <sstream>
+#include <map>
+#include <cstdio>
+#include <sys/time.h>
+
+#include "catch.hpp"
+#include "test_utils.h"
+#include "StringCheck.h"
+#include "Exception.h"
+
+static std::string readHeader(long i) {
+    char header[64];
+    sprintf(header, "HWI-ST1234:8:%ld:%ld:%ld#0/1", 1101 + i % 64, (i * 7919) % 20000, i);
+    return header;
+}
+
+TEST_CASE("strings and tokens go both ways", "[stringcheck]") {
+    StringCheck check;
+    REQUIRE(check.getToken("ACGT") == 0);
+
+    StringToken first = check.addString("ACGT");
+    StringToken second = check.addString("GGCCAA");
+    REQUIRE(first == check.firstToken());
+    REQUIRE(second == first + 1);
+    REQUIRE(check.mNextFreeToken == second);
+    REQUIRE(check.getToken("ACGT") == first);
+    REQUIRE(check.getToken("GGCCAA") == second);
+    REQUIRE(std::string(check.getString(first)) == "ACGT");
+    REQUIRE(check.getString(second).length() == 6);
+    REQUIRE(check.getToken("ACG") == 0);
+    REQUIRE_THROWS_AS(check.getString(0), crispr::exception&);
+    REQUIRE_THROWS_AS(check.getString(second + 1), crispr::exception&);
+
+    SECTION("adding a string again gives it a new token") {
+        StringToken again = check.addString("ACGT");
+        REQUIRE(again == second + 1);
+        REQUIRE(check.getToken("ACGT") == again);
+        REQUIRE(std::string(check.getString(first)) == "ACGT");
+        REQUIRE(check.getString(again).data() == check.getString(first).data());
+    }
+    SECTION("views stay put while the table grows") {
+        const char * acgt = check.getString(first).data();
+        for (long i = 0; i < 100000; i++) {
+            check.addString(readHeader(i));
+        }
+        REQUIRE(check.getString(first).data() == acgt);
+        for (long i = 0; i < 100000; i += 997) {
+            StringToken token = check.getToken(readHeader(i));
+            REQUIRE(token == second + 1 + i);
+            REQUIRE(std::string(check.getString(token)) == readHeader(i));
+        }
+        std::stringstream ss;
+        ss << check.getString(second);
+        REQUIRE(ss.str() == "GGCCAA");
+    }
+    SECTION("empty strings are fine") {
+        StringToken empty = check.addString("");
+        REQUIRE(check.getToken("") == empty);
+        REQUIRE(check.getString(empty).length() == 0);
+    }
+    SECTION("clearing starts the tokens again") {
+        check.clear();
+        REQUIRE(check.getToken("ACGT") == 0);
+        REQUIRE(check.addString("TTTT") == check.firstToken());
+    }
+}
+
+// run with: crass-test "[benchmark]"
+TEST_CASE("interning 10M read headers", "[.][benchmark]") {
+    const long num_headers = 10000000;
+    StringCheck check;
+    struct timeval before;
+    gettimeofday(&before, NULL);
+    for (long i = 0; i < num_headers; i++) {
+        check.addString(readHeader(i));
+    }
+    double add_secs = secondsSince(before);
+    gettimeofday(&before, NULL);
+    long found = 0;
+    for (long i = 0; i < num_headers; i++) {
+        found += check.getToken(readHeader(i)) != 0;
+    }
+    double get_secs = secondsSince(before);
+    REQUIRE(found == num_headers);
+    std::cout<<std::endl<<num_headers<<" headers: StringCheck add "<<add_secs<<" sec, lookup "<<get_secs<<" sec"<<std::endl;
+    check.clear();
+
+    // what StringCheck used to be
+    std::map<StringToken, std::string> t2s;
+    std::map<std::string, StringToken> s2t;
+    gettimeofday(&before, NULL);
+    for (long i = 0; i < num_headers; i++) {
+        std::string header = readHeader(i);
+        t2s[static_cast<StringToken>(i + 2)] = header;
+        s2t[header] = static_cast<StringToken>(i + 2);
+    }
+    add_secs = secondsSince(before);
+    gettimeofday(&before, NULL);
+    found = 0;
+    for (long i = 0; i < num_headers; i++) {
+        found += s2t.find(readHeader(i)) != s2t.end();
+    }
+    get_secs = secondsSince(before);
+    REQUIRE(found == num_headers);
+    std::cout<<num_headers<<" headers: two std::maps add "<<add_secs<<" sec, lookup "<<get_secs<<" sec"<<std::endl;
+}
@@ -0,0 +1,27 @@
+// helpers shared by the tests and the [benchmark] cases
+
+#ifndef test_utils_h
+#define test_utils_h
+
+#include <string>
+#include <cstdlib>
+#include <sys/time.h>
+
+// a random sequence drawn from rand(), so a test that calls srand first
+// gets the same one every time
+inline std::string randomSeq(int length, const char * bases = "ACGT", int numBases = 4) {
+    std::string seq(length, 'A');
+    for (int i = 0; i < length; i++) {
+        seq[i] = bases[rand() % numBases];
+    }
+    return seq;
+}
+
+// wall time since before was taken with gettimeofday
+inline double secondsSince(const struct timeval& before) {
+    struct timeval after;
+    gettimeofday(&after, NULL);
+    return (after.tv_sec - before.tv_sec) + (after.tv_usec - before.tv_usec) / 1e6;
+}
+
+#endif //test_utils_h